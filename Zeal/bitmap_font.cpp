@@ -10,10 +10,13 @@
 //   - https://github.com/microsoft/DirectXTK/wiki/MakeSpriteFont
 //   - Click on Downloads@Latest
 //   - Run ./MakeSpriteFont "Arial" /FontSize:10 /TextureFormat:CompressedMono arial_10.spritefont
+//   - Add /CharacterRegion:0x20-0x7e /CharacterRegion:0xa0-0xff (or other ranges) for non-ASCII glyphs.
+//     Text is decoded as UTF-8 when valid and otherwise as Windows-1252.
 
 #define NOMINMAX
 #include "bitmap_font.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 
@@ -33,6 +36,14 @@ static constexpr int kNumGlyphVertices = 4;   // Four per glyph using D3DPT_TRIA
 static constexpr int kNumGlyphIndices = 6;    // Three per triangle in D3DPT_TRIANGLELIST.
 static constexpr int kNumGlyphTriangles = 2;  // Two triangles per glpyh to specify the rectangle.
 
+// Layout cache key flags (the layout also depends on the font, which owns the cache).
+static constexpr uint32_t kLayoutCentered = 1;
+static constexpr uint32_t kLayoutAlignBottom = 2;
+
+// ASCII stand-ins for the Latin-1 letters U+00C0 - U+00FF when a font lacks them (drops the accents).
+static constexpr char kLatin1BaseLetters[] = "AAAAAAACEEEEIIIIDNOOOOOxOUUUUYPsaaaaaaaceeeeiiiidnooooo/ouuuuypy";
+static_assert(sizeof(kLatin1BaseLetters) == 0x40 + 1);
+
 // Hard-coded starting sequence of a MakeSpriteFont file.
 static constexpr char kSpriteFontMagic[] = "DXTKfont";
 
@@ -162,11 +173,15 @@ BitmapFontBase::BitmapFontBase(IDirect3DDevice8 &device, std::span<const uint8_t
 
   // Read the glyph data.
   auto num_glyphs = reader.read<uint32_t>();
-  for (auto i = 0; i < num_glyphs; ++i) {
+  for (auto i = 0; i < num_glyphs && !reader.is_error(); ++i) {
     auto glyph_data = reader.read<Glyph>();
-    if (glyph_data.character >= kNumGlyphs) continue;  // Just skip non-ascii.
-    glyph_table[glyph_data.character] = glyph_data;
+    if (glyph_data.character < kNumGlyphs)
+      glyph_table[glyph_data.character] = glyph_data;
+    else
+      extended_glyphs.push_back(glyph_data);
   }
+  std::sort(extended_glyphs.begin(), extended_glyphs.end(),
+            [](const Glyph &a, const Glyph &b) { return a.character < b.character; });
 
   line_spacing = reader.read<float>();
   line_spacing = static_cast<float>(static_cast<int>(line_spacing + 0.5f));  // ceil().
@@ -207,20 +222,20 @@ BitmapFontBase::BitmapFontBase(IDirect3DDevice8 &device, std::span<const uint8_t
   }
   D3DFORMAT d3dformat = D3DFMT_DXT2;  // Equivalent to BC2_UNORM.
 
-  // Create the D3D texture.
+  // Add the bitmap to the shared font texture.
   RECT texture_rect =
-      create_texture(texture_width, texture_height, d3dformat, texture_stride, texture_rows, texture_data);
+      add_to_atlas(texture_width, texture_height, d3dformat, texture_stride, texture_rows, texture_data);
 
-  if (!texture) {
-    Zeal::Game::print_chat("Failed to create the font bitmap texture");
+  if (!is_valid()) {
+    Zeal::Game::print_chat("Failed to add the font bitmap to the texture atlas");
     return;
   }
 
   // We customize four special glyph indices to support the stats bars. The background glyph's
   // advance is set to measure "zero" width so the value bar starts at the same location while
   // the value glyphs' advance is set to the full width size for the centering calcs.
-  // The create_texture has created a solid 4x4 block at the end for the stats bars to use.
-  RECT sub_rect = {texture_rect.right - 3, texture_rect.bottom - 2, texture_rect.right - 1, texture_rect.bottom - 1};
+  // The atlas appends a solid 4x4 block below the bitmap for the stats bars to use.
+  RECT sub_rect = {1, texture_rect.bottom + 2, 3, texture_rect.bottom + 3};
   glyph_table[kStatsBarBackground] = {.character = kStatsBarBackground,
                                       .sub_rect = sub_rect,
                                       .x_offset = 0,
@@ -242,41 +257,45 @@ BitmapFontBase::~BitmapFontBase() { release(); }
 void BitmapFontBase::dump() const {
   Zeal::Game::print_chat("drop_shadow: %d, offset_factor: %.3f, outlined: %d, align_bottom: %d", drop_shadow,
                          shadow_offset_factor, outlined, align_bottom);
-  Zeal::Game::print_chat("line_spacing: %f, default_character: %c", line_spacing, default_character);
-
-  if (texture) {
-    Zeal::Game::print_chat("Texture:");
-    D3DSURFACE_DESC desc;
-    if (FAILED(texture->GetLevelDesc(0, &desc)))
-      Zeal::Game::print_chat("Invalid");
-    else {
-      Zeal::Game::print_chat("Format: %d, Type: %d, Usage: %d", desc.Format, desc.Type, desc.Usage);
-      Zeal::Game::print_chat("Width: %d, Height: %d, MultiSampleType: %d", desc.Width, desc.Height,
-                             desc.MultiSampleType);
-    }
+  Zeal::Game::print_chat("line_spacing: %f, default_character: %c, extended glyphs: %d", line_spacing,
+                         default_character, extended_glyphs.size());
+  const uint32_t lookups = layout_cache_stats.hits + layout_cache_stats.misses;
+  Zeal::Game::print_chat("Layout cache: %d strings, hits: %u, misses: %u (%.1f%% hit rate), evictions: %u",
+                         layout_cache.size(), layout_cache_stats.hits, layout_cache_stats.misses,
+                         lookups ? 100.f * layout_cache_stats.hits / lookups : 0.f, layout_cache_stats.evictions);
+
+  if (is_valid()) {
+    FontAtlas::Point origin = atlas->get_origin(atlas_sheet);
+    FontAtlas::Size size = atlas->get_size();
+    Zeal::Game::print_chat("Texture atlas: %d fonts, Width: %d, Height: %d, Sheet origin: %d, %d",
+                           atlas->get_sheet_count(), size.width, size.height, origin.x, origin.y);
   }
 }
 
 // DirectX resources need to be manually released.
 void BitmapFontBase::release() {
-  if (texture) texture->Release();
+  if (atlas) atlas->remove_sheet(atlas_sheet);
+  atlas.reset();
+  atlas_sheet = -1;
   texture = nullptr;
   if (vertex_buffer) vertex_buffer->Release();
   vertex_buffer = nullptr;
   if (index_buffer) index_buffer->Release();
   index_buffer = nullptr;
   glyph_queue.clear();
+  glyph_runs.clear();
+  clear_layout_cache();
 }
 
 // DirectX resources need to be manually released.
 void BitmapFont::release() {
   BitmapFontBase::release();
-  vertices.reset();
+  vertices = {};
 }
 
-// Creates the D3D texture (acquires and configures resources).
-RECT BitmapFontBase::create_texture(uint32_t width, uint32_t height, D3DFORMAT format, uint32_t stride, uint32_t rows,
-                                    const uint8_t *data) {
+// Adds the bitmap to the shared texture atlas. Returns the bitmap's rect within its atlas sheet.
+RECT BitmapFontBase::add_to_atlas(uint32_t width, uint32_t height, D3DFORMAT format, uint32_t stride, uint32_t rows,
+                                  const uint8_t *data) {
   // Zeal::Game::print_chat("Font Texture: w: %i, h: %i, format: 0x%08x, stride: %i, rows: %i",
   //     width, height, format, stride, rows);
 
@@ -284,59 +303,31 @@ RECT BitmapFontBase::create_texture(uint32_t width, uint32_t height, D3DFORMAT f
   if (size_bytes > 256 * 1024ull)  // Just a sanity check.
     return RECT(0, 0, 0, 0);
 
-  // Texture copy below assumes 4x4 packed DXT2 format.
+  // Atlas copies assume 4x4 packed DXT2 format.
   if (format != D3DFMT_DXT2 || (rows * 4 != height)) {
     Zeal::Game::print_chat("Font: Unsupported texture: fmt: 0x%08x, rows: %i, height: %i", format, rows, height);
     return RECT(0, 0, 0, 0);
   }
 
-  uint32_t mip_levels = 1;
-  const DWORD usage = 0;                       // Not a render target or dynamic.
-  uint32_t width_pow2 = std::bit_ceil(width);  // Use powers of two for HW portability.
-  uint32_t height_pow2 = std::bit_ceil(height);
-
-  auto hresult =
-      D3DXCreateTexture(&device, width_pow2, height_pow2, mip_levels, usage, format, D3DPOOL_MANAGED, &texture);
-  if (FAILED(hresult)) {
-    Zeal::Game::print_chat("Font texture failure: w: %i, h: %i, code: 0x%08x", width_pow2, height_pow2, hresult);
-    texture = nullptr;  // Ensure it is nulled.
+  atlas = FontAtlas::get_shared(device);
+  atlas_sheet = atlas->add_sheet(width, height, stride, rows, data);
+  if (atlas_sheet < 0) {
+    atlas.reset();
     return RECT(0, 0, 0, 0);
   }
-
-  // Cache away conversion factors for use in vertex texture coordinates.
-  Vec2 texture_size = Vec2(static_cast<float>(width_pow2), static_cast<float>(height_pow2));
-  inverse_texture_size = Vec2(1.f / texture_size.x, 1.f / texture_size.y);
-
-  D3DLOCKED_RECT locked_rect;
-  if (FAILED(texture->LockRect(0, &locked_rect, NULL, D3DLOCK_DISCARD)) || locked_rect.Pitch < stride) {
-    Zeal::Game::print_chat("Font texture: Lock failed");
-    texture->Release();
-    texture = nullptr;
-    return RECT(0, 0, 0, 0);
-  }
-
-  // Note: This uses rows, not height, and stride to copy over the data assuming this
-  // is properly packed DXT2 data. We checked above that 4 * rows = height and stride <= pitch.
-  uint8_t *texture_data = reinterpret_cast<uint8_t *>(locked_rect.pBits);
-  for (int y = 0; y < rows; ++y) memcpy(&texture_data[y * locked_rect.Pitch], &data[y * stride], stride);
-
-  // To support the health bar, we make a solid block at the very end of the texture. This
-  // is going to be unused in all likely scenarios due to the power of two ceiling above.
-  int last_row = height_pow2 / 4 - 1;  // Rows = height / 4 since 4x4 block compression.
-  int last_block = 4 * width_pow2 - 16;
-  if (last_block + 16 <= locked_rect.Pitch)
-    memset(&texture_data[last_row * locked_rect.Pitch + last_block], 0xff, 16);
-  else
-    Zeal::Game::print_chat("Error: Unable to set health bar texture (%i vs %i)", locked_rect.Pitch, last_block);
-
-  texture->UnlockRect(0);
-  return RECT(0, 0, width_pow2, height_pow2);
+  return RECT(0, 0, width, height);
 }
 
-// Returns the glyph details for the character (or default if out of range).
-const BitmapFontBase::Glyph *BitmapFontBase::get_glyph(char character) const {
-  if (character >= kNumGlyphs) character = default_character;
-  return &glyph_table[character];
+// Returns the glyph details for the character (code point). Latin-1 letters missing from the font
+// fall back to their unaccented ASCII letter and anything else to the default character.
+const BitmapFontBase::Glyph *BitmapFontBase::get_glyph(uint32_t character) const {
+  if (character < kNumGlyphs) return &glyph_table[character];
+
+  auto it = std::lower_bound(extended_glyphs.begin(), extended_glyphs.end(), character,
+                             [](const Glyph &glyph, uint32_t value) { return glyph.character < value; });
+  if (it != extended_glyphs.end() && it->character == character) return &*it;
+  if (character >= 0xc0 && character <= 0xff) return &glyph_table[kLatin1BaseLetters[character - 0xc0]];
+  return &glyph_table[default_character];
 }
 
 // The core glyph layout algorithm shared by the string functions.
@@ -346,8 +337,15 @@ void BitmapFontBase::for_each_glyph(const char *text, TAction action) const {
   float y = 0;
 
   int length_limit = 100;  // Limit text strings to 100 characters.
-  for (; *text && length_limit--; text++) {
-    const char character = *text;
+  while (*text && length_limit--) {
+    const uint8_t character = static_cast<uint8_t>(*text);
+    const Glyph *glyph;
+    if (character < kNumGlyphs) {
+      glyph = &glyph_table[character];  // ASCII fast path (missing entries hold the default glyph).
+      text++;
+    } else {
+      glyph = get_glyph(Zeal::String::decode_codepoint(text));  // Advances text past the sequence.
+    }
 
     switch (character) {
       case '\r':
@@ -359,7 +357,6 @@ void BitmapFontBase::for_each_glyph(const char *text, TAction action) const {
         break;
 
       default:
-        auto glyph = get_glyph(character);
         x += glyph->x_offset;
         if (x < 0) x = 0;
         if (((glyph->sub_rect.right - glyph->sub_rect.left) > 1) ||
@@ -372,34 +369,20 @@ void BitmapFontBase::for_each_glyph(const char *text, TAction action) const {
   }
 }
 
-void BitmapFontBase::queue_lines(const std::vector<Lines> &lines, D3DCOLOR color, Vec2 offset) {
-  for (const auto &line : lines) {
-    Vec2 upper_left = line.upper_left + offset;
-    for_each_glyph(line.text.c_str(), [&](const Glyph *glyph, float x, float y) {
-      if ((glyph->character == kStatsBarBackground || glyph->character == kHealthBarValue ||
-           glyph->character == kManaBarValue || glyph->character == kStaminaBarValue) &&
-          color == kDropShadowColor)
-        return;  // Skip drop shadow for the health bar.
-      glyph_queue.push_back({glyph, upper_left + Vec2(x, y), color, hp_percent});
-    });
-  }
-}
-
 void BitmapFontBase::queue_background_rect(const RECT &rect, D3DCOLOR color) {
   background_rect = rect;  // THe width and height aren't queued so have to cache them.
 
   auto glyph = get_glyph(kBackgroundRect);
+  const int start_index = glyph_queue.size();
   glyph_queue.push_back(
       {glyph, Vec2(static_cast<float>(background_rect.left), static_cast<float>(background_rect.top)), color, 0});
+  glyph_runs.push_back({.start_index = start_index, .stop_index = start_index + 1});
 }
 
-// Public interface that queues a string for later rendering in the flush call.
-void BitmapFontBase::queue_string(const char *text, const Vec3 &position, bool center, const D3DCOLOR color,
-                                  bool grid_align) {
-  if (!text || !(*text)) return;  // Skip nullptr or empty strings.
-
+// Splits the text into lines positioned relative to the queued position.
+std::vector<BitmapFontBase::Lines> BitmapFontBase::split_lines(const char *text, bool center) const {
   std::vector<Lines> lines;
-  Vec2 upper_left(position.x, position.y);
+  Vec2 upper_left(0, 0);
   if (center && strchr(text, '\n') != nullptr) {
     // Split into the multiple lines and measure the width of each line.
     auto text_lines = Zeal::String::split_text(std::string(text));
@@ -419,7 +402,7 @@ void BitmapFontBase::queue_string(const char *text, const Vec3 &position, bool c
     for (auto &line : lines) {
       float x_line_offset = x_offset + 0.5f * (x_max - line.upper_left.x);
       float y_line_offset = line.upper_left.y + y_offset;
-      line.upper_left = upper_left + Vec2(x_line_offset, y_line_offset);
+      line.upper_left = Vec2(x_line_offset, y_line_offset);
     }
   } else {
     if (center) {
@@ -428,21 +411,126 @@ void BitmapFontBase::queue_string(const char *text, const Vec3 &position, bool c
     }
     lines.push_back({std::string(text), upper_left});
   }
-  if (grid_align) {
-    for (auto &line : lines) {
-      line.upper_left.x = std::round(line.upper_left.x);  // Starts need to be grid aligned for clean rendering.
-      line.upper_left.y = std::round(line.upper_left.y);
+  return lines;
+}
+
+// Returns the cached layout of the text, laying it out on a miss.
+const BitmapFontBase::StringLayout &BitmapFontBase::get_layout(const char *text, bool center) {
+  const uint32_t flags = center ? (kLayoutCentered | (align_bottom ? kLayoutAlignBottom : 0)) : 0;
+  uint64_t key = 0xcbf29ce484222325ull ^ flags;  // FNV-1a.
+  size_t length = 0;
+  for (; text[length]; ++length) key = (key ^ static_cast<uint8_t>(text[length])) * 0x100000001b3ull;
+  const std::string_view text_view(text, length);
+
+  auto it = layout_index.find(key);
+  if (it != layout_index.end() && it->second->flags == flags && it->second->text == text_view) {
+    layout_cache_stats.hits++;
+    layout_cache.splice(layout_cache.begin(), layout_cache, it->second);
+    return layout_cache.front();
+  }
+
+  // Reuse the colliding or least recently used entry (and its allocations) when possible.
+  layout_cache_stats.misses++;
+  if (it != layout_index.end()) {
+    layout_cache.splice(layout_cache.begin(), layout_cache, it->second);
+  } else {
+    if (layout_cache.size() >= kLayoutCacheSize) {
+      layout_cache_stats.evictions++;
+      layout_index.erase(layout_cache.back().key);
+      layout_cache.splice(layout_cache.begin(), layout_cache, std::prev(layout_cache.end()));
+    } else {
+      layout_cache.emplace_front();
+    }
+    layout_index[key] = layout_cache.begin();
+  }
+
+  StringLayout &layout = layout_cache.front();
+  layout.key = key;
+  layout.flags = flags;
+  layout.text = text_view;
+  layout.line_origins.clear();
+  layout.glyphs.clear();
+  for (const auto &line : split_lines(text, center)) {
+    const int line_index = static_cast<int>(layout.line_origins.size());
+    layout.line_origins.push_back(line.upper_left);
+    for_each_glyph(line.text.c_str(), [&](const Glyph *glyph, float x, float y) {
+      layout.glyphs.push_back({glyph, Vec2(x, y), line_index});
+    });
+  }
+  return layout;
+}
+
+void BitmapFontBase::clear_layout_cache() {
+  layout_cache.clear();
+  layout_index.clear();
+}
+
+// Public interface that queues a string for later rendering in the flush call.
+void BitmapFontBase::queue_string(const char *text, const Vec3 &position, bool center, const D3DCOLOR color,
+                                  bool grid_align) {
+  if (!text || !(*text)) return;  // Skip nullptr or empty strings.
+
+  const StringLayout &layout = get_layout(text, center);
+  queued_line_origins.clear();
+  for (const Vec2 &line_origin : layout.line_origins) {
+    Vec2 upper_left = Vec2(position.x, position.y) + line_origin;
+    if (grid_align) {
+      upper_left.x = std::round(upper_left.x);  // Starts need to be grid aligned for clean rendering.
+      upper_left.y = std::round(upper_left.y);
     }
+    queued_line_origins.push_back(upper_left);
   }
+  GlyphRun run = {.start_index = static_cast<int>(glyph_queue.size())};
   if (drop_shadow || outlined) {
     float shadow_offset = calculate_shadow_offset();
-    queue_lines(lines, kDropShadowColor, Vec2(shadow_offset, shadow_offset));
+    run.shadow_offsets[run.num_shadows++] = Vec2(shadow_offset, shadow_offset);
     if (outlined) {
       // Technically would be cleaner with left, right, top, bottom adjusts (4 passes).
-      queue_lines(lines, kDropShadowColor, Vec2(-shadow_offset, -shadow_offset));
+      run.shadow_offsets[run.num_shadows++] = Vec2(-shadow_offset, -shadow_offset);
+    }
+  }
+  for (const auto &entry : layout.glyphs)
+    glyph_queue.push_back({entry.glyph, queued_line_origins[entry.line] + entry.offset, color, hp_percent});
+  run.stop_index = static_cast<int>(glyph_queue.size());
+  glyph_runs.push_back(run);
+}
+
+// Appends the vertices of the runs in draw order. Each glyph's vertices are calculated once for the
+// main pass and the shadow passes are offset copies that to_shadow recolors.
+template <typename TVertex, typename TCalculate, typename TToShadow>
+void BitmapFontBase::append_run_vertices(std::span<const GlyphRun> runs, std::vector<TVertex> &out,
+                                         TCalculate calculate, TToShadow to_shadow) const {
+  auto casts_shadow = [](const Glyph *glyph) {
+    return glyph->character != kStatsBarBackground && glyph->character != kHealthBarValue &&
+           glyph->character != kManaBarValue && glyph->character != kStaminaBarValue;
+  };
+
+  for (const auto &run : runs) {
+    int shadow_glyphs = 0;  // Per shadow pass.
+    if (run.num_shadows)
+      for (int i = run.start_index; i < run.stop_index; ++i) shadow_glyphs += casts_shadow(glyph_queue[i].glyph);
+
+    const size_t shadow_start = out.size();
+    const size_t main_start = shadow_start + run.num_shadows * shadow_glyphs * kNumGlyphVertices;
+    out.resize(main_start + (run.stop_index - run.start_index) * kNumGlyphVertices);
+    for (int i = run.start_index; i < run.stop_index; ++i)
+      calculate(glyph_queue[i], &out[main_start + (i - run.start_index) * kNumGlyphVertices]);
+
+    TVertex *shadow = &out[shadow_start];
+    for (int pass = 0; pass < run.num_shadows; ++pass) {
+      const Vec2 &offset = run.shadow_offsets[pass];
+      for (int i = run.start_index; i < run.stop_index; ++i) {
+        if (!casts_shadow(glyph_queue[i].glyph)) continue;
+        const TVertex *source = &out[main_start + (i - run.start_index) * kNumGlyphVertices];
+        for (int k = 0; k < kNumGlyphVertices; ++k, ++shadow) {
+          *shadow = source[k];
+          shadow->x += offset.x;
+          shadow->y += offset.y;
+          to_shadow(*shadow);
+        }
+      }
     }
   }
-  queue_lines(lines, color);
 }
 
 // Returns the height and width of the string. Does not include line spacing, which is returned as z.
@@ -514,7 +602,17 @@ float BitmapFontBase::get_text_height(const std::string &text) const {
 
 // Renders all queued bitmap glyphs to the screen.
 void BitmapFontBase::flush_queue_to_screen() {
-  if (!texture) glyph_queue.clear();
+  // Loading another font repacks the atlas, so the sheet mapping is refreshed every flush.
+  texture = is_valid() ? atlas->get_texture() : nullptr;
+  if (texture) {
+    FontAtlas::Point origin = atlas->get_origin(atlas_sheet);
+    FontAtlas::Size size = atlas->get_size();
+    texture_origin = Vec2(static_cast<float>(origin.x), static_cast<float>(origin.y));
+    inverse_texture_size = Vec2(1.f / size.width, 1.f / size.height);
+  } else {
+    glyph_queue.clear();
+    glyph_runs.clear();
+  }
 
   if (glyph_queue.empty()) return;
 
@@ -555,13 +653,21 @@ void BitmapFontBase::flush_queue_to_screen() {
 
   render_queue();
   glyph_queue.clear();
+  glyph_runs.clear();
 
   if (modify_viewport) device.SetViewport(&original_viewport);
 }
 
 // Submits glyph sprites to the GPU in batches.
 void BitmapFont::render_queue() {
-  if (!vertices) vertices = std::make_unique<GlyphVertex[]>(kVertexBufferMaxBatchCount * kNumGlyphVertices);
+  vertices.clear();
+  append_run_vertices(
+      glyph_runs, vertices,
+      [this](const GlyphQueueEntry &entry, GlyphVertex *glyph_vertices) {
+        calculate_glyph_vertices(entry, glyph_vertices);
+      },
+      [](GlyphVertex &vertex) { vertex.color = kDropShadowColor; });
+  const int glyph_count = vertices.size() / kNumGlyphVertices;
 
   // Configure for 2D drawing with alpha blending enabled.
   D3DRenderStateStash render_state(device);
@@ -588,8 +694,8 @@ void BitmapFont::render_queue() {
   device.SetStreamSource(0, vertex_buffer, sizeof(GlyphVertex));
 
   int read_index = 0;
-  while (read_index < glyph_queue.size()) {
-    const int glyphs_left_count = glyph_queue.size() - read_index;
+  while (read_index < glyph_count) {
+    const int glyphs_left_count = glyph_count - read_index;
     int empty_space_count = kVertexBufferMaxBatchCount - vertex_buffer_wr_index;
 
     if ((glyphs_left_count > empty_space_count) && (empty_space_count < kVertexBufferMinBatchCount)) {
@@ -599,9 +705,6 @@ void BitmapFont::render_queue() {
     const int batch_count = std::min(glyphs_left_count, empty_space_count);
     if (batch_count < 1) break;  // Shouldn't happen, but if it does, just abort processing glyphs.
 
-    for (int i = 0; i < batch_count; i++)
-      calculate_glyph_vertices(glyph_queue[read_index + i], &vertices[i * kNumGlyphVertices]);
-
     auto lock_type = (vertex_buffer_wr_index == 0) ? D3DLOCK_DISCARD : D3DLOCK_NOOVERWRITE;
     const int start_vertex_index = vertex_buffer_wr_index * kNumGlyphVertices;
     const int num_batch_vertices = batch_count * kNumGlyphVertices;
@@ -612,7 +715,7 @@ void BitmapFont::render_queue() {
       release();
       return;
     }
-    memcpy(buffer, vertices.get(), copy_size);
+    memcpy(buffer, &vertices[read_index * kNumGlyphVertices], copy_size);
     vertex_buffer->Unlock();
 
     device.SetIndices(index_buffer, 0);
@@ -695,8 +798,8 @@ void BitmapFont::calculate_glyph_vertices(const GlyphQueueEntry &entry, GlyphVer
   glyph_vertices[2].x = glyph_vertices[0].x;
   glyph_vertices[3].x = glyph_vertices[1].x;
 
-  glyph_vertices[0].u = entry.glyph->sub_rect.left * inverse_texture_size.x;
-  glyph_vertices[1].u = entry.glyph->sub_rect.right * inverse_texture_size.x;
+  glyph_vertices[0].u = (entry.glyph->sub_rect.left + texture_origin.x) * inverse_texture_size.x;
+  glyph_vertices[1].u = (entry.glyph->sub_rect.right + texture_origin.x) * inverse_texture_size.x;
   glyph_vertices[2].u = glyph_vertices[0].u;
   glyph_vertices[3].u = glyph_vertices[1].u;
 
@@ -705,9 +808,9 @@ void BitmapFont::calculate_glyph_vertices(const GlyphQueueEntry &entry, GlyphVer
   glyph_vertices[2].y = entry.position.y - 0.5f + height;
   glyph_vertices[3].y = glyph_vertices[2].y;
 
-  glyph_vertices[0].v = entry.glyph->sub_rect.top * inverse_texture_size.y;
+  glyph_vertices[0].v = (entry.glyph->sub_rect.top + texture_origin.y) * inverse_texture_size.y;
   glyph_vertices[1].v = glyph_vertices[0].v;
-  glyph_vertices[2].v = entry.glyph->sub_rect.bottom * inverse_texture_size.y;
+  glyph_vertices[2].v = (entry.glyph->sub_rect.bottom + texture_origin.y) * inverse_texture_size.y;
   glyph_vertices[3].v = glyph_vertices[2].v;
 
   for (int i = 0; i < kNumGlyphVertices; ++i) {
@@ -769,14 +872,12 @@ void SpriteFont::flush_queue_to_screen() {
 // DirectX resources need to be manually released.
 void SpriteFont::release() {
   BitmapFontBase::release();
-  vertices.reset();
+  vertices = {};
   glyph_string_queue.clear();
 }
 
 // Submits glyph sprites to the GPU in batches.
 void SpriteFont::render_queue() {
-  if (!vertices) vertices = std::make_unique<Glyph3DVertex[]>(kVertexBufferMaxBatchCount * kNumGlyphVertices);
-
   // Configure for 3D drawing with alpha blending enabled.
   D3DRenderStateStash render_state(device);
   render_state.store_and_modify({D3DRS_CULLMODE, D3DCULL_NONE});
@@ -815,6 +916,7 @@ void SpriteFont::render_queue() {
   for (int row = 0; row < 3; row++)  // Transpose rotation components of camera view matrix.
     for (int col = 0; col < 3; col++) rotationMatrix(col, row) = viewMatrix(row, col);
   D3DXMATRIX mat_font_to_face_camera = scaleMatrix * rotationMatrix;
+  size_t run_index = 0;
   for (const auto &entry : glyph_string_queue) {
     if (entry.stop_index > glyph_queue.size()) break;
 
@@ -826,9 +928,23 @@ void SpriteFont::render_queue() {
     mana_percent = entry.mana_percent;
     stamina_percent = entry.stamina_percent;
 
-    int read_index = entry.start_index;
-    while (read_index < entry.stop_index) {
-      const int glyphs_left_count = entry.stop_index - read_index;
+    // Shadow passes are drawn slightly behind the text.
+    const size_t first_run = run_index;
+    while (run_index < glyph_runs.size() && glyph_runs[run_index].start_index < entry.stop_index) ++run_index;
+    vertices.clear();
+    append_run_vertices(std::span(glyph_runs).subspan(first_run, run_index - first_run), vertices,
+                        [this](const GlyphQueueEntry &glyph_entry, Glyph3DVertex *glyph_vertices) {
+                          calculate_glyph_vertices(glyph_entry, glyph_vertices);
+                        },
+                        [](Glyph3DVertex &vertex) {
+                          vertex.color = kDropShadowColor;
+                          vertex.z = +1.f;
+                        });
+    const int glyph_count = vertices.size() / kNumGlyphVertices;
+
+    int read_index = 0;
+    while (read_index < glyph_count) {
+      const int glyphs_left_count = glyph_count - read_index;
       int empty_space_count = kVertexBufferMaxBatchCount - vertex_buffer_wr_index;
 
       if ((glyphs_left_count > empty_space_count) && (empty_space_count < kVertexBufferMinBatchCount)) {
@@ -838,9 +954,6 @@ void SpriteFont::render_queue() {
       const int batch_count = std::min(glyphs_left_count, empty_space_count);
       if (batch_count < 1) break;  // Shouldn't happen, but if it does, just abort processing glyphs.
 
-      for (int i = 0; i < batch_count; i++)
-        calculate_glyph_vertices(glyph_queue[read_index + i], &vertices[i * kNumGlyphVertices]);
-
       auto lock_type = (vertex_buffer_wr_index == 0) ? D3DLOCK_DISCARD : D3DLOCK_NOOVERWRITE;
       const int start_vertex_index = vertex_buffer_wr_index * kNumGlyphVertices;
       const int num_batch_vertices = batch_count * kNumGlyphVertices;
@@ -851,7 +964,7 @@ void SpriteFont::render_queue() {
         release();
         return;
       }
-      memcpy(buffer, vertices.get(), copy_size);
+      memcpy(buffer, &vertices[read_index * kNumGlyphVertices], copy_size);
       vertex_buffer->Unlock();
 
       device.SetIndices(index_buffer, 0);
@@ -911,8 +1024,8 @@ void SpriteFont::calculate_glyph_vertices(const GlyphQueueEntry &entry, Glyph3DV
   glyph_vertices[2].x = glyph_vertices[0].x;
   glyph_vertices[3].x = glyph_vertices[1].x;
 
-  glyph_vertices[0].u = entry.glyph->sub_rect.left * inverse_texture_size.x;
-  glyph_vertices[1].u = entry.glyph->sub_rect.right * inverse_texture_size.x;
+  glyph_vertices[0].u = (entry.glyph->sub_rect.left + texture_origin.x) * inverse_texture_size.x;
+  glyph_vertices[1].u = (entry.glyph->sub_rect.right + texture_origin.x) * inverse_texture_size.x;
   glyph_vertices[2].u = glyph_vertices[0].u;
   glyph_vertices[3].u = glyph_vertices[1].u;
 
@@ -921,9 +1034,9 @@ void SpriteFont::calculate_glyph_vertices(const GlyphQueueEntry &entry, Glyph3DV
   glyph_vertices[2].y = entry.position.y + height;
   glyph_vertices[3].y = glyph_vertices[2].y;
 
-  glyph_vertices[0].v = entry.glyph->sub_rect.top * inverse_texture_size.y;
+  glyph_vertices[0].v = (entry.glyph->sub_rect.top + texture_origin.y) * inverse_texture_size.y;
   glyph_vertices[1].v = glyph_vertices[0].v;
-  glyph_vertices[2].v = entry.glyph->sub_rect.bottom * inverse_texture_size.y;
+  glyph_vertices[2].v = (entry.glyph->sub_rect.bottom + texture_origin.y) * inverse_texture_size.y;
   glyph_vertices[3].v = glyph_vertices[2].v;
 
   for (int i = 0; i < kNumGlyphVertices; ++i) {
@@ -7,9 +7,12 @@
 
 #pragma once
 
+#include <list>
 #include <span>
+#include <unordered_map>
 
 #include "directx.h"
+#include "font_atlas.h"
 #include "vectors.h"
 
 // Directx 8 compatible classes for fast text rendering using batch processing of bitmap glyphs.
@@ -45,8 +48,8 @@ class BitmapFontBase {
   BitmapFontBase(BitmapFontBase const &) = delete;
   BitmapFontBase &operator=(BitmapFontBase const &) = delete;
 
-  // Returns true if a valid bitmap texture is ready for use by the GPU.
-  bool is_valid() const { return texture != nullptr; }
+  // Returns true if the glyph bitmap has been added to the shared font texture atlas.
+  bool is_valid() const { return atlas_sheet >= 0; }
 
   // Utilities for adjusting the string position (sizes in screen pixels).
   Vec3 measure_string(const char *text) const;
@@ -67,7 +70,10 @@ class BitmapFontBase {
 
   void set_full_screen_viewport(bool enable) { full_screen_viewport = enable; }
 
-  void set_stats_bar_height(float height) { stats_bar_height = height; }
+  void set_stats_bar_height(float height) {
+    if (height != stats_bar_height) clear_layout_cache();  // Stats bar glyphs are measured with it.
+    stats_bar_height = height;
+  }
 
   void set_stats_bar_width(float width) { stats_bar_width = width; }
 
@@ -96,6 +102,15 @@ class BitmapFontBase {
 
   virtual void dump() const;  // Print debug information like texture size.
 
+  // Counters of the queue_string() layout cache.
+  struct LayoutCacheStats {
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+    uint32_t evictions = 0;
+  };
+
+  const LayoutCacheStats &get_layout_cache_stats() const { return layout_cache_stats; }
+
  protected:
   // Strings are split into multiple lines.
   struct Lines {
@@ -112,6 +127,24 @@ class BitmapFontBase {
     float x_advance = 0;
   };
 
+  // Glyph positions of a queued string, cached so that strings queued every frame (nameplates,
+  // labels, floating text) skip the line splitting and measuring. The line origins are relative to
+  // the queued position and the glyph offsets to their line origin, so grid alignment and the
+  // shadow passes can still be applied per queue.
+  struct LayoutGlyph {
+    const Glyph *glyph;
+    Vec2 offset;
+    int line;
+  };
+
+  struct StringLayout {
+    uint64_t key = 0;  // Hash of the text and flags.
+    uint32_t flags = 0;
+    std::string text;
+    std::vector<Vec2> line_origins;
+    std::vector<LayoutGlyph> glyphs;
+  };
+
   // Strings are stored in the queue as character glyphs.
   struct GlyphQueueEntry {
     const Glyph *glyph;
@@ -120,14 +153,28 @@ class BitmapFontBase {
     char hp_percent;
   };
 
-  static constexpr int kNumGlyphs = 128;  // Support ASCII 0 - 127.
+  // The glyphs of a queued string are queued once and the renderers draw each run's shadow passes
+  // (offset copies of the vertices, skipping the stats bars) before its main pass.
+  static constexpr int kMaxShadowPasses = 2;  // Drop shadow and outline.
+
+  struct GlyphRun {
+    int start_index;
+    int stop_index;  // Exclusive.
+    int num_shadows = 0;
+    Vec2 shadow_offsets[kMaxShadowPasses];
+  };
+
+  static constexpr int kNumGlyphs = 128;  // Dense table for ASCII 0 - 127.
   static constexpr float kStatsBarHeight = 6;
   static constexpr float kStatsBarWidth = 120;
-
-  void queue_lines(const std::vector<Lines> &lines, D3DCOLOR color, Vec2 offset = Vec2(0, 0));
-  const Glyph *get_glyph(char character) const;
-  RECT create_texture(uint32_t width, uint32_t height, D3DFORMAT format, uint32_t stride, uint32_t rows,
-                      const uint8_t *data);
+  static constexpr size_t kLayoutCacheSize = 256;  // Strings, evicted least recently used first.
+
+  std::vector<Lines> split_lines(const char *text, bool center) const;
+  const StringLayout &get_layout(const char *text, bool center);
+  void clear_layout_cache();
+  const Glyph *get_glyph(uint32_t character) const;
+  RECT add_to_atlas(uint32_t width, uint32_t height, D3DFORMAT format, uint32_t stride, uint32_t rows,
+                    const uint8_t *data);
   bool create_index_buffer();
 
   virtual DWORD get_fvf_code() const = 0;
@@ -137,6 +184,10 @@ class BitmapFontBase {
   template <typename TAction>
   void for_each_glyph(const char *text, TAction action) const;
 
+  template <typename TVertex, typename TCalculate, typename TToShadow>
+  void append_run_vertices(std::span<const GlyphRun> runs, std::vector<TVertex> &out, TCalculate calculate,
+                           TToShadow to_shadow) const;
+
   float calculate_shadow_offset() const;
 
   float shadow_offset_factor = kDefaultShadowOffsetFactor;
@@ -153,11 +204,21 @@ class BitmapFontBase {
 
   IDirect3DDevice8 &device;
   Glyph glyph_table[kNumGlyphs] = {};
+  std::vector<Glyph> extended_glyphs;  // Non-ASCII glyphs sorted by character.
   float line_spacing = 0;
   char default_character = '\0';
   std::vector<GlyphQueueEntry> glyph_queue;
+  std::vector<GlyphRun> glyph_runs;  // Covers the glyph_queue in order.
+
+  std::list<StringLayout> layout_cache;  // Most recently used first.
+  std::unordered_map<uint64_t, std::list<StringLayout>::iterator> layout_index;
+  std::vector<Vec2> queued_line_origins;  // Scratch: line origins of the string being queued.
+  LayoutCacheStats layout_cache_stats;
 
-  IDirect3DTexture8 *texture = nullptr;
+  std::shared_ptr<FontAtlas> atlas;  // Texture shared with the other loaded fonts.
+  int atlas_sheet = -1;
+  IDirect3DTexture8 *texture = nullptr;  // The atlas texture (not owned), refreshed by each flush.
+  Vec2 texture_origin = {};              // Of this font's sheet within the atlas.
   Vec2 inverse_texture_size = {};
   IDirect3DVertexBuffer8 *vertex_buffer = nullptr;
   IDirect3DIndexBuffer8 *index_buffer = nullptr;
@@ -200,7 +261,7 @@ class BitmapFont : public BitmapFontBase {
   void render_queue() override;
   void calculate_glyph_vertices(const GlyphQueueEntry &entry, GlyphVertex glyph_vertices[4]) const;
 
-  std::unique_ptr<GlyphVertex[]> vertices;  // Local CPU scratch.
+  std::vector<GlyphVertex> vertices;  // Local CPU scratch.
 };
 
 // Directx 8 compatible class for fast text rendering using batch processing of bitmap glyphs.
@@ -258,5 +319,5 @@ class SpriteFont : public BitmapFontBase {
   void calculate_glyph_vertices(const GlyphQueueEntry &entry, Glyph3DVertex glyph_vertices[4]) const;
 
   std::vector<GlyphString> glyph_string_queue;  // List of strings at different Vec3 positions.
-  std::unique_ptr<Glyph3DVertex[]> vertices;    // Local CPU scratch.
+  std::vector<Glyph3DVertex> vertices;          // Local CPU scratch.
 };
\ No newline at end of file
@@ -245,14 +245,24 @@ void __fastcall OutputText(Zeal::GameUI::ChatWnd *wnd, int u, Zeal::GameUI::CXST
   ZealService *zeal = ZealService::get_instance();
   short new_channel = channel;
   if (msg.Data) {
-    // msg_data is passed by reference so that it can be modified in the callbacks.
-    std::string msg_data = msg.CastToCharPtr();
+    // msg_data is passed by reference so that it can be modified in the callbacks. It is a reused
+    // buffer (game thread only) unless a callback prints and re-enters this hook, in which case the
+    // nested call uses a local one. The client string is only replaced if a callback changed it.
+    static std::string reused_msg_data;
+    static bool reused_msg_data_busy = false;
+    std::string local_msg_data;
+    const bool use_reused = !reused_msg_data_busy;
+    std::string &msg_data = use_reused ? reused_msg_data : local_msg_data;
+    const char *original = msg.CastToCharPtr();
+    msg_data.assign(original);
+    reused_msg_data_busy = true;
     zeal->callbacks->invoke_outputtext(wnd, msg_data, new_channel);
+    if (use_reused) reused_msg_data_busy = false;
     if (msg_data.empty()) return;  // Bail out if the msg was suppressed in a callback.
 
     if (!wnd) wnd = Zeal::Game::Windows->ChatManager->ChatWindows[0];
 
-    msg.Set(msg_data);
+    if (msg_data != original) msg.Set(msg_data.c_str());
   }
   // Note: The top-level caller of OutputText will handle FreeRep() of msg (unlike in print_chat_wnd).
   zeal->hooks->hook_map["AddOutputText"]->original(OutputText)(wnd, u, msg, new_channel);
@@ -2,14 +2,19 @@
 
 #include <algorithm>
 #include <format>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <map>
 #include <regex>
 #include <set>
+#include <string_view>
 #include <unordered_set>
 
 #include "binds.h"
 #include "callbacks.h"
+#include "chat_replay.h"
+#include "chat_text.h"
 #include "chatfilter.h"
 #include "commands.h"
 #include "entity_manager.h"
@@ -22,23 +27,9 @@
 #include "labels.h"
 #include "memory.h"
 #include "string_util.h"
+#include "triggers.h"
 #include "zeal.h"
 
-std::map<std::string, std::string> channelPrefixes = {
-    {"guild", "G"},             // Guild
-    {"party", "P"},             // Group (Received)
-    {"group", "P"},             // Group (Sent)
-    {"shout", "Sh"},            // Shout
-    {"auction", "A"},           // Auction
-    {"out of character", "O"},  // OOC
-    {"BROADCAST", "B"},         // Broadcast
-    {"tell", "Fr"},             // Tell (Received)
-    {"say", "S"},               // Say
-    {"told", "To"},             // TellEcho (Sent)
-    {"raid", "R"},              // Raid
-};
-
-std::string autoInvitePassword; // Non-persistent
 std::string playerRolling;
 
 std::string ReadFromClipboard() {
@@ -87,93 +78,13 @@ std::string StripSpecialCharacters(const std::string &input) {
   return result;
 }
 
-std::string abbreviateChat(const std::string &original_message) {
-  // Pattern to look for chat messages
-  static const std::regex chat_pattern(
-      R"(^([\w ]+) (?:(?:say to your |says? |tells the |tell your |(told|tell)s? )(say)?(?:\w+:)?([\w\d: ]+)|(auction|say|shout|BROADCAST)[sS]?),?[^']+'(.*)'\s*$)");
-
-  static const std::regex roll_player_pattern(R"(^\*\*A Magic Die is rolled by (\w+)\.$)");
-  static const std::regex roll_result_pattern(
-      R"(^\*\*It could have been any number from (\d+) to (\d+), but this time it turned up a (\d+)\.$)");
-
-  std::smatch match;
-
-  if (std::regex_search(original_message, match, chat_pattern)) {
-    // match[1] is always the sender
-    // match[6] is always the message
-    // The channel can be one of the folllowing
-    //   match[5] if it exists
-    //   match[4] if it's a number (e.g. 1 from 'General:1')
-    //   match[4] if it's a known (e.g. 'party', 'guild')
-    //   otherwise, match[2] is the channel
-
-    std::string sender = match[1].str();
-    std::string message = match[6].str();
-    std::string channel;
-    std::string channel_prefix;
-    if (match[5].matched) {
-      channel = match[5].str();
-    } else if (match[4].matched) {
-      if (std::regex_match(match[4].str(), std::regex(R"(\d+)"))) {
-        channel = match[4].str();
-        channel_prefix = channel;  // Use the number for the prefix
-        // Could be a channel or a player, so need to be specific
-      } else if (match[4].str() == "party" || match[4].str() == "group" || match[4].str() == "guild" ||
-                 match[4].str() == "raid" || match[4].str() == "out of character") {
-        channel = match[4].str();
-      } else {
-        channel = match[2].str();
-      }
-    }
-
-    // Match known channels with prefixes (if not already set)
-    if (channel_prefix.empty() && channelPrefixes.count(channel)) {
-      channel_prefix = channelPrefixes[channel];
-    }
-
-    // Abort if a prefix wasn't found
-    if (channel_prefix.empty()) {
-      return original_message;
-    }
-
-    if (channel == "told") {
-      // For told, match[4] is the sender
-      sender = match[4].str();
-    }
-
-    // Replace you with your actual name
-    if (sender == "You") {
-      Zeal::GameStructures::Entity *self = Zeal::Game::get_self();
-      if (self) {
-        sender = self->Name;
-      }
-    }
-
-    std::string newMessage = "[" + channel_prefix + "] [" + sender + "]: " + message;
-    return newMessage;
-  }
-
-  if (std::regex_search(original_message, match, roll_player_pattern)) {
-    playerRolling = match[1].str();  // Player will be used when the actual roll result is printed
-    return std::string();            // Prevent this line from being printed
-  }
-
-  if (std::regex_search(original_message, match, roll_result_pattern)) {
-    if (playerRolling.length() == 0)  // Just in case
-      playerRolling = "?????";
-    std::string rollMin = match[1].str();
-    std::string rollMax = match[2].str();
-    std::string rollResult = match[3].str();
-    std::string newMessage = "[" + rollMin + "-" + rollMax + "]: " + rollResult + " rolled by " + playerRolling + ".";
-    playerRolling = std::string();  // Clear it for the next person
-    return newMessage;
-  }
-
-  // If there were no matches, return the original message
-  return original_message;
+// Abbreviates chat messages with "You" replaced by the own name (see Zeal::ChatText::abbreviate).
+static bool abbreviate_chat(std::string_view message, std::string &out) {
+  const Zeal::GameStructures::Entity *self = Zeal::Game::get_self();
+  return Zeal::ChatText::abbreviate(message, self ? self->Name : "", playerRolling, out);
 }
 
-DWORD get_class_color(std::string character_name, short channel) {
+DWORD get_class_color(const std::string &character_name, short channel) {
   static const std::unordered_set<int> valid_channels_you = {
       USERCOLOR_SPELLS,         USERCOLOR_YOU_HIT_OTHER,   USERCOLOR_OTHER_HIT_YOU,  USERCOLOR_YOU_MISS_OTHER,
       USERCOLOR_OTHER_MISS_YOU, USERCOLOR_DISCIPLINES,     USERCOLOR_YOUR_DEATH,     USERCOLOR_OTHER_DEATH,
@@ -208,85 +119,60 @@ DWORD get_class_color(std::string character_name, short channel) {
   return 0;
 }
 
-std::string add_class_colors(std::string message, short channel) {
-  auto entity_manager = ZealService::get_instance()->entity_manager.get();
-  if (!entity_manager) return message;  // Abort if entity manager unavailable
-
-  // Pattern to find STML tags or possible names
-  static const std::regex tags_or_names_pattern(R"((<[^>]*>)|(\b(?:[a-zA-Z]{4,}|Your?)\b))", std::regex::icase);
-
-  // Find matches
-  auto words_begin = std::sregex_iterator(message.cbegin(), message.cend(), tags_or_names_pattern);
-  auto words_end = std::sregex_iterator();
-
-  // Return original message if no matches were found
-  if (words_begin == words_end) {
-    return message;
-  }
-
-  // Modified string for output
-  std::string result;
-  result.reserve(message.length() * 2);
-
-  // Keep track of the last match postion
-  std::string::const_iterator last_match_pos = message.cbegin();
+// Writes the message with class color tags around known player names to result. Returns false (with
+// result unspecified) if no names were colored so the caller can keep the original message as is.
+static bool add_class_colors(const std::string &message, short channel, std::string &result) {
+  if (!ZealService::get_instance()->entity_manager) return false;  // Abort if entity manager unavailable
+  return Zeal::ChatText::add_class_colors(
+      message, [channel](const std::string &name) { return get_class_color(name, channel); }, result);
+}
 
-  for (std::sregex_iterator i = words_begin; i != words_end; ++i) {
-    std::smatch match = *i;
+// Returns the "[hh:mm:ss] " style chat prefix for the current time. The text is cached and only
+// reformatted when the displayed value changes (every second, or every minute for the HH:MM style).
+static std::string_view get_timestamp_prefix(int timestamp_style) {
+  static char prefix[16];
+  static size_t length = 0;
+  static time_t cached_key = -1;
+  static int cached_style = -1;
 
-    // Append non-matched data up to the current match
-    result.append(last_match_pos, match[0].first);
-    last_match_pos = match[0].second;
+  const time_t now = time(nullptr);
+  const time_t key = (timestamp_style == 2) ? now / 60 : now;
+  if (key == cached_key && timestamp_style == cached_style) return std::string_view(prefix, length);
 
-    // If this matches a STML tag, no modifications are needed
-    if (match[1].matched) {
-      result.append(match.str());
-    }
-    // Possible name, if it matches an entiy, add color tags
-    else if (match[2].matched) {
-      std::string possible_name = match.str();
-      std::string possible_name_lower = possible_name;
-      std::transform(possible_name_lower.begin(), possible_name_lower.end(), possible_name_lower.begin(), ::tolower);
-      std::string possible_name_capitalized = possible_name_lower;
-      possible_name_capitalized[0] = std::toupper(possible_name_capitalized[0]);
-
-      // Try to find class color for name
-      DWORD class_color = get_class_color(possible_name_capitalized, channel);
-
-      // Add color tags if a match was found
-      if (class_color) {
-        std::string replacement_name = std::format("<c \"#{:06x}\">{}</c>", class_color & 0x00ffffff, possible_name);
-        result.append(replacement_name);
-      } else {
-        result.append(possible_name);
-      }
-    }
-  }
-  // Append remaining message
-  result.append(last_match_pos, message.cend());
-
-  return result;
-}
-
-std::string generateTimestampedString(const std::string &message, int timestamp_style) {
-  time_t rawtime;
   struct tm timeinfo;
-  time(&rawtime);
-  localtime_s(&timeinfo, &rawtime);
+  localtime_s(&timeinfo, &now);
+  auto put_two_digits = [](char *&p, int value) {
+    *p++ = static_cast<char>('0' + value / 10);
+    *p++ = static_cast<char>('0' + value % 10);
+  };
 
-  std::ostringstream oss;
+  char *p = prefix;
+  *p++ = '[';
   if (timestamp_style == 1) {
-    oss << "[" << std::setw(2) << std::setfill('0') << ((timeinfo.tm_hour % 12 == 0) ? 12 : timeinfo.tm_hour % 12)
-        << ":" << std::setw(2) << std::setfill('0') << timeinfo.tm_min << ":" << std::setw(2) << std::setfill('0')
-        << timeinfo.tm_sec << " " << ((timeinfo.tm_hour >= 12) ? "PM" : "AM") << "] " << message;
-  } else if (timestamp_style == 2) {
-    oss << "[" << std::setw(2) << std::setfill('0') << timeinfo.tm_hour << ":" << std::setw(2) << std::setfill('0')
-        << timeinfo.tm_min << "] " << message;
+    put_two_digits(p, (timeinfo.tm_hour % 12 == 0) ? 12 : timeinfo.tm_hour % 12);
+    *p++ = ':';
+    put_two_digits(p, timeinfo.tm_min);
+    *p++ = ':';
+    put_two_digits(p, timeinfo.tm_sec);
+    *p++ = ' ';
+    *p++ = (timeinfo.tm_hour >= 12) ? 'P' : 'A';
+    *p++ = 'M';
   } else {
-    oss << "[" << std::setw(2) << std::setfill('0') << timeinfo.tm_hour << ":" << std::setw(2) << std::setfill('0')
-        << timeinfo.tm_min << ":" << std::setw(2) << std::setfill('0') << timeinfo.tm_sec << "] " << message;
+    put_two_digits(p, timeinfo.tm_hour);
+    *p++ = ':';
+    put_two_digits(p, timeinfo.tm_min);
+    if (timestamp_style != 2) {
+      *p++ = ':';
+      put_two_digits(p, timeinfo.tm_sec);
+    }
   }
-  return oss.str();
+  *p++ = ']';
+  *p++ = ' ';
+
+  length = p - prefix;
+  cached_key = key;
+  cached_style = timestamp_style;
+  return std::string_view(prefix, length);
 }
 
 // Function to replace underscores with spaces in a word
@@ -341,41 +227,62 @@ void Chat::handle_print_chat(const char *data, int color_index) {
   for (const auto &callback : print_chat_callbacks) callback(data, color_index);
 }
 
+// Copies the prefix and text into the fixed size client buffer, truncating if needed.
+static void copy_to_chat_buffer(char (&buffer)[2048], std::string_view prefix, std::string_view text) {
+  const size_t prefix_length = min(prefix.size(), sizeof(buffer) - 1);
+  const size_t text_length = min(text.size(), sizeof(buffer) - 1 - prefix_length);
+  memcpy(buffer, prefix.data(), prefix_length);
+  memcpy(buffer + prefix_length, text.data(), text_length);
+  buffer[prefix_length + text_length] = '\0';
+}
+
 // Note that the client PrintChat does modify the data parameter (percent converts) so it is not
 // a const char* parameter, but we are adding internal buffer copies in this calls so that this
 // wrapper effectively treats it like it is and makes print_chat safer to use in general.
+//
+// The message flows through the optional stages (abbreviation, timestamp) as a string_view of the
+// caller's data. A stage only writes to its reused buffer when it rewrites the text and disabled
+// stages do no work, so the common path is a single copy into the client buffer.
 static void __fastcall PrintChat(int t, int unused, char *data, short color_index, bool add_log) {
-  if (!data || strlen(data) == 0)  // Skip phantom prints like the client does.
+  if (!data || data[0] == '\0')  // Skip phantom prints like the client does.
     return;
 
-  ZealService::get_instance()->chat_hook->handle_print_chat(data, color_index);
-
-  const auto &abbreviated_chat = ZealService::get_instance()->chat_hook->UseAbbreviatedChat;
-
-  std::string abbreviated_buffer = (abbreviated_chat.get() > 0) ? abbreviateChat(data) : "";
-  const char *chat_buffer = (abbreviated_chat.get() > 0) ? abbreviated_buffer.c_str() : data;
-  const char *log_buffer = (abbreviated_chat.get() == 2) ? abbreviated_buffer.c_str() : data;
+  Chat *chat = ZealService::get_instance()->chat_hook.get();
+  chat->handle_print_chat(data, color_index);
+
+  const std::string_view message(data);
+  const int abbreviated_chat = chat->UseAbbreviatedChat.get();
+  // The abbreviation buffer is reused across calls (game thread only). A re-entrant print from within
+  // the client call below falls back to a local buffer so the outer views stay valid.
+  static std::string reused_buffer;
+  static bool reused_buffer_busy = false;
+  std::string local_buffer;
+  const bool use_reused_buffer = !reused_buffer_busy;
+  std::string &abbreviated_buffer = use_reused_buffer ? reused_buffer : local_buffer;
+  reused_buffer_busy = true;
+  const bool abbreviated = (abbreviated_chat > 0) && abbreviate_chat(message, abbreviated_buffer);
+  const std::string_view chat_text = abbreviated ? std::string_view(abbreviated_buffer) : message;
+  const std::string_view log_text = (abbreviated_chat == 2) ? chat_text : message;
 
   // Perform extra copies to protect unwary callers against the potential buffer size growth.
   char buffer[2048];  // Client maximum buffer size for print chat calls.
-  const auto &timestamp_style = ZealService::get_instance()->chat_hook->TimeStampsStyle;
-  bool log_is_different = timestamp_style.get() || (chat_buffer != log_buffer);
-  if (timestamp_style.get()) {
-    std::string timestamp_buffer = generateTimestampedString(chat_buffer, timestamp_style.get());
-    strncpy_s(buffer, timestamp_buffer.c_str(), sizeof(buffer));
-  } else {
-    strncpy_s(buffer, chat_buffer, sizeof(buffer));
-  }
+  const int timestamp_style = chat->TimeStampsStyle.get();
+  const std::string_view prefix = timestamp_style ? get_timestamp_prefix(timestamp_style) : std::string_view();
+  bool log_is_different = !prefix.empty() || (chat_text.data() != log_text.data());
 
-  if (std::strlen(chat_buffer) > 0)
+  if (!chat_text.empty()) {
+    copy_to_chat_buffer(buffer, prefix, chat_text);
     ZealService::get_instance()->hooks->hook_map["PrintChat"]->original(PrintChat)(t, unused, buffer, color_index,
                                                                                    add_log && !log_is_different);
+  }
 
-  if (add_log && log_is_different && std::strlen(log_buffer) > 0 && *Zeal::Game::is_logging_enabled) {
-    strncpy_s(buffer, log_buffer, sizeof(buffer));
+  if (add_log && log_is_different && !log_text.empty() && *Zeal::Game::is_logging_enabled) {
+    copy_to_chat_buffer(buffer, std::string_view(), log_text);
     Zeal::Game::GameInternal::DoPercentConvert(t, unused, buffer, 0);
     Zeal::Game::log(buffer);
   }
+
+  if (use_reused_buffer) reused_buffer_busy = false;
 }
 
 char *__fastcall StripName(int t, int unused, char *data) {
@@ -480,16 +387,16 @@ static std::vector<std::string> get_raid_list_matches(const std::string &start_o
 // Assembles a list of all tell list, raid, and local zone name matches
 static std::vector<std::string> get_all_matches(const std::string &start_of_name) {
   auto matches = get_tell_list_matches(start_of_name);
-  auto raid_matches = get_raid_list_matches(start_of_name);
-  for (const auto &name : raid_matches)
-    if (std::find(matches.begin(), matches.end(), name) == matches.end()) matches.push_back(name);
+  std::unordered_set<std::string> seen(matches.begin(), matches.end());
+  auto add_new_matches = [&matches, &seen](std::vector<std::string> &&names) {
+    for (auto &name : names)
+      if (seen.insert(name).second) matches.push_back(std::move(name));
+  };
+  add_new_matches(get_raid_list_matches(start_of_name));
 
   auto entity_manager = ZealService::get_instance()->entity_manager.get();  // Short-term ptr.
-  if (entity_manager) {
-    auto ent_matches = entity_manager->GetPlayerPartialMatches(start_of_name);
-    for (const auto &name : ent_matches)
-      if (std::find(matches.begin(), matches.end(), name) == matches.end()) matches.push_back(name);
-  }
+  if (entity_manager) add_new_matches(entity_manager->GetPlayerPartialMatches(start_of_name));
+
   if (Zeal::Game::get_self()) std::erase(matches, std::string(Zeal::Game::get_self()->Name));
   return matches;
 }
@@ -776,29 +683,81 @@ void __fastcall DoPercentConvert(int *t, int u, char *data, int u2) {
 }
 
 void Chat::DoPercentReplacements(std::string &str_data) {
-  for (auto &fn : percent_replacements) fn(str_data);
+  if (str_data.find('%') == std::string::npos) return;  // Skip the label lookups for plain text.
+  Zeal::ChatText::replace_percent_codes(str_data, GetPercentValues());
+}
+
+// Returns the current label values for the %-codes.
+Zeal::ChatText::PercentValues Chat::GetPercentValues() const {
+  Zeal::ChatText::PercentValues values;
+  auto labels = ZealService::get_instance()->labels_hook.get();
+  labels->GetLabel(20, values.mana);
+  labels->GetLabel(19, values.hp);
+  labels->GetLabel(29, values.target_hp);
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(2) << std::ceil(Zeal::Game::get_self()->Position.x * 100) / 100 << ", "
+     << std::ceil(Zeal::Game::get_self()->Position.y * 100) / 100 << ", "
+     << std::ceil(Zeal::Game::get_self()->Position.z * 100) / 100;
+  values.loc = ss.str();
+  return values;
 }
 
-// Returns a player name if the tell message matches the AutoInvitePassword
-std::string GetAutoRaidInviteName(const std::string &data) {
-  // Regex string that will match normal or abbreviated chat
-  std::string autoInviteMatch_string =
-      std::format(R"((?:\[.*\] ?)*(?:(\w+) tells you, '{0}'|\[Fr\] \[(\w+)\]: {0}))", autoInvitePassword);
-  std::regex autoInviteMatch_pattern(autoInviteMatch_string);
-  std::smatch match;
-
-  if (std::regex_match(data, match, autoInviteMatch_pattern)) {
-    if (match[1].matched)
-      // Return name for normal formatted messages
-      return match[1].str();
-    else if (match[2].matched)
-      // Return name for abbreviated chat messages
-      return match[2].str();
+// Matches incoming tells against the (non-persistent) auto raid invite password. The expected tell
+// endings are built once when the password is set, so checking a tell is a couple of suffix compares
+// and a scan back over the sender name instead of a regex compile and match per tell.
+class AutoRaidInviteMatcher {
+ public:
+  void set(const std::string &new_password) {
+    password = new_password;
+    tell_suffix = password.empty() ? "" : " tells you, '" + password + "'";
+    abbreviated_suffix = password.empty() ? "" : "]: " + password;
   }
 
-  // Always return a blank name if none was found
-  return "";
-}
+  bool empty() const { return password.empty(); }
+
+  // Returns the sender if the message is "Name tells you, 'password'" or the abbreviated chat
+  // "[Fr] [Name]: password", either optionally preceded by bracketed tags. Returns empty otherwise.
+  std::string_view match(std::string_view message) const {
+    if (password.empty()) return {};
+
+    std::string_view prefix;
+    if (message.ends_with(tell_suffix)) {
+      std::string_view name = split_trailing_word(message.substr(0, message.size() - tell_suffix.size()), prefix);
+      if (!name.empty() && is_tag_prefix(prefix)) return name;
+    }
+
+    static constexpr std::string_view kAbbreviatedTell = "[Fr] [";
+    if (message.ends_with(abbreviated_suffix)) {
+      std::string_view name =
+          split_trailing_word(message.substr(0, message.size() - abbreviated_suffix.size()), prefix);
+      if (!name.empty() && prefix.ends_with(kAbbreviatedTell) &&
+          is_tag_prefix(prefix.substr(0, prefix.size() - kAbbreviatedTell.size())))
+        return name;
+    }
+    return {};
+  }
+
+ private:
+  // Splits text into the trailing run of word characters (returned) and everything before it.
+  static std::string_view split_trailing_word(std::string_view text, std::string_view &prefix) {
+    size_t start = text.size();
+    while (start > 0 && (std::isalnum(static_cast<unsigned char>(text[start - 1])) || text[start - 1] == '_'))
+      --start;
+    prefix = text.substr(0, start);
+    return text.substr(start);
+  }
+
+  // Accepts an empty prefix or one made of "[...]" tags (timestamps, channel prefixes).
+  static bool is_tag_prefix(std::string_view prefix) {
+    return prefix.empty() || (prefix.front() == '[' && (prefix.ends_with(']') || prefix.ends_with("] ")));
+  }
+
+  std::string password;
+  std::string tell_suffix;         // " tells you, '<password>'"
+  std::string abbreviated_suffix;  // "]: <password>"
+};
+
+static AutoRaidInviteMatcher auto_raid_invite;
 
 // Returns a player name if the tell matches the expected /tc format.
 std::string GetConsentMeTellName(const std::string &data) {
@@ -905,7 +864,163 @@ static bool CheckForConsentWhoMatch(const std::string name, std::string &who, sh
   return guild_match;
 }
 
+// Returns true (and clears msg) if the message repeats the last line of its chat window within the
+// coalescing window. The first copy is shown and the repeats are summarized when the burst ends.
+// Tells are never folded so each one gets the auto-consent and raid invite handling.
+bool Chat::coalesce_output(Zeal::GameUI::ChatWnd *wnd, std::string &msg, short channel) {
+  auto it = std::find_if(coalesced_lines.begin(), coalesced_lines.end(),
+                         [wnd](const CoalescedLine &line) { return line.wnd == wnd; });
+  if (channel == USERCOLOR_TELL) {
+    if (it != coalesced_lines.end()) {  // Still ends the burst, so its summary goes out first.
+      print_coalesced_summary(*it);
+      coalesced_lines.erase(it);
+    }
+    return false;
+  }
+
+  const uint32_t hash = Zeal::ChatText::get_coalesce_hash(msg, CoalesceChatIgnoreNumbers.get());
+  const ULONGLONG now = GetTickCount64();
+  if (it == coalesced_lines.end()) {
+    coalesced_lines.push_back({wnd, channel, hash, now});
+    return false;
+  }
+
+  const ULONGLONG window = static_cast<ULONGLONG>(CoalesceChatWindow.get());
+  if (it->hash == hash && it->channel == channel && now - it->start_time <= window) {
+    it->repeats++;
+    it->last_text.assign(msg);
+    msg.clear();
+    return true;
+  }
+
+  // A different line ends the burst. Its summary goes out first to keep the window in order.
+  print_coalesced_summary(*it);
+  it->channel = channel;
+  it->hash = hash;
+  it->start_time = now;
+  return false;
+}
+
+// Prints the pending "(xN)" summary directly to the window (bypassing the output callbacks). The
+// suppressed copies skipped the class coloring, so it is applied here like it was to the first copy.
+void Chat::print_coalesced_summary(CoalescedLine &line) {
+  if (line.repeats == 0) return;
+  Zeal::GameUI::ChatWnd *wnd = line.wnd ? line.wnd : Zeal::Game::Windows->ChatManager->ChatWindows[0];
+  std::string colored_text;
+  const bool colored = UseClassChatColors.get() && add_class_colors(line.last_text, line.channel, colored_text);
+  std::string &text = colored ? colored_text : line.last_text;
+  static constexpr size_t kMaxSummaryText = 480;  // Leaves room for the count in print_chat_wnd's 512 byte buffer.
+  Zeal::ChatText::truncate_stml(text, kMaxSummaryText);
+  Zeal::Game::print_chat_wnd(wnd, line.channel, "%s (x%d)", text.c_str(), line.repeats);
+  line.repeats = 0;
+}
+
+// Summarizes the bursts whose window has elapsed (or all of them). A burst that is still repeating
+// keeps folding into a new summary per window, while idle lines stop being tracked.
+void Chat::flush_coalesced_lines(bool expired_only) {
+  if (coalesced_lines.empty() || !Zeal::Game::is_in_game()) return;
+
+  const ULONGLONG now = GetTickCount64();
+  std::erase_if(coalesced_lines, [this, now, expired_only](CoalescedLine &line) {
+    if (expired_only && now - line.start_time <= static_cast<ULONGLONG>(CoalesceChatWindow.get())) return false;
+    if (line.repeats == 0) return true;
+    print_coalesced_summary(line);
+    line.start_time = now;
+    return !expired_only;
+  });
+}
+
+void Chat::handle_coalesce_args(const std::vector<std::string> &args) {
+  int value = 0;
+  if (args.size() == 2 && (args[1] == "on" || args[1] == "off")) {
+    CoalesceChat.set(args[1] == "on");
+  } else if (args.size() == 3 && args[1] == "window" && Zeal::String::tryParse(args[2], &value) && value >= 100 &&
+             value <= 10000) {
+    CoalesceChatWindow.set(value);
+  } else if (args.size() == 3 && args[1] == "numbers" && (args[2] == "on" || args[2] == "off")) {
+    CoalesceChatIgnoreNumbers.set(args[2] == "on");
+  } else if (args.size() != 1) {
+    Zeal::Game::print_chat("Usage: /coalescechat [on | off | window <100-10000 ms> | numbers <on | off>]");
+    return;
+  }
+  Zeal::Game::print_chat("Chat coalescing is %s (window: %d ms, ignore numbers: %s)",
+                         CoalesceChat.get() ? "on" : "off", CoalesceChatWindow.get(),
+                         CoalesceChatIgnoreNumbers.get() ? "on" : "off");
+}
+
+// Replays the lines of a client log file (the "[timestamp] " prefixes are stripped) through the
+// chat processing stages one stage at a time and reports the average cost per line of each. The
+// stages run against the live game state (zone roster, labels, loaded triggers) and use the
+// default chat channel since logs don't record it. Triggers are only matched, not activated.
+void Chat::run_chat_benchmark(const std::string &filename, int max_lines) {
+  if (benchmark_thread.joinable()) {
+    Zeal::Game::print_chat("Chat benchmark is already running");
+    return;
+  }
+  const Zeal::GameStructures::Entity *self = Zeal::Game::get_self();
+  if (!Zeal::Game::is_in_game() || !self) {
+    Zeal::Game::print_chat("Chat benchmark requires being in game");
+    return;
+  }
+
+  // Snapshot the live state on the game thread so the replay never touches the client.
+  auto context = std::make_unique<Zeal::ChatReplay::Context>();
+  context->self_name = self->Name;
+  for (auto *entity = Zeal::Game::get_entity_list(); entity; entity = entity->Next) {
+    if (entity->Type != Zeal::GameEnums::Player) continue;
+    DWORD color = get_class_color(entity->Name, CHATCOLOR_DEFAULT);
+    if (color) context->roster[entity->Name] = color;
+  }
+  Zeal::GameStructures::RaidInfo *raid_info = Zeal::Game::RaidInfo;
+  if (raid_info->is_in_raid()) {
+    for (int i = 0; i < Zeal::GameStructures::RaidInfo::kRaidMaxMembers; ++i) {
+      const auto &member = raid_info->MemberList[i];
+      if (member.Name[0]) context->roster.emplace(member.Name, Zeal::Game::get_raid_class_color(member.ClassValue));
+    }
+  }
+  auto zeal = ZealService::get_instance();
+  if (zeal->chatfilter_hook) {
+    std::vector<Zeal::ChatReplay::FilterRule> rules;
+    for (const auto &filter : zeal->chatfilter_hook->Extended_ChannelMaps)
+      rules.push_back({filter.name, filter.dispatch, filter.channels});
+    context->set_filters(std::move(rules));
+  }
+  if (zeal->triggers) context->triggers = zeal->triggers->GetTriggers();
+  context->percent_values = GetPercentValues();
+  context->coalesce_ignore_numbers = CoalesceChatIgnoreNumbers.get();
+
+  Zeal::Game::print_chat("Chat benchmark: replaying up to %d lines of %s", max_lines, filename.c_str());
+  benchmark_done.store(false, std::memory_order_relaxed);
+  benchmark_thread = std::thread([this, context = std::move(context), filename, max_lines]() {
+    benchmark_line_count = 0;
+    benchmark_costs.clear();
+    std::ifstream file(filename);
+    if (file.is_open()) {
+      std::vector<Zeal::ChatReplay::Line> lines;
+      benchmark_line_count = Zeal::ChatReplay::load_lines(file, CHATCOLOR_DEFAULT, max_lines, lines);
+      benchmark_costs = Zeal::ChatReplay::measure(*context, lines);
+    }
+    benchmark_done.store(true, std::memory_order_release);
+  });
+}
+
+// Prints the chat benchmark results once the worker has finished.
+void Chat::report_chat_benchmark() {
+  if (!benchmark_thread.joinable() || !benchmark_done.load(std::memory_order_acquire)) return;
+  benchmark_thread.join();
+  if (benchmark_costs.empty()) {
+    Zeal::Game::print_chat("Chat benchmark: no chat lines read");
+    return;
+  }
+  Zeal::Game::print_chat("Chat benchmark: %d lines", static_cast<int>(benchmark_line_count));
+  for (const auto &cost : benchmark_costs)
+    Zeal::Game::print_chat("  %s: %.0f ns/line", cost.name, cost.ns_per_line);
+}
+
 void Chat::AddOutputText(Zeal::GameUI::ChatWnd *wnd, std::string &msg, short &channel) {
+  // Fold repeated lines (other than tells) first so suppressed copies skip the rest of the processing.
+  if (CoalesceChat.get() && !msg.empty() && coalesce_output(wnd, msg, channel)) return;
+
   if (channel == USERCOLOR_TELL && EnableAutoConsent.get()) {
     std::string name = GetConsentMeTellName(msg);
     if (!name.empty()) {
@@ -927,44 +1042,17 @@ void Chat::AddOutputText(Zeal::GameUI::ChatWnd *wnd, std::string &msg, short &ch
     }
   }
 
-  if (channel == USERCOLOR_TELL && !autoInvitePassword.empty()) {
-    std::string name = GetAutoRaidInviteName(msg);
+  if (channel == USERCOLOR_TELL && !auto_raid_invite.empty()) {
+    std::string name(auto_raid_invite.match(msg));
     if (!name.empty()) Zeal::Game::do_say(true, "#raidinvite %s", name.c_str());
   }
 
   if (UseClassChatColors.get() && !msg.empty()) {
-    msg = add_class_colors(msg, channel);
+    static std::string colored_msg;  // Reused output buffer (swapped with msg when modified).
+    if (add_class_colors(msg, channel, colored_msg)) msg.swap(colored_msg);
   }
 }
 
-void Chat::InitPercentReplacements() {
-  percent_replacements.push_back([](std::string &str_data) {
-    std::string mana;
-    ZealService::get_instance()->labels_hook->GetLabel(20, mana);
-    Zeal::String::replace(str_data, "%mana", mana + "%");
-    Zeal::String::replace(str_data, "%n", mana + "%");
-  });
-  percent_replacements.push_back([](std::string &str_data) {
-    std::string hp;
-    ZealService::get_instance()->labels_hook->GetLabel(19, hp);
-    Zeal::String::replace(str_data, "%hp", hp + "%");
-    Zeal::String::replace(str_data, "%h", hp + "%");
-  });
-  percent_replacements.push_back([](std::string &str_data) {
-    std::stringstream ss;
-    ss << std::fixed << std::setprecision(2) << std::ceil(Zeal::Game::get_self()->Position.x * 100) / 100 << ", "
-       << std::ceil(Zeal::Game::get_self()->Position.y * 100) / 100 << ", "
-       << std::ceil(Zeal::Game::get_self()->Position.z * 100) / 100;
-    Zeal::String::replace(str_data, "%loc", ss.str());
-  });
-  percent_replacements.push_back([](std::string &str_data) {
-    std::string target_hp;
-    ZealService::get_instance()->labels_hook->GetLabel(29, target_hp);
-    Zeal::String::replace(str_data, "%targethp", target_hp + "%");
-    Zeal::String::replace(str_data, "%th", target_hp + "%");
-  });
-}
-
 void Chat::handle_incoming_gsay(const char *msg) {
   for (const auto &callback : gsay_callbacks) callback(msg);
 }
@@ -1046,11 +1134,8 @@ Chat::Chat(ZealService *zeal) {
   zeal->commands_hook->Add(
       "/autoraidinvite", {"/ari"}, "Will raid-invite anyone who sends you a tell with a matching password.", [this](std::vector<std::string> &args) {
         if (args.size() == 2) {
-          if (args[1] == "off")
-            autoInvitePassword.clear();
-          else
-            autoInvitePassword = args[1];
-          Zeal::Game::print_chat("Auto-Raid invite %s.", autoInvitePassword.empty() ? "disabled" : "enabled");
+          auto_raid_invite.set(args[1] == "off" ? "" : args[1]);
+          Zeal::Game::print_chat("Auto-Raid invite %s.", auto_raid_invite.empty() ? "disabled" : "enabled");
         } else {
           Zeal::Game::print_chat("Use \"/autoraidinvite <password>\" to enable or \"/autoraidinvite off\" to disable.");
         }
@@ -1071,6 +1156,12 @@ Chat::Chat(ZealService *zeal) {
             "Usage: /timestamp <style> where <style> = 0 (Off), 1 (Long), 2 (Short), 3 (Short+Secs)");
         return true;  // No existing cmd.
       });
+  zeal->commands_hook->Add("/coalescechat", {},
+                           "Folds repeated chat lines within a short window into one (xN) line per chat window.",
+                           [this](std::vector<std::string> &args) {
+                             handle_coalesce_args(args);
+                             return true;
+                           });
   zeal->commands_hook->Add("/zealinput", {"/zinput"}, "Toggles zeal input which gives you a more modern input feel.",
                            [this](std::vector<std::string> &args) {
                              UseZealInput.toggle();
@@ -1194,7 +1285,6 @@ Chat::Chat(ZealService *zeal) {
   zeal->hooks->Add("GetRGBAFromIndex4", 0x407da2, GetRGBAFromIndex, hook_type_replace_call);
   zeal->hooks->Add("GetRGBAFromIndex5", 0x4139eb, GetRGBAFromIndex, hook_type_replace_call);
   zeal->hooks->Add("GetRGBAFromIndex6", 0x438719, GetRGBAFromIndex, hook_type_replace_call);
-  InitPercentReplacements();
 
   // Hook incoming text messages (raid, gsay, chat) to intercept messages.
   zeal->hooks->Add("MsgNewText", 0x004e25a1, msg_new_text, hook_type_detour);
@@ -1210,6 +1300,13 @@ Chat::Chat(ZealService *zeal) {
   zeal->callbacks->AddOutputText([this](Zeal::GameUI::ChatWnd *&wnd, std::string &msg, short &channel) {
     this->AddOutputText(wnd, msg, channel);
   });
+  zeal->callbacks->AddGeneric(
+      [this]() {
+        flush_coalesced_lines(true);
+        report_chat_benchmark();
+      },
+      callback_type::MainLoop);
+  zeal->callbacks->AddGeneric([this]() { coalesced_lines.clear(); }, callback_type::CleanUI);
 }
 
 void Chat::set_classes() {
@@ -1221,7 +1318,9 @@ void Chat::set_classes() {
   }
 }
 
-Chat::~Chat() {}
+Chat::~Chat() {
+  if (benchmark_thread.joinable()) benchmark_thread.join();
+}
 
 void Chat::handle_opt_chat(std::vector<std::string> &args) {
   if (args.size() > 2) {
@@ -1,9 +1,13 @@
 #pragma once
 
+#include <atomic>
 #include <functional>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include "chat_replay.h"
+#include "chat_text.h"
 #include "game_ui.h"
 #include "zeal_settings.h"
 
@@ -18,6 +22,10 @@ class Chat {
   ZealSetting<bool> EnableAutoConsent = {false, "Zeal", "AutoConsent", false};
   ZealSetting<int> UseAbbreviatedChat = {0, "Zeal", "AbbreviatedChat", false};
   ZealSetting<int> TimeStampsStyle = {0, "Zeal", "ChatTimestamps", false};
+  ZealSetting<bool> CoalesceChat = {false, "Zeal", "CoalesceChat", false,
+                                    [this](bool val) { flush_coalesced_lines(false); }};
+  ZealSetting<int> CoalesceChatWindow = {1000, "Zeal", "CoalesceChatWindow", false};  // Milliseconds.
+  ZealSetting<bool> CoalesceChatIgnoreNumbers = {true, "Zeal", "CoalesceChatIgnoreNumbers", false};
 
   std::function<unsigned int(int)> get_color_callback;
 
@@ -70,12 +78,30 @@ class Chat {
 
   bool IsConsentWhoPending();
 
+  // Replays up to max_lines of a client log file through the chat processing stages on a worker
+  // thread (using a snapshot of the roster, filters and triggers) and reports the cost per stage.
+  void run_chat_benchmark(const std::string &filename, int max_lines);
+
   Chat(class ZealService *pHookWrapper);
   ~Chat();
 
  private:
-  void InitPercentReplacements();
-  std::vector<std::function<void(std::string &str_data)>> percent_replacements;
+  // The most recent line shown in a chat window, used to fold repeats of it into one "(xN)" line.
+  struct CoalescedLine {
+    Zeal::GameUI::ChatWnd *wnd = nullptr;
+    short channel = 0;
+    uint32_t hash = 0;
+    ULONGLONG start_time = 0;
+    int repeats = 0;        // Suppressed copies since the line (or the last summary) was shown.
+    std::string last_text;  // Most recent suppressed copy, shown in the summary.
+  };
+
+  Zeal::ChatText::PercentValues GetPercentValues() const;
+  bool coalesce_output(Zeal::GameUI::ChatWnd *wnd, std::string &msg, short channel);
+  void flush_coalesced_lines(bool expired_only);
+  void print_coalesced_summary(CoalescedLine &line);
+  void handle_coalesce_args(const std::vector<std::string> &args);
+  void report_chat_benchmark();
   std::vector<std::function<void(const char *data, int color_index)>> print_chat_callbacks;
   std::vector<std::function<void(const char *data)>> gsay_callbacks;
   std::vector<std::function<void(const char *data)>> rsay_callbacks;
@@ -83,4 +109,9 @@ class Chat {
   std::function<bool(int key, bool down, int modifier)> key_press_callback;
   DWORD pending_consent_timeout_ms = 0;
   std::string pending_consent_name;
+  std::vector<CoalescedLine> coalesced_lines;  // One entry per active chat window.
+  std::thread benchmark_thread;
+  std::atomic<bool> benchmark_done = false;  // Set by the benchmark thread once the results below are complete.
+  size_t benchmark_line_count = 0;
+  std::vector<Zeal::ChatReplay::StageCost> benchmark_costs;
 };
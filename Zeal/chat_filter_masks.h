@@ -0,0 +1,73 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+// Selects which messages are offered to a chat filter. Channel filters are dispatched by the message
+// channel id alone, Damage filters only while a hit is being reported, and Always filters see every
+// message.
+enum class ChatFilterDispatch { Channels, Damage, Always };
+
+// Bitmasks (by filter index) of the chat filters to offer a message. Kept apart from chatfilter so
+// the chat replay tests and benchmark (Zeal/tests) dispatch through the same tables. Filters past the
+// first kMaskBits don't get a bit and are offered every message instead (like Always filters), so
+// adding filters never silently drops one.
+class ChatFilterMasks {
+ public:
+  static constexpr int kMaxChannel = 1024;  // Covers the USERCOLOR_ and CHANNEL_ ids.
+  static constexpr size_t kMaskBits = 64;
+
+  // Rebuilds the masks from filters exposing dispatch (ChatFilterDispatch) and channels (short ids).
+  template <typename Filter>
+  void build(const std::vector<Filter> &filters) {
+    channel_masks.fill(0);
+    damage_mask = 0;
+    always_mask = 0;
+    overflow_count = filters.size() > kMaskBits ? filters.size() - kMaskBits : 0;
+    const size_t count = filters.size() - overflow_count;
+    for (size_t i = 0; i < count; ++i) {
+      const auto &filter = filters[i];
+      const uint64_t bit = uint64_t(1) << i;
+      if (filter.dispatch == ChatFilterDispatch::Damage)
+        damage_mask |= bit;
+      else if (filter.dispatch == ChatFilterDispatch::Always)
+        always_mask |= bit;
+      else {
+        for (short channel : filter.channels) {
+          if (channel >= 0 && channel < kMaxChannel)
+            channel_masks[channel] |= bit;
+          else
+            always_mask |= bit;  // Out of table range, so offer it every message to check itself.
+        }
+      }
+    }
+  }
+
+  uint64_t get_channel_mask(short channel) const {
+    return (channel >= 0 && channel < kMaxChannel) ? channel_masks[channel] : 0;
+  }
+
+  // Calls handle(index) for each filter offered the message, in filter order. The handler may
+  // re-route the channel, which also offers the message to the later filters of the new channel.
+  template <typename Handler>
+  void dispatch(short &channel, bool is_damage, Handler &&handle) const {
+    uint64_t mask = get_channel_mask(channel) | always_mask;
+    if (is_damage) mask |= damage_mask;
+
+    while (mask) {
+      const int index = std::countr_zero(mask);
+      mask &= mask - 1;
+      const short original_channel = channel;
+      handle(static_cast<size_t>(index));
+      if (channel != original_channel) mask |= get_channel_mask(channel) & ~((uint64_t(2) << index) - 1);
+    }
+    for (size_t index = kMaskBits; index < kMaskBits + overflow_count; ++index) handle(index);
+  }
+
+ private:
+  std::array<uint64_t, kMaxChannel> channel_masks = {};
+  uint64_t damage_mask = 0;
+  uint64_t always_mask = 0;
+  size_t overflow_count = 0;  // Filters past kMaskBits.
+};
@@ -0,0 +1,119 @@
+#include "chat_replay.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+
+namespace Zeal {
+namespace ChatReplay {
+
+size_t load_lines(std::istream &stream, short default_channel, size_t max_lines, std::vector<Line> &lines) {
+  size_t count = 0;
+  std::string text;
+  while (count < max_lines && std::getline(stream, text)) {
+    if (!text.empty() && text.back() == '\r') text.pop_back();
+    if (text.empty() || text.front() == '#') continue;
+
+    short channel = default_channel;
+    const size_t tab = text.find('\t');
+    int id = 0;
+    auto [end, error] = std::from_chars(text.data(), text.data() + (tab == std::string::npos ? 0 : tab), id);
+    if (tab != std::string::npos && error == std::errc() && end == text.data() + tab) {
+      channel = static_cast<short>(id);
+      text.erase(0, tab + 1);
+    } else if (text.starts_with('[')) {
+      const size_t stamp_end = text.find("] ");
+      if (stamp_end != std::string::npos) text.erase(0, stamp_end + 2);
+    }
+    if (text.empty()) continue;
+    lines.push_back({channel, std::move(text)});
+    ++count;
+  }
+  return count;
+}
+
+static uint32_t get_roster_color(const Context &context, const std::string &name) {
+  auto it = context.roster.find(name);
+  return (it != context.roster.end()) ? it->second : 0;
+}
+
+static int classify(const Context &context, short &channel) {
+  int handled_by = -1;
+  context.filter_masks.dispatch(channel, false, [&](size_t index) {
+    const auto &channels = context.filters[index].channels;
+    if (std::find(channels.begin(), channels.end(), channel) != channels.end()) handled_by = static_cast<int>(index);
+  });
+  return handled_by;
+}
+
+void process_line(const Context &context, const Line &line, std::string &player_rolling, LineResult &result) {
+  result.abbreviated = Zeal::ChatText::abbreviate(line.text, context.self_name, player_rolling, result.abbreviation);
+  if (!result.abbreviated) result.abbreviation.clear();
+
+  result.colored = Zeal::ChatText::add_class_colors(
+      line.text, [&context](const std::string &name) { return get_roster_color(context, name); },
+      result.class_colors);
+  if (!result.colored) result.class_colors.clear();
+
+  result.coalesce_hash = Zeal::ChatText::get_coalesce_hash(line.text, context.coalesce_ignore_numbers);
+
+  result.percent_codes = line.text;
+  Zeal::ChatText::replace_percent_codes(result.percent_codes, context.percent_values);
+
+  result.channel = line.channel;
+  result.filter = classify(context, result.channel);
+
+  result.trigger = context.triggers.find(line.text.c_str());
+}
+
+std::vector<StageCost> measure(const Context &context, const std::vector<Line> &lines,
+                               const std::function<uint64_t()> &get_allocation_count) {
+  std::vector<StageCost> costs;
+  if (lines.empty()) return costs;
+
+  auto time_stage = [&](const char *name, auto &&stage) {
+    const uint64_t start_allocations = get_allocation_count ? get_allocation_count() : 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &line : lines) stage(line);
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    const double allocations =
+        get_allocation_count ? static_cast<double>(get_allocation_count() - start_allocations) / lines.size() : -1;
+    costs.push_back({name, elapsed.count() / lines.size(), allocations});
+  };
+
+  // The output buffers are reused across lines like the hooks' buffers, so size them up front.
+  size_t max_length = 0;
+  for (const auto &line : lines) max_length = std::max(max_length, line.text.size());
+  std::string player_rolling;
+  std::string output;
+  std::string working;
+  output.reserve(max_length * 2);
+  working.reserve(max_length * 2);
+
+  time_stage("abbreviation", [&](const Line &line) {
+    Zeal::ChatText::abbreviate(line.text, context.self_name, player_rolling, output);
+  });
+  time_stage("class colors", [&](const Line &line) {
+    Zeal::ChatText::add_class_colors(
+        line.text, [&context](const std::string &name) { return get_roster_color(context, name); }, output);
+  });
+  volatile uint32_t hash_sink = 0;  // Keeps the hash from being optimized out.
+  time_stage("coalesce hash", [&](const Line &line) {
+    hash_sink = Zeal::ChatText::get_coalesce_hash(line.text, context.coalesce_ignore_numbers);
+  });
+  time_stage("percent codes", [&](const Line &line) {
+    working.assign(line.text);
+    Zeal::ChatText::replace_percent_codes(working, context.percent_values);
+  });
+  volatile int filter_sink = 0;
+  time_stage("chat filters", [&](const Line &line) {
+    short channel = line.channel;
+    filter_sink = classify(context, channel);
+  });
+  volatile bool trigger_sink = false;
+  time_stage("triggers", [&](const Line &line) { trigger_sink = context.triggers.find(line.text.c_str()) != nullptr; });
+  return costs;
+}
+
+}  // namespace ChatReplay
+}  // namespace Zeal
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "chat_filter_masks.h"
+#include "chat_text.h"
+#include "trigger_list.h"
+
+// Replays a captured chat stream through the portable chat processing stages. Used by the in-game
+// /zeal chatbench command (on a snapshot of the live state) and by the chat replay regression test
+// and benchmark in Zeal/tests (on the shipped corpora and a synthetic roster).
+namespace Zeal {
+namespace ChatReplay {
+
+struct Line {
+  short channel;  // Chat channel (USERCOLOR_ or CHANNEL_ id).
+  std::string text;
+};
+
+// Appends up to max_lines lines of a stream to lines and returns the number added. Corpus lines are
+// "<channel id><tab><text>" and '#' comments and blank lines are skipped. Other lines are read as a
+// client log: a leading "[timestamp] " is stripped and default_channel is used.
+size_t load_lines(std::istream &stream, short default_channel, size_t max_lines, std::vector<Line> &lines);
+
+// A chat filter reduced to its dispatch rule. Only Channels filters can handle a replayed message.
+struct FilterRule {
+  std::string name;
+  ChatFilterDispatch dispatch;
+  std::vector<short> channels;
+};
+
+// The game state the stages read, captured once so a replay does not touch the live client.
+struct Context {
+  std::string self_name;                             // Replaces the "You" sender when abbreviating.
+  std::unordered_map<std::string, uint32_t> roster;  // Capitalized name to ARGB class color.
+  std::vector<FilterRule> filters;                   // In Extended_ChannelMaps order.
+  ChatFilterMasks filter_masks;                      // Built from filters.
+  TriggerList triggers;
+  Zeal::ChatText::PercentValues percent_values;
+  bool coalesce_ignore_numbers = true;
+
+  void set_filters(std::vector<FilterRule> rules) {
+    filters = std::move(rules);
+    filter_masks.build(filters);
+  }
+};
+
+// The output of every stage for one line. Each stage runs on the original line text.
+struct LineResult {
+  bool abbreviated = false;
+  std::string abbreviation;  // Empty for a suppressed line.
+  bool colored = false;
+  std::string class_colors;
+  uint32_t coalesce_hash = 0;
+  std::string percent_codes;
+  short channel = 0;  // After filter re-routes.
+  int filter = -1;    // Index of the filter that took the line (-1 for none).
+  const TriggerList::Trigger *trigger = nullptr;
+};
+
+// Runs the stages on one line. player_rolling carries the roller between the two lines of a roll.
+void process_line(const Context &context, const Line &line, std::string &player_rolling, LineResult &result);
+
+struct StageCost {
+  const char *name;
+  double ns_per_line;
+  double allocations_per_line;  // Negative if not counted.
+};
+
+// Times each stage separately over all lines. If get_allocation_count is set it must return the
+// running count of heap allocations (e.g. from a counting operator new) to report allocations/line.
+std::vector<StageCost> measure(const Context &context, const std::vector<Line> &lines,
+                               const std::function<uint64_t()> &get_allocation_count = nullptr);
+
+}  // namespace ChatReplay
+}  // namespace Zeal
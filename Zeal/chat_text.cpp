@@ -0,0 +1,237 @@
+#include "chat_text.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <map>
+#include <regex>
+
+#include "string_util.h"
+
+namespace Zeal {
+namespace ChatText {
+
+static const std::map<std::string, std::string> channelPrefixes = {
+    {"guild", "G"},             // Guild
+    {"party", "P"},             // Group (Received)
+    {"group", "P"},             // Group (Sent)
+    {"shout", "Sh"},            // Shout
+    {"auction", "A"},           // Auction
+    {"out of character", "O"},  // OOC
+    {"BROADCAST", "B"},         // Broadcast
+    {"tell", "Fr"},             // Tell (Received)
+    {"say", "S"},               // Say
+    {"told", "To"},             // TellEcho (Sent)
+    {"raid", "R"},              // Raid
+};
+
+bool abbreviate(std::string_view original_message, std::string_view self_name, std::string &player_rolling,
+                std::string &out) {
+  // Every abbreviated message is either a quoted chat line or a "**" prefixed roll line, so the
+  // (frequent) remaining lines skip the regex searches entirely.
+  const bool is_roll = original_message.starts_with("**");
+  if (!is_roll && original_message.find('\'') == std::string_view::npos) return false;
+
+  // Pattern to look for chat messages
+  static const std::regex chat_pattern(
+      R"(^([\w ]+) (?:(?:say to your |says? |tells the |tell your |(told|tell)s? )(say)?(?:\w+:)?([\w\d: ]+)|(auction|say|shout|BROADCAST)[sS]?),?[^']+'(.*)'\s*$)");
+
+  static const std::regex roll_player_pattern(R"(^\*\*A Magic Die is rolled by (\w+)\.$)");
+  static const std::regex roll_result_pattern(
+      R"(^\*\*It could have been any number from (\d+) to (\d+), but this time it turned up a (\d+)\.$)");
+
+  const char *begin = original_message.data();
+  const char *end = begin + original_message.size();
+  std::cmatch match;
+
+  if (!is_roll && std::regex_search(begin, end, match, chat_pattern)) {
+    // match[1] is always the sender
+    // match[6] is always the message
+    // The channel can be one of the folllowing
+    //   match[5] if it exists
+    //   match[4] if it's a number (e.g. 1 from 'General:1')
+    //   match[4] if it's a known (e.g. 'party', 'guild')
+    //   otherwise, match[2] is the channel
+
+    std::string sender = match[1].str();
+    std::string channel;
+    std::string channel_prefix;
+    if (match[5].matched) {
+      channel = match[5].str();
+    } else if (match[4].matched) {
+      channel = match[4].str();
+      if (std::all_of(channel.begin(), channel.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        channel_prefix = channel;  // Use the number for the prefix
+        // Could be a channel or a player, so need to be specific
+      } else if (channel != "party" && channel != "group" && channel != "guild" && channel != "raid" &&
+                 channel != "out of character") {
+        channel = match[2].str();
+      }
+    }
+
+    // Match known channels with prefixes (if not already set)
+    if (channel_prefix.empty()) {
+      auto it = channelPrefixes.find(channel);
+      if (it != channelPrefixes.end()) channel_prefix = it->second;
+    }
+
+    // Abort if a prefix wasn't found
+    if (channel_prefix.empty()) {
+      return false;
+    }
+
+    if (channel == "told") {
+      // For told, match[4] is the sender
+      sender = match[4].str();
+    }
+
+    // Replace you with your actual name
+    if (sender == "You" && !self_name.empty()) sender = self_name;
+
+    out.clear();
+    out.append("[").append(channel_prefix).append("] [").append(sender).append("]: ");
+    out.append(match[6].first, match[6].second);
+    return true;
+  }
+
+  if (is_roll && std::regex_search(begin, end, match, roll_player_pattern)) {
+    player_rolling = match[1].str();  // Player will be used when the actual roll result is printed
+    out.clear();                      // Prevent this line from being printed
+    return true;
+  }
+
+  if (is_roll && std::regex_search(begin, end, match, roll_result_pattern)) {
+    if (player_rolling.length() == 0)  // Just in case
+      player_rolling = "?????";
+    out.clear();
+    out.append("[").append(match[1].first, match[1].second).append("-").append(match[2].first, match[2].second);
+    out.append("]: ").append(match[3].first, match[3].second).append(" rolled by ").append(player_rolling).append(".");
+    player_rolling = std::string();  // Clear it for the next person
+    return true;
+  }
+
+  // If there were no matches, the original message is used
+  return false;
+}
+
+bool add_class_colors(const std::string &message, const ClassColorLookup &get_color, std::string &result) {
+  // Pattern to find STML tags or possible names
+  static const std::regex tags_or_names_pattern(R"((<[^>]*>)|(\b(?:[a-zA-Z]{4,}|Your?)\b))", std::regex::icase);
+
+  // Find matches
+  auto words_begin = std::sregex_iterator(message.cbegin(), message.cend(), tags_or_names_pattern);
+  auto words_end = std::sregex_iterator();
+
+  // Keep the original message if no matches were found
+  if (words_begin == words_end) {
+    return false;
+  }
+
+  // Modified string for output
+  result.clear();
+  result.reserve(message.length() * 2);
+  static thread_local std::string possible_name_capitalized;  // Reused lookup key.
+  bool colored = false;
+
+  // Keep track of the last match postion
+  std::string::const_iterator last_match_pos = message.cbegin();
+
+  for (std::sregex_iterator i = words_begin; i != words_end; ++i) {
+    const std::smatch &match = *i;
+
+    // Append non-matched data up to the current match
+    result.append(last_match_pos, match[0].first);
+    last_match_pos = match[0].second;
+
+    // Possible name, if it matches an entiy, add color tags (STML tags are passed through unmodified)
+    if (match[2].matched) {
+      possible_name_capitalized.assign(match[0].first, match[0].second);
+      std::transform(possible_name_capitalized.begin(), possible_name_capitalized.end(),
+                     possible_name_capitalized.begin(), ::tolower);
+      possible_name_capitalized[0] = std::toupper(possible_name_capitalized[0]);
+
+      // Try to find class color for name
+      uint32_t class_color = get_color(possible_name_capitalized);
+
+      // Add color tags if a match was found
+      if (class_color) {
+        char color_tag[16];
+        std::snprintf(color_tag, sizeof(color_tag), "<c \"#%06x\">", class_color & 0x00ffffff);
+        result.append(color_tag);
+        result.append(match[0].first, match[0].second);
+        result.append("</c>");
+        colored = true;
+        continue;
+      }
+    }
+    result.append(match[0].first, match[0].second);
+  }
+  // Append remaining message
+  result.append(last_match_pos, message.cend());
+
+  return colored;
+}
+
+bool truncate_stml(std::string &text, size_t max_length) {
+  static constexpr std::string_view kEllipsis = "...";
+  static constexpr std::string_view kCloseColor = "</c>";
+  if (text.size() <= max_length) return false;
+
+  // Find the last cut position outside of any tag or link that leaves room for the endings.
+  const size_t limit = max_length - std::min(max_length, kEllipsis.size() + kCloseColor.size());
+  size_t cut = 0;
+  bool cut_in_color = false;
+  bool in_color = false;
+  for (size_t i = 0; i < limit;) {
+    size_t end = i + 1;
+    if (text[i] == '<') {
+      end = text.find('>', i);
+      if (end == std::string::npos) break;
+      std::string_view tag(text.data() + i, ++end - i);
+      if (tag.starts_with("<c ")) in_color = true;
+      if (tag == kCloseColor) in_color = false;
+    } else if (text[i] == '\x12') {  // Item links are 0x12 delimited.
+      end = text.find('\x12', i + 1);
+      if (end == std::string::npos) break;
+      ++end;
+    }
+    if (end > limit) break;
+    i = cut = end;
+    cut_in_color = in_color;
+  }
+
+  text.resize(cut);
+  text.append(kEllipsis);
+  if (cut_in_color) text.append(kCloseColor);
+  return true;
+}
+
+uint32_t get_coalesce_hash(std::string_view text, bool ignore_numbers) {
+  uint32_t hash = 2166136261u;
+  bool in_number = false;
+  for (char c : text) {
+    if (ignore_numbers && c >= '0' && c <= '9') {
+      if (in_number) continue;
+      in_number = true;
+      c = '#';
+    } else {
+      in_number = false;
+    }
+    hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+  }
+  return hash;
+}
+
+void replace_percent_codes(std::string &text, const PercentValues &values) {
+  if (text.find('%') == std::string::npos) return;
+  Zeal::String::replace(text, "%mana", values.mana + "%");
+  Zeal::String::replace(text, "%n", values.mana + "%");
+  Zeal::String::replace(text, "%hp", values.hp + "%");
+  Zeal::String::replace(text, "%h", values.hp + "%");
+  Zeal::String::replace(text, "%loc", values.loc);
+  Zeal::String::replace(text, "%targethp", values.target_hp + "%");
+  Zeal::String::replace(text, "%th", values.target_hp + "%");
+}
+
+}  // namespace ChatText
+}  // namespace Zeal
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+// The text transforms of the chat pipeline. They take the game state they need (own name, player
+// class colors, label values) as arguments, so the chat replay tests and benchmark (Zeal/tests) run
+// the same code as the game hooks in chat.cpp.
+namespace Zeal {
+namespace ChatText {
+
+// Writes the abbreviated form of a chat or roll message ("[G] [Name]: text") to out and returns
+// true. Returns false (with out untouched) if the message is passed through unchanged. A suppressed
+// message (the first line of a roll) returns an empty out and saves the roller in player_rolling
+// for the result line. A "You" sender is replaced with self_name unless it is empty.
+bool abbreviate(std::string_view message, std::string_view self_name, std::string &player_rolling,
+                std::string &out);
+
+// Returns the ARGB class color of a capitalized candidate name (e.g. "Soandso") or 0 for none.
+using ClassColorLookup = std::function<uint32_t(const std::string &name)>;
+
+// Writes the message with class color tags around the names that get_color knows to result. Returns
+// false (with result unspecified) if no names were colored so the caller can keep the original.
+bool add_class_colors(const std::string &message, const ClassColorLookup &get_color, std::string &result);
+
+// Shortens text to at most max_length characters (but never less than the "..." it ends with)
+// without splitting an STML tag or an item link and closes a color tag that the cut leaves open.
+// Returns false if it already fit.
+bool truncate_stml(std::string &text, size_t max_length);
+
+// FNV-1a hash of the message. With ignore_numbers each run of digits hashes like a single '#', so
+// lines that only differ in damage amounts or counts match.
+uint32_t get_coalesce_hash(std::string_view text, bool ignore_numbers);
+
+// Label values for the %-codes of outgoing chat. The percentages get a '%' appended when replaced.
+struct PercentValues {
+  std::string mana;       // %mana, %n
+  std::string hp;         // %hp, %h
+  std::string loc;        // %loc
+  std::string target_hp;  // %targethp, %th
+};
+
+// Replaces the %-codes in text. Text without a '%' is returned untouched.
+void replace_percent_codes(std::string &text, const PercentValues &values);
+
+}  // namespace ChatText
+}  // namespace Zeal
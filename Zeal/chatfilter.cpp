@@ -1,5 +1,6 @@
 #include "chatfilter.h"
 
+#include <algorithm>
 #include <array>
 #include <string_view>
 
@@ -18,12 +19,10 @@
 #define FILTER_OFFSET 0x64
 
 bool chatfilter::isExtendedCM(int channelMap, int applyOffset) {
-  for (auto &ec : Extended_ChannelMaps) {
-    if ((channelMap + applyOffset) == ec.channelMap) {
-      return true;
-    }
-  }
-  return false;
+  // The extended maps are numbered consecutively from 0x10000, so the id maps directly to the index.
+  const int index = channelMap + applyOffset - 0x10000;
+  return index >= 0 && index < static_cast<int>(Extended_ChannelMaps.size()) &&
+         Extended_ChannelMaps[index].channelMap == channelMap + applyOffset;
 }
 
 bool chatfilter::isStandardCM(int channelMap, int applyOffset) {
@@ -217,10 +216,16 @@ void chatfilter::callback_clean_ui() {
   isDamage = false;
 }
 
+// Each filter's dispatch rule is folded into per-channel bitmasks so a message only runs the filters
+// that can handle it (in the original list order, so later filters still take precedence).
 void chatfilter::AddOutputText(Zeal::GameUI::ChatWnd *&wnd, std::string &msg, short &channel) {
-  for (auto &filter : Extended_ChannelMaps) {
-    if (filter.isHandled(channel, msg)) wnd = filter.windowHandle;
-  }
+  filter_masks.dispatch(channel, isDamage, [&](size_t index) {
+    auto &filter = Extended_ChannelMaps[index];
+    const bool handled = filter.isHandled ? filter.isHandled(channel, msg)
+                                          : std::find(filter.channels.begin(), filter.channels.end(), channel) !=
+                                                filter.channels.end();
+    if (handled) wnd = filter.windowHandle;
+  });
 }
 
 void __fastcall whoGlobalPrintChat_wrapped(int t, int unused, const char *data) {
@@ -323,7 +328,7 @@ static bool is_from_me(const char *data) {
 
 // Returns true if the id is from an "item speech" string.
 static bool is_item_speech(int current_string_id) {
-  static constexpr std::array<int, 10> item_speech_strings = {{
+  static constexpr std::array<int, 10> item_speech_strings = {{  // Sorted for binary_search.
       422,   // Your %1 begins to glow.
       1230,  // Your %1 flickers with a pale light.
       1231,  // Your %1 pulses with light as your vision sharpens.
@@ -336,16 +341,13 @@ static bool is_item_speech(int current_string_id) {
       1238,  // Your %1 begins to shine.
   }};
 
-  for (const int &i : item_speech_strings) {
-    if (current_string_id == i) return true;
-  }
-  return false;
+  return std::binary_search(item_speech_strings.begin(), item_speech_strings.end(), current_string_id);
 }
 
 enum class PetSpeech { NotPet, MyPetSay, OtherPetSay };
 
 static PetSpeech is_pet_speech(int string_id, short color_index, const char *data) {
-  static const std::array<int, 5> my_pet_string_ids{
+  static constexpr std::array<int, 5> my_pet_string_ids{  // Sorted for binary_search.
       438,  // Taunting attacker, Master.
       489,  // No longer taunting attackers, Master.
       490,  // Taunting attackers as normal, Master.
@@ -380,9 +382,7 @@ static PetSpeech is_pet_speech(int string_id, short color_index, const char *dat
     return PetSpeech::NotPet;  // Do not route to keep with buffs on Chat::White.
 
   // Next check the explicit string IDs that only come from "my pet".
-  for (const int &i : my_pet_string_ids) {
-    if (string_id == i) return PetSpeech::MyPetSay;
-  }
+  if (std::binary_search(my_pet_string_ids.begin(), my_pet_string_ids.end(), string_id)) return PetSpeech::MyPetSay;
 
   // Then check for pet name matches to see if it is ours.
   //  Most pet sayings use StringID::GENERIC_STRINGID_SAY = 554: %1 says '%T2'
@@ -390,11 +390,10 @@ static PetSpeech is_pet_speech(int string_id, short color_index, const char *dat
 
   // We have a %T2 pet message. Now sort out if the %1 is equal to the client's pet name.
   const char *pet_name = Zeal::Game::strip_name(pet->Name);
-  std::string message = std::string(data);
+  std::string_view message = std::string_view(data);
   size_t end_of_name_space = message.find(" says");
-  if (end_of_name_space == std::string::npos) return PetSpeech::NotPet;
-  auto name = message.substr(0, end_of_name_space);
-  return strcmp(name.c_str(), pet_name) ? PetSpeech::OtherPetSay : PetSpeech::MyPetSay;
+  if (end_of_name_space == std::string_view::npos) return PetSpeech::NotPet;
+  return (message.substr(0, end_of_name_space) != pet_name) ? PetSpeech::OtherPetSay : PetSpeech::MyPetSay;
 }
 
 void __fastcall serverPrintChat(int t, int unused, const char *data, short color_index, bool u) {
@@ -491,18 +490,12 @@ chatfilter::chatfilter(ZealService *zeal) {
 
   zeal->callbacks->AddGeneric([this]() { isDamage = false; }, callback_type::ReportSuccessfulHitPost);
 
+  Extended_ChannelMaps.push_back(CustomFilter("Random", 0x10000, {USERCOLOR_RANDOM}));
+  Extended_ChannelMaps.push_back(CustomFilter("Loot", 0x10001, {USERCOLOR_LOOT}));
+  Extended_ChannelMaps.push_back(CustomFilter("Money", 0x10002, {USERCOLOR_MONEY_SPLIT, USERCOLOR_ECHO_AUTOSPLIT}));
+  Extended_ChannelMaps.push_back(CustomFilter("My Pet Say", 0x10003, {CHANNEL_MYPETSAY}));
   Extended_ChannelMaps.push_back(CustomFilter(
-      "Random", 0x10000, [this](short &color, const std::string &data) { return color == USERCOLOR_RANDOM; }));
-  Extended_ChannelMaps.push_back(
-      CustomFilter("Loot", 0x10001, [this](short &color, const std::string &data) { return color == USERCOLOR_LOOT; }));
-  Extended_ChannelMaps.push_back(CustomFilter("Money", 0x10002, [this](short &color, const std::string &data) {
-    return color == USERCOLOR_MONEY_SPLIT || color == USERCOLOR_ECHO_AUTOSPLIT;
-  }));
-  Extended_ChannelMaps.push_back(
-      CustomFilter("My Pet Say", 0x10003,
-                   [this, zeal](short &color, const std::string &data) { return color == CHANNEL_MYPETSAY; }));
-  Extended_ChannelMaps.push_back(
-      CustomFilter("My Pet Damage", 0x10004, [this, zeal](short &color, const std::string &data) {
+      "My Pet Damage", 0x10004, CustomFilter::Dispatch::Damage, [this, zeal](short &color, const std::string &data) {
         if (isDamage && damageData.source && damageData.source->PetOwnerSpawnId &&
             damageData.source->PetOwnerSpawnId == Zeal::Game::get_self()->SpawnId) {
           color = CHANNEL_MYPETDMG;
@@ -515,11 +508,9 @@ chatfilter::chatfilter(ZealService *zeal) {
         }
         return false;
       }));
-  Extended_ChannelMaps.push_back(
-      CustomFilter("Other Pet Say", 0x10005,
-                   [this, zeal](short &color, const std::string &data) { return color == CHANNEL_OTHERPETSAY; }));
-  Extended_ChannelMaps.push_back(
-      CustomFilter("Other Pet Damage", 0x10006, [this, zeal](short &color, const std::string &data) {
+  Extended_ChannelMaps.push_back(CustomFilter("Other Pet Say", 0x10005, {CHANNEL_OTHERPETSAY}));
+  Extended_ChannelMaps.push_back(CustomFilter(
+      "Other Pet Damage", 0x10006, CustomFilter::Dispatch::Damage, [this, zeal](short &color, const std::string &data) {
         if (isDamage && damageData.target == Zeal::Game::get_self()) return false;  // Don't re-route damage to self.
         if (isDamage && damageData.source && damageData.source->PetOwnerSpawnId &&
             damageData.source->PetOwnerSpawnId != Zeal::Game::get_self()->SpawnId) {
@@ -533,27 +524,16 @@ chatfilter::chatfilter(ZealService *zeal) {
         }
         return false;
       }));
-  Extended_ChannelMaps.push_back(CustomFilter(
-      "/who", 0x10007, [this, zeal](short &color, const std::string &data) { return color == USERCOLOR_WHO; }));
-  Extended_ChannelMaps.push_back(
-      CustomFilter("My Melee Special", 0x10008,
-                   [this, zeal](short &color, const std::string &data) { return color == CHANNEL_MYMELEESPECIAL; }));
-  Extended_ChannelMaps.push_back(
-      CustomFilter("Other Melee Special", 0x10009,
-                   [this, zeal](short &color, const std::string &data) { return color == CHANNEL_OTHERMELEESPECIAL; }));
-  Extended_ChannelMaps.push_back(CustomFilter(
-      "/mystats", 0x1000A, [this, zeal](short &color, const std::string &data) { return color == CHANNEL_MYSTATS; }));
-  Extended_ChannelMaps.push_back(
-      CustomFilter("Item Speech", 0x1000B,
-                   [this, zeal](short &color, const std::string &data) { return color == CHANNEL_ITEMSPEECH; }));
-  Extended_ChannelMaps.push_back(
-      CustomFilter("Other Melee Critical", 0x1000C,
-                   [this, zeal](short &color, const std::string &data) { return color == CHANNEL_OTHER_MELEE_CRIT; }));
-  Extended_ChannelMaps.push_back(CustomFilter(
-      "Other Damage Shield", 0x1000D,
-      [this, zeal](short &color, const std::string &data) { return color == CHANNEL_OTHER_DAMAGE_SHIELD; }));
+  Extended_ChannelMaps.push_back(CustomFilter("/who", 0x10007, {USERCOLOR_WHO}));
+  Extended_ChannelMaps.push_back(CustomFilter("My Melee Special", 0x10008, {CHANNEL_MYMELEESPECIAL}));
+  Extended_ChannelMaps.push_back(CustomFilter("Other Melee Special", 0x10009, {CHANNEL_OTHERMELEESPECIAL}));
+  Extended_ChannelMaps.push_back(CustomFilter("/mystats", 0x1000A, {CHANNEL_MYSTATS}));
+  Extended_ChannelMaps.push_back(CustomFilter("Item Speech", 0x1000B, {CHANNEL_ITEMSPEECH}));
+  Extended_ChannelMaps.push_back(CustomFilter("Other Melee Critical", 0x1000C, {CHANNEL_OTHER_MELEE_CRIT}));
+  Extended_ChannelMaps.push_back(CustomFilter("Other Damage Shield", 0x1000D, {CHANNEL_OTHER_DAMAGE_SHIELD}));
   Extended_ChannelMaps.push_back(CustomFilter(
       "Zeal Spam", 0x1000E, [this](short &color, std::string &data) { return HandleZealSpamCallbacks(color, data); }));
+  filter_masks.build(Extended_ChannelMaps);
 
   // Callbacks
   zeal->callbacks->AddOutputText([this](Zeal::GameUI::ChatWnd *&wnd, std::string &msg, short &channel) {
@@ -1,6 +1,8 @@
 #pragma once
 #include <functional>
+#include <vector>
 
+#include "chat_filter_masks.h"
 #include "game_ui.h"
 #include "zeal_settings.h"
 
@@ -17,18 +19,35 @@
 #define CHANNEL_ZEAL_SPAM 1010
 
 struct CustomFilter {
+  using Dispatch = ChatFilterDispatch;
+
   std::string name;                     // String name - Appears in the Menu
   int channelMap;                       // Extended Channel Map ID - Zeal developer set
   Zeal::GameUI::ChatWnd *windowHandle;  // Window Handle - Maintains the currently filtered Chat Window handle
-  std::function<bool(short &, std::string &)> isHandled;
+  Dispatch dispatch;
+  std::vector<short> channels;  // Channel ids handled by a Dispatch::Channels filter.
+  std::function<bool(short &, std::string &)> isHandled;  // Optional for Dispatch::Channels filters.
 
   // Default Constructor
-  CustomFilter() : name(""), channelMap(0), windowHandle(nullptr), isHandled(nullptr) {
+  CustomFilter()
+      : name(""), channelMap(0), windowHandle(nullptr), dispatch(Dispatch::Always), isHandled(nullptr) {
     // Optionally, add default lambda for isHandled
   }
 
   CustomFilter(const std::string &name, int channelMap, std::function<bool(short &, std::string &)> isHandled)
-      : name(name), channelMap(channelMap), isHandled(isHandled) {}
+      : name(name), channelMap(channelMap), windowHandle(nullptr), dispatch(Dispatch::Always), isHandled(isHandled) {}
+
+  CustomFilter(const std::string &name, int channelMap, std::vector<short> channels)
+      : name(name),
+        channelMap(channelMap),
+        windowHandle(nullptr),
+        dispatch(Dispatch::Channels),
+        channels(std::move(channels)),
+        isHandled(nullptr) {}
+
+  CustomFilter(const std::string &name, int channelMap, Dispatch dispatch,
+               std::function<bool(short &, std::string &)> isHandled)
+      : name(name), channelMap(channelMap), windowHandle(nullptr), dispatch(dispatch), isHandled(isHandled) {}
 
   ~CustomFilter() {}
 };
@@ -77,4 +96,6 @@ class chatfilter {
 
  private:
   std::vector<std::function<bool(short &channel, std::string &msg)>> zeal_spam_callbacks;
+
+  ChatFilterMasks filter_masks;  // Built from Extended_ChannelMaps once the filters are registered.
 };
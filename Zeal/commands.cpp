@@ -1,6 +1,8 @@
 #include "commands.h"
 
+#include <algorithm>
 #include <sstream>
+#include <string_view>
 
 // Do not add additional headers to this list. Add those commands in zeal.cpp.
 #include "game_addresses.h"
@@ -76,29 +78,14 @@ void __fastcall InterpretCommand(int c, int unused, Zeal::GameStructures::Entity
     if (index >= 0) *reinterpret_cast<BYTE *>(0x0079856c) = 1;
   }
 
-  std::vector<std::string> args = Zeal::String::split(str_cmd, " ");
-  const std::string &cmd_name = args.front();
-  if (!args.empty() && !cmd_name.empty() && Zeal::Game::is_in_game()) {
-    bool cmd_handled = false;
-    auto &command_functions = zeal->commands_hook->CommandFunctions;
-    if (command_functions.count(cmd_name)) {
-      cmd_handled = command_functions[args[0]].callback(args);
-    } else {
-      // attempt to find and call the function via an alias
-      for (const auto &command_pair : command_functions) {
-        const auto &command = command_pair.second;
-        if (command.callback && !command.aliases.empty()) {
-          for (const auto alias : command.aliases) {
-            if (!alias.empty() && alias == cmd_name) {
-              cmd_handled = command.callback(args);
-              break;
-            }
-          }
-        }
-      }
-    }
-    if (cmd_handled) {
-      return;
+  // Split into views first so plain chat lines and client commands don't allocate an argument list.
+  std::vector<std::string_view> &tokens = zeal->commands_hook->command_tokens;
+  Zeal::String::split(str_cmd, " ", tokens);
+  if (!tokens.empty() && !tokens.front().empty() && Zeal::Game::is_in_game()) {
+    const ZealCommand *command = zeal->commands_hook->find(tokens.front());
+    if (command && command->callback) {
+      std::vector<std::string> args(tokens.begin(), tokens.end());
+      if (command->callback(args)) return;
     }
   }
   zeal->hooks->hook_map["commands"]->original(InterpretCommand)(c, unused, player, cmd);
@@ -106,11 +93,41 @@ void __fastcall InterpretCommand(int c, int unused, Zeal::GameStructures::Entity
 
 void ChatCommands::Add(std::string cmd, std::vector<std::string> aliases, std::string description,
                        std::function<bool(std::vector<std::string> &args)> callback) {
-  CommandFunctions[cmd] = ZealCommand(aliases, description, callback);
+  ZealCommand &command = CommandFunctions[cmd];
+
+  // A re-added command drops the aliases it held so the replaced ones stop resolving to it.
+  for (const auto &alias : command.aliases) {
+    auto it = command_index.find(get_index_key(alias));
+    if (it != command_index.end() && it->second == &command) command_index.erase(it);
+  }
+  command = ZealCommand(aliases, description, callback);
+
+  // Names take precedence over aliases, and the first command registering an alias keeps it.
+  command_index[get_index_key(cmd)] = &command;
+  for (const auto &alias : command.aliases)
+    if (!alias.empty()) command_index.try_emplace(get_index_key(alias), &command);
+}
+
+std::string ChatCommands::get_index_key(std::string_view name) {
+  std::string key(name);
+  if constexpr (kFoldCase)
+    for (char &c : key)
+      if (c >= 'A' && c <= 'Z') c = static_cast<char>(c + ('a' - 'A'));
+  return key;
+}
+
+const ZealCommand *ChatCommands::find(std::string_view name) const {
+  auto it = command_index.find(get_index_key(name));
+  return (it != command_index.end()) ? it->second : nullptr;
 }
 
 ChatCommands::~ChatCommands() {}
 
+void ChatCommands::execute(const std::string &cmd) const {
+  if (!Zeal::Game::is_in_game() || !Zeal::Game::get_self()) return;
+  InterpretCommand((int)Zeal::Game::get_game(), 0, Zeal::Game::get_self(), cmd.c_str());
+}
+
 // call interpret command without hitting the detour, useful for aliasing default commands
 void ForwardCommand(std::string cmd) {
   ZealService::get_instance()->hooks->hook_map["commands"]->original(InterpretCommand)(
@@ -1,6 +1,7 @@
 #pragma once
 #include <functional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -28,10 +29,29 @@ class ChatCommands {
 
   bool handle_chat(std::string &str_cmd) const;  // Updates str with a tell target if needed.
 
+  // Executes the command line as if it was typed (Zeal commands first, then the client).
+  void execute(const std::string &cmd) const;
+
   ChatCommands(class ZealService *zeal);
   ~ChatCommands();
   void Add(std::string cmd, std::vector<std::string> aliases, std::string description,
            std::function<bool(std::vector<std::string> &args)> callback);
+
+  // Returns the command registered with the name or alias (nullptr if none) with a single hash lookup.
+  const ZealCommand *find(std::string_view name) const;
+
   std::unordered_map<std::string, ZealCommand> CommandFunctions;
   std::function<std::string()> tell_callback;
+
+  // Reused by the InterpretCommand hook to split each typed line (game thread only). The tokens are
+  // copied to the args before a command callback runs, so a nested execute() may overwrite them.
+  std::vector<std::string_view> command_tokens;
+
+ private:
+  static constexpr bool kFoldCase = true;  // Match typed commands regardless of (ASCII) case like the client.
+
+  static std::string get_index_key(std::string_view name);
+
+  // Names and aliases to their CommandFunctions entry (node based, so the pointers stay valid).
+  std::unordered_map<std::string, ZealCommand *> command_index;
 };
@@ -1,10 +1,18 @@
 #include "entity_manager.h"
 
+#include <algorithm>
+
 #include "callbacks.h"
 #include "game_addresses.h"
 #include "game_functions.h"
 #include "zeal.h"
 
+static std::string to_lower(const char *name) {
+  std::string result(name);
+  std::transform(result.begin(), result.end(), result.begin(), ::tolower);
+  return result;
+}
+
 void EntityManager::Add(struct Zeal::GameStructures::Entity *ent) {
   // Perform simple validity checks before adding an entity.
   // Notes:
@@ -16,12 +24,19 @@ void EntityManager::Add(struct Zeal::GameStructures::Entity *ent) {
   // the entity manager map's count will be reduced relative to the IDArray count.
   if (!ent) return;
   if (ent->SpawnId == 0 || ent == Zeal::Game::get_entity_by_id(ent->SpawnId)) entity_map[ent->Name] = ent;
+
+  // The name index keeps every spawn (the entity type may not be final yet) and filters at lookup.
+  NameIndexEntry entry = {to_lower(ent->Name), ent->Name, ent};
+  auto it = std::upper_bound(name_index.begin(), name_index.end(), entry.key,
+                             [](const std::string &key, const NameIndexEntry &e) { return key < e.key; });
+  name_index.insert(it, std::move(entry));
 }
 
 void EntityManager::Remove(struct Zeal::GameStructures::Entity *ent) {
   // The game renames the ent->Name field (like _corpse0 suffix), so
   // ent->Name is not a reliable key to locate the hash entity to remove.
   // Removes are infrequent operations, so we can afford a linear search.
+  std::erase_if(name_index, [ent](const NameIndexEntry &entry) { return entry.entity == ent; });
   for (auto it = entity_map.begin(); it != entity_map.end(); ++it) {
     if (it->second == ent) {
       entity_map.erase(it);  // Ignoring updated iterator.
@@ -48,12 +63,17 @@ Zeal::GameStructures::Entity *EntityManager::Get(WORD id) const {
 
 std::vector<std::string> EntityManager::GetPlayerPartialMatches(const std::string &start_of_name) const {
   std::vector<std::string> result;
-  Zeal::GameStructures::Entity *current_ent = Zeal::Game::get_entity_list();
-  while (current_ent != nullptr) {
-    if (current_ent->Type == Zeal::GameEnums::Player &&
-        _strnicmp(current_ent->Name, start_of_name.c_str(), start_of_name.length()) == 0)
-      result.push_back(current_ent->Name);
-    current_ent = current_ent->Next;
+  if (!Zeal::Game::is_in_game()) return result;
+
+  // Walk the sorted range of names that start with the prefix and keep the live players.
+  const std::string prefix = to_lower(start_of_name.c_str());
+  auto it = std::lower_bound(name_index.begin(), name_index.end(), prefix,
+                             [](const NameIndexEntry &e, const std::string &key) { return e.key < key; });
+  for (; it != name_index.end() && it->key.starts_with(prefix); ++it) {
+    const auto *entity = it->entity;
+    if (entity == Zeal::Game::get_entity_by_id(entity->SpawnId) && entity->Type == Zeal::GameEnums::Player &&
+        it->name == entity->Name)
+      result.push_back(it->name);
   }
   return result;
 }
@@ -15,9 +15,17 @@ class EntityManager {
   void Remove(struct Zeal::GameStructures::Entity *);
   Zeal::GameStructures::Entity *Get(std::string name) const;  // Returns nullptr if not found.
   Zeal::GameStructures::Entity *Get(WORD id) const;           // Note: Equivalent to Game::get_entity_by_id()
+  // Returns the names of zone players that start with start_of_name (case insensitive).
   std::vector<std::string> GetPlayerPartialMatches(const std::string &start_of_name) const;
   void Dump() const;
 
  private:
+  struct NameIndexEntry {
+    std::string key;   // Lower case name used for the sort order.
+    std::string name;  // Name at spawn time (the client renames corpses).
+    struct Zeal::GameStructures::Entity *entity;
+  };
+
   std::unordered_map<std::string, struct Zeal::GameStructures::Entity *> entity_map;
+  std::vector<NameIndexEntry> name_index;  // Sorted by key so prefix matches are a range lookup.
 };
@@ -0,0 +1,172 @@
+#include "font_atlas.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <numeric>
+
+#include "directx.h"
+#include "game_functions.h"
+
+static uint32_t round_up_to_block(uint32_t value) {
+  return (value + FontAtlas::kBlockSize - 1) / FontAtlas::kBlockSize * FontAtlas::kBlockSize;
+}
+
+// Places the sizes in order on left to right shelves of the given width and returns the packed height
+// (zero if a size is wider than the shelf).
+static uint32_t pack_shelves(std::span<const FontAtlas::Size> sizes, std::span<const size_t> order, uint32_t width,
+                             std::span<FontAtlas::Point> positions) {
+  uint32_t x = 0;
+  uint32_t y = 0;
+  uint32_t shelf_height = 0;
+  for (size_t index : order) {
+    const uint32_t sheet_width = round_up_to_block(sizes[index].width);
+    const uint32_t sheet_height = round_up_to_block(sizes[index].height);
+    if (sheet_width > width) return 0;
+    if (x + sheet_width > width) {
+      y += shelf_height + FontAtlas::kGutter;
+      x = 0;
+      shelf_height = 0;
+    }
+    positions[index] = {x, y};
+    x += sheet_width + FontAtlas::kGutter;
+    shelf_height = std::max(shelf_height, sheet_height);
+  }
+  return y + shelf_height;
+}
+
+FontAtlas::Size FontAtlas::pack(std::span<const Size> sizes, std::span<Point> positions) {
+  if (sizes.empty() || positions.size() < sizes.size()) return {0, 0};
+
+  // Tallest first keeps the shelves full. Widest breaks ties so the order is deterministic.
+  std::vector<size_t> order(sizes.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [sizes](size_t a, size_t b) {
+    if (sizes[a].height != sizes[b].height) return sizes[a].height > sizes[b].height;
+    return sizes[a].width > sizes[b].width;
+  });
+
+  // Try every power of two width and keep the smallest area (then the squarest) atlas.
+  uint32_t max_width = 0;
+  for (const auto &size : sizes) max_width = std::max(max_width, size.width);
+  Size best = {0, 0};
+  for (uint32_t width = std::bit_ceil(std::max(max_width, kBlockSize)); width <= kMaxSize; width *= 2) {
+    const uint32_t packed_height = pack_shelves(sizes, order, width, positions);
+    if (!packed_height || packed_height > kMaxSize) continue;
+    const uint32_t height = std::bit_ceil(packed_height);
+    const uint64_t area = uint64_t(width) * height;
+    const uint64_t best_area = uint64_t(best.width) * best.height;
+    if (!best_area || area < best_area ||
+        (area == best_area && std::max(width, height) < std::max(best.width, best.height)))
+      best = {width, height};
+  }
+  if (best.width) pack_shelves(sizes, order, best.width, positions);
+  return best;
+}
+
+std::shared_ptr<FontAtlas> FontAtlas::get_shared(IDirect3DDevice8 &device) {
+  static std::weak_ptr<FontAtlas> shared_atlas;  // Fonts own it, so it goes away with them (and the device).
+  auto atlas = shared_atlas.lock();
+  if (!atlas || &atlas->device != &device) {
+    atlas = std::make_shared<FontAtlas>(device);
+    shared_atlas = atlas;
+  }
+  return atlas;
+}
+
+FontAtlas::~FontAtlas() {
+  if (texture) texture->Release();
+  texture = nullptr;
+}
+
+int FontAtlas::add_sheet(uint32_t width, uint32_t height, uint32_t stride, uint32_t rows, const uint8_t *data) {
+  // The block copies assume tightly described DXT2 data (4 * rows = height and a full row in stride).
+  const uint32_t row_bytes = (width + kBlockSize - 1) / kBlockSize * kBlockBytes;
+  if (!width || rows * kBlockSize != height || stride < row_bytes || width > kMaxSize || height >= kMaxSize) {
+    Zeal::Game::print_chat("Font atlas: Unsupported sheet: w: %i, h: %i, stride: %i, rows: %i", width, height, stride,
+                           rows);
+    return -1;
+  }
+
+  Sheet sheet = {.size = {round_up_to_block(width), height + kBlockSize},
+                 .blocks = std::vector<uint8_t>(size_t(row_bytes) * (rows + 1))};
+  for (uint32_t y = 0; y < rows; ++y) memcpy(&sheet.blocks[y * row_bytes], &data[y * stride], row_bytes);
+  memset(&sheet.blocks[rows * row_bytes], 0xff, kBlockBytes);  // Solid block for the stats bars.
+  sheets.push_back(std::move(sheet));
+  dirty = true;
+  return static_cast<int>(sheets.size()) - 1;
+}
+
+void FontAtlas::remove_sheet(int id) {
+  if (id < 0 || id >= static_cast<int>(sheets.size())) return;
+  sheets[id].active = false;
+  sheets[id].blocks = {};
+}
+
+int FontAtlas::get_sheet_count() const {
+  return static_cast<int>(std::count_if(sheets.begin(), sheets.end(), [](const Sheet &sheet) { return sheet.active; }));
+}
+
+IDirect3DTexture8 *FontAtlas::get_texture() {
+  if (dirty) {
+    dirty = false;
+    if (!create_texture()) {
+      if (texture) texture->Release();
+      texture = nullptr;
+    }
+  }
+  return texture;
+}
+
+// Repacks the active sheets and uploads them to a new texture.
+bool FontAtlas::create_texture() {
+  std::vector<Size> sizes;
+  std::vector<int> ids;
+  for (int id = 0; id < static_cast<int>(sheets.size()); ++id) {
+    if (!sheets[id].active) continue;
+    sizes.push_back(sheets[id].size);
+    ids.push_back(id);
+  }
+  std::vector<Point> positions(sizes.size());
+  const Size atlas_size = pack(sizes, positions);
+  if (!atlas_size.width) {
+    Zeal::Game::print_chat("Font atlas: Unable to pack %i font sheets", sizes.size());
+    return false;
+  }
+
+  if (texture) texture->Release();
+  texture = nullptr;
+  const DWORD usage = 0;  // Not a render target or dynamic.
+  auto hresult = D3DXCreateTexture(&device, atlas_size.width, atlas_size.height, 1, usage, D3DFMT_DXT2,
+                                   D3DPOOL_MANAGED, &texture);
+  if (FAILED(hresult)) {
+    Zeal::Game::print_chat("Font atlas texture failure: w: %i, h: %i, code: 0x%08x", atlas_size.width,
+                           atlas_size.height, hresult);
+    texture = nullptr;  // Ensure it is nulled.
+    return false;
+  }
+
+  const int row_bytes = atlas_size.width / kBlockSize * kBlockBytes;
+  D3DLOCKED_RECT locked_rect;
+  if (FAILED(texture->LockRect(0, &locked_rect, NULL, D3DLOCK_DISCARD)) || locked_rect.Pitch < row_bytes) {
+    Zeal::Game::print_chat("Font atlas texture: Lock failed");
+    return false;
+  }
+
+  // All zero blocks are fully transparent, which also fills the gutters and the unused space.
+  uint8_t *texture_data = reinterpret_cast<uint8_t *>(locked_rect.pBits);
+  memset(texture_data, 0, size_t(locked_rect.Pitch) * (atlas_size.height / kBlockSize));
+  for (size_t i = 0; i < ids.size(); ++i) {
+    Sheet &sheet = sheets[ids[i]];
+    sheet.origin = positions[i];
+    const size_t sheet_row_bytes = sheet.size.width / kBlockSize * kBlockBytes;
+    const size_t first_row = sheet.origin.y / kBlockSize;
+    const size_t first_block = sheet.origin.x / kBlockSize * kBlockBytes;
+    for (size_t y = 0; y < sheet.size.height / kBlockSize; ++y)
+      memcpy(&texture_data[(first_row + y) * locked_rect.Pitch + first_block], &sheet.blocks[y * sheet_row_bytes],
+             sheet_row_bytes);
+  }
+  texture->UnlockRect(0);
+  size = atlas_size;
+  return true;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+struct IDirect3DDevice8;
+struct IDirect3DTexture8;
+
+// Shared texture holding the glyph sheets of every loaded font so the map labels, nameplates,
+// floating damage and raid bars all sample the same texture and their flushes don't switch textures.
+// Sheets are 4x4 block compressed (DXT2) and are copied block by block into the atlas, which is
+// repacked when sheets are added. Fonts map their sheet relative glyph rects into the atlas with
+// get_origin() and get_size() at render time since a repack can move (and resize) everything.
+//
+// The packing (pack()) has no D3D dependencies. font_atlas_test (Zeal/tests) covers it and the sheet uploads.
+class FontAtlas {
+ public:
+  struct Size {
+    uint32_t width;
+    uint32_t height;
+  };
+
+  struct Point {
+    uint32_t x;
+    uint32_t y;
+  };
+
+  static constexpr uint32_t kBlockSize = 4;        // DXT2 block dimensions in pixels.
+  static constexpr uint32_t kBlockBytes = 16;      // DXT2 bytes per block.
+  static constexpr uint32_t kGutter = kBlockSize;  // Transparent gap between sheets for linear filtering.
+  static constexpr uint32_t kMaxSize = 4096;
+
+  // Shelf packs the sheet sizes (tallest first) into the smallest power of two atlas with the
+  // positions (one per size) aligned to blocks and kGutter apart. Returns {0, 0} if they don't fit.
+  static Size pack(std::span<const Size> sizes, std::span<Point> positions);
+
+  // Returns the atlas shared by the fonts of the device. It is created on demand and released with
+  // the last font holding it.
+  static std::shared_ptr<FontAtlas> get_shared(IDirect3DDevice8 &device);
+
+  explicit FontAtlas(IDirect3DDevice8 &device) : device(device) {}
+  ~FontAtlas();
+
+  // Disable copy.
+  FontAtlas(FontAtlas const &) = delete;
+  FontAtlas &operator=(FontAtlas const &) = delete;
+
+  // Adds a copy of a DXT2 sheet (rows of blocks, stride bytes apart) with a solid white block row
+  // appended below it at (0, height) for the stats bars. Returns the sheet id or -1 if unsupported.
+  int add_sheet(uint32_t width, uint32_t height, uint32_t stride, uint32_t rows, const uint8_t *data);
+  void remove_sheet(int id);  // The space is reclaimed on the next repack.
+
+  // Returns the atlas texture (not add ref'd), repacking it first if needed. Nullptr on failure.
+  IDirect3DTexture8 *get_texture();
+
+  Point get_origin(int id) const { return sheets[id].origin; }  // Upper left of the sheet in the atlas.
+  Size get_size() const { return size; }
+  int get_sheet_count() const;
+
+ private:
+  struct Sheet {
+    Size size;                    // Including the solid block row.
+    std::vector<uint8_t> blocks;  // Packed block rows (size.width / 4 blocks each).
+    Point origin = {};
+    bool active = true;
+  };
+
+  bool create_texture();
+
+  IDirect3DDevice8 &device;
+  IDirect3DTexture8 *texture = nullptr;
+  Size size = {};
+  std::vector<Sheet> sheets;  // Indexed by id. Removed sheets stay as inactive entries.
+  bool dirty = false;
+};
@@ -0,0 +1,256 @@
+#define NOMINMAX
+#include "item_search.h"
+
+#include <algorithm>
+#include <cctype>
+
+#include "commands.h"
+#include "game_functions.h"
+#include "items.h"
+#include "string_util.h"
+#include "zeal.h"
+
+// Trigrams are indexed over a folded alphabet: letters (case insensitive), digits and one code for
+// everything else (spaces and punctuation).
+static constexpr int kTrigramAlphabet = 38;
+static constexpr int kNumTrigrams = kTrigramAlphabet * kTrigramAlphabet * kTrigramAlphabet;
+static constexpr uint8_t kReported = 0xff;  // hit_counts value of a record already in the results.
+static constexpr int kMaxFuzzyCandidates = 2048;
+
+static int get_trigram_code(char c) {
+  unsigned char uc = static_cast<unsigned char>(c);
+  if (uc >= 'a' && uc <= 'z') return uc - 'a';
+  if (uc >= 'A' && uc <= 'Z') return uc - 'A';
+  if (uc >= '0' && uc <= '9') return 26 + uc - '0';
+  return 36 + (uc != ' ');
+}
+
+// Writes the distinct trigram keys of text to keys (sized >= text.size()) and returns the count.
+static size_t get_trigrams(std::string_view text, uint16_t *keys) {
+  size_t count = 0;
+  for (size_t i = 0; i + 2 < text.size(); ++i)
+    keys[count++] = static_cast<uint16_t>(
+        (get_trigram_code(text[i]) * kTrigramAlphabet + get_trigram_code(text[i + 1])) * kTrigramAlphabet +
+        get_trigram_code(text[i + 2]));
+  std::sort(keys, keys + count);
+  return std::unique(keys, keys + count) - keys;
+}
+
+static char fold_case(char c) { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c; }
+
+ItemSearch::ItemSearch(ZealService *zeal) {
+  zeal->commands_hook->Add("/itemsearch", {"/isearch"}, "Searches item names by prefix, substring or close spelling.",
+                           [this](std::vector<std::string> &args) { return handle_command(args); });
+  index_thread = std::thread([this]() {
+    build_index();
+    index_ready.store(true, std::memory_order_release);
+  });
+}
+
+ItemSearch::~ItemSearch() {
+  if (index_thread.joinable()) index_thread.join();
+}
+
+static bool is_word_start(std::string_view name, size_t offset) {
+  return !offset || (std::isalnum(static_cast<unsigned char>(name[offset])) &&
+                     !std::isalnum(static_cast<unsigned char>(name[offset - 1])));
+}
+
+// Copies the front coded names into a flat lower case table and builds the word start and trigram
+// indices. Runs on index_thread, which is the only user of the tables until index_ready is set.
+void ItemSearch::build_index() {
+  const size_t record_count = Zeal::Items::record_count;
+  offsets.reserve(record_count + 1);
+  for (Zeal::Items::NameReader reader; !reader.done(); reader.next()) {
+    offsets.push_back(static_cast<uint32_t>(names.size()));
+    for (char c : reader.name()) names.push_back(fold_case(c));
+    names.push_back('\0');
+  }
+  offsets.push_back(static_cast<uint32_t>(names.size()));
+
+  for (size_t index = 0; index < record_count; ++index) {
+    std::string_view name = get_folded_name(index);
+    for (size_t offset = 0; offset < name.size(); ++offset)
+      if (is_word_start(name, offset))
+        word_starts.push_back({static_cast<uint16_t>(index), static_cast<uint8_t>(offset)});
+  }
+  std::sort(word_starts.begin(), word_starts.end(),
+            [this](const WordStart &a, const WordStart &b) { return get_suffix(a) < get_suffix(b); });
+
+  // Two passes (count then fill) so the posting lists are packed into one array.
+  uint16_t keys[Zeal::Items::kMaxNameLength];
+  trigram_offsets.assign(kNumTrigrams + 1, 0);
+  for (size_t index = 0; index < record_count; ++index) {
+    size_t count = get_trigrams(get_folded_name(index), keys);
+    for (size_t i = 0; i < count; ++i) trigram_offsets[keys[i] + 1]++;
+  }
+  for (int i = 0; i < kNumTrigrams; ++i) trigram_offsets[i + 1] += trigram_offsets[i];
+  trigram_records.resize(trigram_offsets.back());
+  std::vector<uint32_t> fill(trigram_offsets.begin(), trigram_offsets.end() - 1);
+  for (size_t index = 0; index < record_count; ++index) {
+    size_t count = get_trigrams(get_folded_name(index), keys);
+    for (size_t i = 0; i < count; ++i) trigram_records[fill[keys[i]]++] = static_cast<uint16_t>(index);
+  }
+
+  hit_counts.assign(record_count, 0);
+  touched.reserve(record_count);  // Never grows past this, so queries do not allocate.
+}
+
+std::string_view ItemSearch::get_folded_name(size_t index) const {
+  return std::string_view(names.data() + offsets[index], offsets[index + 1] - offsets[index] - 1);
+}
+
+std::string_view ItemSearch::get_suffix(const WordStart &word) const {
+  return get_folded_name(word.record).substr(word.offset);
+}
+
+size_t ItemSearch::search(std::string_view query_text, std::span<Result> results) {
+  query_text = Zeal::String::trim(query_text);
+  if (query_text.empty() || query_text.size() > kMaxQueryLength || results.empty() || !is_ready()) return 0;
+
+  char query_buffer[kMaxQueryLength];
+  for (size_t i = 0; i < query_text.size(); ++i) query_buffer[i] = fold_case(query_text[i]);
+  const std::string_view query(query_buffer, query_text.size());
+  size_t count = 0;
+
+  // Exact, prefix and word prefix matches are a contiguous range of the sorted word starts. A name
+  // found at offset 0 is skipped at its other word starts and hit_counts marks the rest as reported.
+  auto is_less = [this](const WordStart &word, std::string_view text) { return get_suffix(word) < text; };
+  auto word = std::lower_bound(word_starts.begin(), word_starts.end(), query, is_less);
+  for (; word != word_starts.end() && get_suffix(*word).starts_with(query); ++word) {
+    const uint16_t record = word->record;
+    std::string_view name = get_folded_name(record);
+    if (word->offset && (hit_counts[record] || name.starts_with(query))) continue;
+    hit_counts[record] = kReported;
+    touched.push_back(record);
+    Match match = word->offset ? Match::WordPrefix : (name.size() == query.size()) ? Match::Exact : Match::Prefix;
+    add_result({record, Zeal::Items::values[record], match, 0}, results, count);
+  }
+
+  // The remaining (substring and fuzzy) matches rank below those, so skip them if the results are
+  // full. Queries shorter than a trigram only match word starts.
+  uint16_t keys[kMaxQueryLength];
+  const size_t key_count = get_trigrams(query, keys);
+  if (count < results.size() && key_count) {
+    for (size_t i = 0; i < key_count; ++i)
+      for (uint32_t j = trigram_offsets[keys[i]]; j < trigram_offsets[keys[i] + 1]; ++j) {
+        uint16_t record = trigram_records[j];
+        if (hit_counts[record] == kReported) continue;
+        if (!hit_counts[record]++) touched.push_back(record);
+      }
+    add_substring_matches(query, key_count, results, count);
+  }
+
+  for (uint16_t record : touched) hit_counts[record] = 0;
+  touched.clear();
+  return count;
+}
+
+// Adds the trigram candidates (hit_counts of touched records) that contain the query and then, if
+// there is still room, the ones within the typo limit. A name containing the query has all of its
+// trigrams and each typo removes at most three.
+void ItemSearch::add_substring_matches(std::string_view query, size_t key_count, std::span<Result> results,
+                                       size_t &count) {
+  for (uint16_t record : touched) {
+    if (hit_counts[record] != key_count) continue;
+    std::string_view name = get_folded_name(record);
+    if (name.find(query) == std::string_view::npos) continue;
+    hit_counts[record] = kReported;
+    add_result({record, Zeal::Items::values[record], Match::Substring, 0}, results, count);
+  }
+
+  // Allow a typo for medium queries and two for long ones, but keep at least one trigram that every
+  // candidate must share so the index can still filter.
+  const int typo_limit = (query.size() < 6) ? 0 : (query.size() < 10) ? 1 : 2;
+  const int max_edits = std::min(typo_limit, static_cast<int>(key_count - 1) / 3);
+  if (count == results.size() || !max_edits) return;
+
+  // Myers match vectors: bit i of pattern_masks[c] is set if query[i] == c.
+  std::fill(std::begin(pattern_masks), std::end(pattern_masks), 0);
+  for (size_t i = 0; i < query.size(); ++i) pattern_masks[static_cast<unsigned char>(query[i])] |= 1ull << i;
+  query_length = query.size();
+
+  // Common trigrams (like " of") can leave thousands of candidates, so score the ones sharing the
+  // most trigrams first and stop at a fixed budget to bound the query time.
+  const int threshold = static_cast<int>(key_count) - 3 * max_edits;
+  int budget = kMaxFuzzyCandidates;
+  for (int hits = static_cast<int>(key_count); hits >= threshold && budget > 0; --hits)
+    for (uint16_t record : touched) {
+      if (hit_counts[record] != hits) continue;
+      std::string_view name = get_folded_name(record);
+      if (name.size() + max_edits < query.size()) continue;
+      int edits = get_edit_distance(name);
+      if (edits <= max_edits)
+        add_result({record, Zeal::Items::values[record], Match::Fuzzy, static_cast<uint8_t>(edits)}, results, count);
+      if (--budget <= 0) break;
+    }
+}
+
+// Keeps results sorted best first, dropping the worst entry when full.
+void ItemSearch::add_result(const Result &result, std::span<Result> results, size_t &count) const {
+  auto is_better = [this](const Result &a, const Result &b) {
+    if (a.match != b.match) return a.match < b.match;
+    if (a.edits != b.edits) return a.edits < b.edits;
+    size_t a_length = offsets[a.index + 1] - offsets[a.index];
+    size_t b_length = offsets[b.index + 1] - offsets[b.index];
+    if (a_length != b_length) return a_length < b_length;
+    return a.index < b.index;
+  };
+  if (count == results.size() && !is_better(result, results[count - 1])) return;
+  size_t position = (count < results.size()) ? count++ : count - 1;
+  for (; position > 0 && is_better(result, results[position - 1]); --position)
+    results[position] = results[position - 1];
+  results[position] = result;
+}
+
+// Returns the fewest edits (insert, delete or substitute) that turn the query into some part of the
+// name using Myers' bit-parallel algorithm.
+int ItemSearch::get_edit_distance(std::string_view name) const {
+  const uint64_t last_bit = 1ull << (query_length - 1);
+  uint64_t positive = ~0ull;  // Vertical deltas of the current column.
+  uint64_t negative = 0;
+  int score = static_cast<int>(query_length);
+  int best = score;
+  for (char c : name) {
+    uint64_t match = pattern_masks[static_cast<unsigned char>(c)];
+    uint64_t xv = match | negative;
+    uint64_t xh = (((match & positive) + positive) ^ positive) | match;
+    uint64_t horizontal_positive = negative | ~(xh | positive);
+    uint64_t horizontal_negative = positive & xh;
+    if (horizontal_positive & last_bit)
+      ++score;
+    else if (horizontal_negative & last_bit)
+      --score;
+    horizontal_positive <<= 1;  // No carry in: a match may start anywhere in the name.
+    horizontal_negative <<= 1;
+    positive = horizontal_negative | ~(xv | horizontal_positive);
+    negative = horizontal_positive & xv;
+    best = std::min(best, score);
+  }
+  return best;
+}
+
+bool ItemSearch::handle_command(const std::vector<std::string> &args) {
+  if (args.size() < 2) {
+    Zeal::Game::print_chat("Usage: /itemsearch <name or part of a name>");
+    return true;
+  }
+  std::string query = args[1];
+  for (size_t i = 2; i < args.size(); ++i) query += " " + args[i];
+
+  if (!is_ready()) {
+    Zeal::Game::print_chat("The item search index is still building, try again in a moment.");
+    return true;
+  }
+  static constexpr size_t kMaxChatResults = 10;
+  Result results[kMaxChatResults];
+  size_t count = search(query, results);
+  if (!count) {
+    Zeal::Game::print_chat("No items found matching: %s", query.c_str());
+    return true;
+  }
+  Zeal::Game::print_chat("Items matching: %s", query.c_str());
+  for (size_t i = 0; i < count; ++i)
+    Zeal::Game::print_chat("  %s (%d)", Zeal::Items::get_name(results[i].index).c_str(), results[i].id);
+  return true;
+}
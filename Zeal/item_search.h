@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Ranked prefix, substring and typo tolerant search over the Zeal::Items name table. Prefix and word
+// prefix matches come from a sorted index of word starts. Substring and typo candidates come from a
+// trigram index and are scored with a bit-parallel edit distance (Myers). The indices take tens of
+// milliseconds to build, so that runs on a worker thread at startup and searches return nothing until
+// it is done. After that a query over the full table completes well under a millisecond. Queries do
+// not allocate: results go to the caller's span and the per-query scratch buffers are reused.
+class ItemSearch {
+ public:
+  enum class Match : uint8_t { Exact, Prefix, WordPrefix, Substring, Fuzzy };  // Ranked best first.
+
+  struct Result {
+    size_t index;  // Record index into the Zeal::Items table.
+    short id;
+    Match match;
+    uint8_t edits;  // Typos in the best matching part of the name (fuzzy matches only).
+  };
+
+  static constexpr size_t kMaxQueryLength = 63;  // Fits the 64-bit match vectors.
+
+  ItemSearch(class ZealService *zeal);
+  ~ItemSearch();
+
+  // Fills results with the best matches (case insensitive) for query and returns the count. Results
+  // are ordered by match type, then typos, then name length. Queries under three characters only
+  // match word starts and typos are allowed from six characters on.
+  // Use Zeal::Items::get_name() for a result's display name. Returns 0 while the index is building.
+  size_t search(std::string_view query, std::span<Result> results);
+
+  bool is_ready() const { return index_ready.load(std::memory_order_acquire); }
+
+ private:
+  void build_index();
+  void add_result(const Result &result, std::span<Result> results, size_t &count) const;
+  struct WordStart {
+    uint16_t record;
+    uint8_t offset;  // Start of the word in the name.
+  };
+
+  std::string_view get_folded_name(size_t index) const;
+  std::string_view get_suffix(const WordStart &word) const;
+  void add_substring_matches(std::string_view query, size_t key_count, std::span<Result> results, size_t &count);
+  int get_edit_distance(std::string_view name) const;
+  bool handle_command(const std::vector<std::string> &args);
+
+  std::string names;              // Null separated lower case item names in record order.
+  std::vector<uint32_t> offsets;  // Start of each name in names (record_count + 1 entries).
+  std::vector<WordStart> word_starts;     // Every word start sorted by the rest of its name.
+  std::vector<uint32_t> trigram_offsets;
+  std::vector<uint16_t> trigram_records;  // Records containing each trigram (CSR layout).
+  std::vector<uint8_t> hit_counts;        // Per-query scratch: matched trigrams per record.
+  std::vector<uint16_t> touched;          // Per-query scratch: records with a non-zero hit count.
+  uint64_t pattern_masks[256] = {};       // Per-query Myers match vectors.
+  size_t query_length = 0;
+  std::atomic<bool> index_ready = false;  // Set by the index thread once the tables above are complete.
+  std::thread index_thread;
+};
@@ -1,14 +1,51 @@
-// Auto-generated header for items lookup
+// Item name lookups over the table generated by items_src/items_to_cpp.py.
 #pragma once
 
 #include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
 
 namespace Zeal {
 namespace Items {
-extern const char *keys[];
-extern const short values[];
+extern const short values[];  // Item ids in name sorted order.
 extern const size_t record_count;
 
+static constexpr size_t kMaxNameLength = 63;  // Enforced by the generator.
+
+// Returns the item id of the name (commas are ignored) or -1 if unknown. Uses a perfect hash
+// so the cost is one hash pass and one string compare.
 short lookup(const char *key);
+
+// Bulk form of lookup() for inventory wide scans. Fills ids[i] for each names[i] (null names
+// and unknown names return -1).
+void lookup(std::span<const char *const> names, std::span<short> ids);
+
+// Returns the name at the sorted record index (empty if out of range).
+std::string get_name(size_t index);
+
+// Returns the [first, last) record index range of the names starting with prefix (case sensitive).
+std::pair<size_t, size_t> prefix_range(std::string_view prefix);
+
+// Decodes the front coded names in order starting at a record index. Stepping forward is cheap
+// since each entry only replaces the tail of the previous name, so scans should use a reader
+// rather than repeated get_name() calls.
+class NameReader {
+ public:
+  explicit NameReader(size_t index = 0);
+
+  bool done() const { return current_index >= record_count; }
+  size_t index() const { return current_index; }
+  std::string_view name() const { return std::string_view(buffer, length); }  // Valid until next().
+  const char *c_str() const { return buffer; }
+  void next();
+
+ private:
+  size_t current_index = 0;
+  const char *entry = nullptr;
+  size_t length = 0;
+  char buffer[kMaxNameLength + 1] = {};
+};
 }  // namespace Items
-}  // namespace Zeal
\ No newline at end of file
+}  // namespace Zeal
@@ -0,0 +1,127 @@
+// Checks the generated items.cpp against the items.csv it was generated from (which was exported
+// from the previous plain keys[] / values[] table). Run it after every items_to_cpp.py regeneration.
+// Built and run by the portable tests (Zeal/tests/CMakeLists.txt). Usage: items_test [items.csv]
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "items.h"
+#include "test_util.h"
+
+using Zeal::Items::NameReader;
+
+namespace {
+
+// Returns the (name, id) rows with commas stripped from the names and sorted like the generator
+// (by unsigned bytes).
+std::vector<std::pair<std::string, short>> read_csv(const char *filename) {
+  std::vector<std::pair<std::string, short>> items;
+  std::ifstream file(filename, std::ios::binary);
+  std::string line;
+  std::getline(file, line);  // Header.
+  while (std::getline(file, line)) {
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    size_t comma = line.find(',');
+    if (comma == std::string::npos) continue;
+    std::string name = line.substr(comma + 1);
+    name.erase(std::remove(name.begin(), name.end(), ','), name.end());
+    items.emplace_back(name, static_cast<short>(std::stoi(line.substr(0, comma))));
+  }
+  std::sort(items.begin(), items.end());
+  return items;
+}
+
+void test_names_and_values(const std::vector<std::pair<std::string, short>> &items) {
+  NameReader reader;
+  for (size_t i = 0; i < items.size() && i < Zeal::Items::record_count; ++i, reader.next()) {
+    const auto &[name, id] = items[i];
+    CHECK_MSG(!reader.done() && reader.index() == i, "reader stopped at %zu", i);
+    CHECK_MSG(reader.name() == name && std::strcmp(reader.c_str(), name.c_str()) == 0, "%zu: \"%s\" vs \"%s\"", i,
+              reader.c_str(), name.c_str());
+    CHECK_MSG(Zeal::Items::values[i] == id, "%zu \"%s\": id %d vs %d", i, name.c_str(), Zeal::Items::values[i], id);
+    CHECK_MSG(Zeal::Items::get_name(i) == name, "get_name(%zu) = \"%s\"", i, Zeal::Items::get_name(i).c_str());
+  }
+  CHECK(reader.done());
+  CHECK(Zeal::Items::get_name(Zeal::Items::record_count).empty());
+
+  // Starting mid block decodes the same names as stepping from the start.
+  for (size_t i = 0; i < Zeal::Items::record_count; i += 37)
+    CHECK_MSG(NameReader(i).name() == items[i].first, "NameReader(%zu)", i);
+}
+
+// Every key through the perfect hash, plus forms of it that must or must not match.
+void test_lookup(const std::vector<std::pair<std::string, short>> &items) {
+  std::vector<std::string> keys;
+  for (const auto &item : items) keys.push_back(item.first);
+  auto is_key = [&keys](const std::string &name) { return std::binary_search(keys.begin(), keys.end(), name); };
+
+  for (const auto &[name, id] : items) {
+    CHECK_MSG(Zeal::Items::lookup(name.c_str()) == id, "lookup(\"%s\")", name.c_str());
+    // The game names keep their commas and lookup skips them.
+    std::string with_commas(1, ',');
+    with_commas.append(name, 0, name.size() / 2).append(",,").append(name, name.size() / 2).push_back(',');
+    CHECK_MSG(Zeal::Items::lookup(with_commas.c_str()) == id, "lookup(\"%s\")", with_commas.c_str());
+    for (std::string other : {name + "x", name.substr(0, name.size() - 1), name + " "}) {
+      if (!is_key(other))
+        CHECK_MSG(Zeal::Items::lookup(other.c_str()) == -1, "lookup(\"%s\") of a non-key", other.c_str());
+    }
+  }
+  CHECK(Zeal::Items::lookup(nullptr) == -1);
+  CHECK(Zeal::Items::lookup("") == -1 || is_key(""));
+  CHECK(Zeal::Items::lookup(",,,") == -1);
+
+  // The bulk form matches the single lookups, including null names.
+  std::vector<const char *> names;
+  std::vector<short> expected;
+  for (size_t i = 0; i < items.size(); i += 11) {
+    names.push_back(items[i].first.c_str());
+    expected.push_back(items[i].second);
+    names.push_back((i % 2) ? nullptr : "Not an item name");
+    expected.push_back(-1);
+  }
+  std::vector<short> ids(names.size(), 0);
+  Zeal::Items::lookup(names, ids);
+  CHECK(ids == expected);
+}
+
+void test_prefix_range(const std::vector<std::pair<std::string, short>> &items) {
+  std::vector<std::string> keys;
+  for (const auto &item : items) keys.push_back(item.first);
+  std::vector<std::string> prefixes = {"", " ", "#", "10 Dose", "A", "a", "Sword", "Tunic of", "Tunic of the", "Z",
+                                       "zzz", "~", "\x7f", "\xff", "\xff\xff", std::string(64, 'A')};
+  std::mt19937 rng(42);
+  for (int i = 0; i < 2000; ++i) {
+    const std::string &key = keys[rng() % keys.size()];
+    prefixes.push_back(key.substr(0, rng() % (key.size() + 1)));
+    prefixes.push_back(key + "!");
+  }
+  for (const std::string &prefix : prefixes) {
+    auto first = std::lower_bound(keys.begin(), keys.end(), prefix);
+    auto last = std::find_if(first, keys.end(), [&prefix](const std::string &key) { return !key.starts_with(prefix); });
+    auto [begin, end] = Zeal::Items::prefix_range(prefix);
+    CHECK_MSG(begin == static_cast<size_t>(first - keys.begin()) && end == static_cast<size_t>(last - keys.begin()),
+              "prefix_range(\"%s\") = [%zu, %zu) vs [%zu, %zu)", prefix.c_str(), begin, end,
+              static_cast<size_t>(first - keys.begin()), static_cast<size_t>(last - keys.begin()));
+  }
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  const char *filename = (argc > 1) ? argv[1] : ITEMS_CSV_PATH;
+  const auto items = read_csv(filename);
+  CHECK_MSG(!items.empty(), "failed to read %s", filename);
+  CHECK_MSG(items.size() == Zeal::Items::record_count, "%zu csv rows vs %zu records", items.size(),
+            Zeal::Items::record_count);
+  if (items.size() != Zeal::Items::record_count) return test_result();
+
+  test_names_and_values(items);
+  test_lookup(items);
+  test_prefix_range(items);
+  std::printf("items: %zu names checked\n", items.size());
+  return test_result();
+}
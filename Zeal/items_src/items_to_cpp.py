@@ -0,0 +1,270 @@
+"""Script for converting the item name to item id csv into items.cpp.
+
+Expected input: A csv file (default 'items.csv' next to this script) with an 'id' and 'name'
+column per item. Commas are stripped from the names (the game names are looked up with their
+commas skipped) and the names must be unique.
+
+Output: Generates EXPORT_CPP_SOURCE_FILENAME with:
+  - The sorted names front coded in blocks of BLOCK_SIZE. The first name of each block is
+    stored whole and the rest store the length of the prefix shared with the previous name
+    plus the remaining suffix, so the table is much smaller than full strings and pointers.
+  - The values[] item ids in name order.
+  - A minimal perfect hash (hash and displace) over the names so lookup() hashes a name
+    once, reads one displacement and one slot entry and verifies with a single compare.
+
+After regenerating, run items_test (Zeal/tests) to check the output against the csv.
+"""
+
+import argparse
+import csv
+import os
+
+EXPORT_CPP_SOURCE_FILENAME = 'items.cpp'
+BLOCK_SIZE = 16
+MAX_NAME_LENGTH = 63  # Must match kMaxNameLength in items.h.
+
+# Must match item_hash() in the exported source.
+FNV_OFFSET_BASIS = 0x811C9DC5
+FNV_PRIME = 0x01000193
+
+EXPORT_CPP_SOURCE_HEADER = r'''// Auto-generated file using items_to_cpp.py
+#include "items.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace Zeal {
+namespace Items {
+static constexpr size_t kBlockSize = BLOCK_SIZE_VALUE;
+
+// Sorted item names front coded in blocks of kBlockSize. Each entry is a shared prefix length
+// byte followed by the null terminated suffix. The first entry of a block has no shared prefix,
+// so block + 1 is the block's first name.
+static const char *const name_blocks[] = {
+'''
+
+EXPORT_CPP_SOURCE_CODE = r'''
+// FNV-1a over the name with commas skipped (the keys were exported with commas stripped).
+// Must match item_hash() in items_src/items_to_cpp.py.
+static uint32_t item_hash(uint32_t seed, const char *key) {
+  uint32_t hash = seed ? seed : 0x811c9dc5;
+  for (; *key; ++key) {
+    if (*key == ',') continue;
+    hash = (hash ^ static_cast<uint8_t>(*key)) * 0x01000193;
+  }
+  return hash;
+}
+
+// Compares a stored (comma free) key to a name while skipping the name's commas.
+static bool is_stripped_match(const char *stored, const char *key) {
+  for (;; ++key) {
+    if (*key == ',') continue;
+    if (*stored != *key) return false;
+    if (!*key) return true;
+    ++stored;
+  }
+}
+
+// Decodes the entry on top of the previous name in buffer and advances entry to the next one.
+static size_t decode_entry(const char *&entry, char *buffer) {
+  size_t length = static_cast<uint8_t>(*entry++);
+  while (*entry) buffer[length++] = *entry++;
+  ++entry;
+  buffer[length] = '\0';
+  return length;
+}
+
+NameReader::NameReader(size_t index) : current_index(index) {
+  if (index >= record_count) return;
+  entry = name_blocks[index / kBlockSize];
+  for (size_t i = 0; i <= index % kBlockSize; ++i) length = decode_entry(entry, buffer);
+}
+
+void NameReader::next() {
+  if (++current_index >= record_count) return;
+  if (current_index % kBlockSize == 0) entry = name_blocks[current_index / kBlockSize];
+  length = decode_entry(entry, buffer);
+}
+
+short lookup(const char *key) {
+  if (!key) return -1;
+  int16_t displacement = displacements[item_hash(0, key) % record_count];
+  size_t slot = (displacement < 0) ? static_cast<size_t>(-displacement - 1)
+                                   : item_hash(static_cast<uint32_t>(displacement), key) % record_count;
+  size_t index = slot_index[slot];
+  return is_stripped_match(NameReader(index).c_str(), key) ? values[index] : -1;
+}
+
+void lookup(std::span<const char *const> names, std::span<short> ids) {
+  size_t count = std::min(names.size(), ids.size());
+  for (size_t i = 0; i < count; ++i) ids[i] = lookup(names[i]);
+}
+
+std::string get_name(size_t index) { return (index < record_count) ? std::string(NameReader(index).name()) : ""; }
+
+// Returns the index of the first name that is not less than value.
+static size_t lower_bound_index(std::string_view value) {
+  // Find the first block whose head is not less than value, then scan the block before it.
+  auto head_less = [](const char *block, std::string_view name) { return std::string_view(block + 1) < name; };
+  auto block = std::lower_bound(std::begin(name_blocks), std::end(name_blocks), value, head_less);
+  if (block == std::begin(name_blocks)) return 0;
+  NameReader reader((block - std::begin(name_blocks) - 1) * kBlockSize);
+  while (!reader.done() && reader.name() < value) reader.next();
+  return reader.index();
+}
+
+std::pair<size_t, size_t> prefix_range(std::string_view prefix) {
+  size_t first = lower_bound_index(prefix);
+  if (prefix.size() > kMaxNameLength) return {first, first};
+
+  // The range ends at the first name not less than the prefix with its last character incremented.
+  char upper[kMaxNameLength + 1];
+  size_t length = prefix.size();
+  prefix.copy(upper, length);
+  while (length && static_cast<uint8_t>(upper[length - 1]) == 0xff) --length;
+  if (!length) return {first, record_count};
+  upper[length - 1] = static_cast<char>(static_cast<uint8_t>(upper[length - 1]) + 1);
+  return {first, lower_bound_index(std::string_view(upper, length))};
+}
+}  // namespace Items
+}  // namespace Zeal
+'''
+
+
+def item_hash(seed, key):
+    h = seed if seed else FNV_OFFSET_BASIS
+    for c in key.encode('latin-1'):
+        if c == ord(','):
+            continue
+        h = ((h ^ c) * FNV_PRIME) & 0xFFFFFFFF
+    return h
+
+
+def read_items(filename):
+    """Returns a name sorted list of (name, id) tuples."""
+    items = {}
+    with open(filename, 'r', encoding='latin-1', newline='') as f:
+        for row in csv.DictReader(f):
+            name = row['name'].replace(',', '')
+            if name in items:
+                raise ValueError(f'Duplicate item name: {name}')
+            if len(name.encode('latin-1')) > MAX_NAME_LENGTH:
+                raise ValueError(f'Item name too long: {name}')
+            items[name] = int(row['id'])
+    # Sort by the encoded bytes to match the unsigned char ordering used in the C++ searches.
+    return sorted(items.items(), key=lambda item: item[0].encode('latin-1'))
+
+
+def escape(text):
+    result = ''
+    for c in text.encode('latin-1'):
+        if c in (ord('"'), ord('\\')) or c < 0x20 or c >= 0x7F:
+            result += f'\\{c:03o}'
+        else:
+            result += chr(c)
+    return result
+
+
+def format_name_blocks(names):
+    lines = []
+    for start in range(0, len(names), BLOCK_SIZE):
+        previous = b''
+        for name in names[start:start + BLOCK_SIZE]:
+            encoded = name.encode('latin-1')
+            shared = 0
+            while shared < min(len(previous), len(encoded)) and previous[shared] == encoded[shared]:
+                shared += 1
+            lines.append(f'    "\\{shared:03o}{escape(name[shared:])}\\0"')
+            previous = encoded
+        lines[-1] += ','
+    return '\n'.join(lines) + '\n};\n'
+
+
+def build_perfect_hash(names):
+    """Hash and displace construction. Returns (displacements, slot_index)."""
+    size = len(names)
+    buckets = [[] for _ in range(size)]
+    for index, name in enumerate(names):
+        buckets[item_hash(0, name) % size].append(index)
+
+    displacements = [0] * size
+    slot_index = [None] * size
+
+    # Place the largest buckets first while there are still plenty of free slots.
+    order = sorted(range(size), key=lambda b: len(buckets[b]), reverse=True)
+    position = 0
+    for position, bucket_id in enumerate(order):
+        bucket = buckets[bucket_id]
+        if len(bucket) <= 1:
+            break
+        seed = 1
+        while True:
+            slots = [item_hash(seed, names[index]) % size for index in bucket]
+            if len(set(slots)) == len(slots) and all(slot_index[slot] is None for slot in slots):
+                break
+            seed += 1
+        if seed > 0x7FFF:
+            raise ValueError('Displacement seed does not fit in an int16_t')
+        displacements[bucket_id] = seed
+        for index, slot in zip(bucket, slots):
+            slot_index[slot] = index
+
+    # Single entry buckets go straight to a free slot, encoded as -(slot + 1).
+    free_slots = [slot for slot in range(size) if slot_index[slot] is None]
+    for bucket_id in order[position:]:
+        bucket = buckets[bucket_id]
+        if not bucket:
+            continue
+        slot = free_slots.pop()
+        displacements[bucket_id] = -slot - 1
+        slot_index[slot] = bucket[0]
+
+    for index, name in enumerate(names):
+        d = displacements[item_hash(0, name) % size]
+        slot = -d - 1 if d < 0 else item_hash(d, name) % size
+        if slot_index[slot] != index:
+            raise ValueError(f'Perfect hash verification failed for {name}')
+    return displacements, slot_index
+
+
+def format_array(declaration, values, per_line=20):
+    lines = [declaration + ' = {']
+    for start in range(0, len(values), per_line):
+        lines.append('    ' + ', '.join(str(v) for v in values[start:start + per_line]) + ',')
+    lines.append('};')
+    return '\n'.join(lines) + '\n'
+
+
+def main():
+    script_dir = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('--input', default=os.path.join(script_dir, 'items.csv'), help='Item csv file')
+    parser.add_argument('--output_dir', default=os.path.dirname(script_dir), help='Output directory')
+    args = parser.parse_args()
+
+    items = read_items(args.input)
+    if len(items) > 0xFFFF:
+        raise ValueError('Too many items for the uint16_t slot_index table')
+    names = [name for name, _ in items]
+    displacements, slot_index = build_perfect_hash(names)
+
+    output = EXPORT_CPP_SOURCE_HEADER.replace('BLOCK_SIZE_VALUE', str(BLOCK_SIZE))
+    output += format_name_blocks(names)
+    output += '\n' + format_array('const short values[]', [item_id for _, item_id in items])
+    output += '\nconst size_t record_count = sizeof(values) / sizeof(values[0]);\n'
+    output += '\n' + format_array('static const int16_t displacements[]', displacements)
+    output += '\n' + format_array('static const uint16_t slot_index[]', slot_index)
+    output += ('\nstatic_assert(std::size(name_blocks) == (std::size(values) + kBlockSize - 1) / kBlockSize);\n'
+               'static_assert(std::size(displacements) == std::size(values));\n'
+               'static_assert(std::size(slot_index) == std::size(values));\n')
+    output += EXPORT_CPP_SOURCE_CODE
+
+    with open(os.path.join(args.output_dir, EXPORT_CPP_SOURCE_FILENAME), 'w', encoding='latin-1', newline='') as f:
+        f.write(output)
+    print(f'Exported {len(items)} items in {(len(names) + BLOCK_SIZE - 1) // BLOCK_SIZE} blocks.')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,76 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// Bounded multi-producer, multi-consumer queue that never takes a lock (D. Vyukov's design).
+// Each cell carries a sequence number that tells producers and consumers whether it is free,
+// so push and pop are a single compare-and-swap on the head/tail index in the common case.
+// Capacity must be a power of two. push() fails instead of blocking when the queue is full.
+template <typename T, size_t Capacity>
+class LockFreeQueue {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+ public:
+  LockFreeQueue() {
+    for (size_t i = 0; i < Capacity; ++i) cells[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  LockFreeQueue(const LockFreeQueue &) = delete;
+  LockFreeQueue &operator=(const LockFreeQueue &) = delete;
+
+  // Returns false (and leaves value untouched) if the queue is full.
+  bool push(T &&value) {
+    size_t pos = tail.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell &cell = cells[pos & kMask];
+      size_t seq = cell.sequence.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          cell.value = std::move(value);
+          cell.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;  // Full.
+      } else {
+        pos = tail.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Returns false if the queue is empty.
+  bool pop(T &value) {
+    size_t pos = head.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell &cell = cells[pos & kMask];
+      size_t seq = cell.sequence.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          value = std::move(cell.value);
+          cell.sequence.store(pos + Capacity, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;  // Empty.
+      } else {
+        pos = head.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+ private:
+  static constexpr size_t kMask = Capacity - 1;
+
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  Cell cells[Capacity];
+  alignas(64) std::atomic<size_t> tail = 0;  // Separate cache lines to avoid producer/consumer false sharing.
+  alignas(64) std::atomic<size_t> head = 0;
+};
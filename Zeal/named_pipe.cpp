@@ -3,7 +3,7 @@
 #include <Windows.h>
 #include <zone_map.h>
 
-#include <thread>
+#include <algorithm>
 
 #include "callbacks.h"
 #include "chat.h"
@@ -11,8 +11,11 @@
 #include "entity_manager.h"
 #include "game_addresses.h"
 #include "game_functions.h"
+#include "game_packets.h"
 #include "game_structures.h"
 #include "hook_wrapper.h"
+#include "item_search.h"
+#include "items.h"
 #include "labels.h"
 #include "string_util.h"
 #include "tick.h"
@@ -148,7 +151,7 @@ static nlohmann::json toJson(const Vec3 &position) {
   return data;
 }
 
-pipe_data::pipe_data(pipe_data_type _type, std::string _data) {
+pipe_data::pipe_data(pipe_data_type _type, const std::string &_data) {
   data = _data;
   if (Zeal::Game::is_in_game() && Zeal::Game::get_self())
     character = Zeal::Game::get_self()->Name;
@@ -166,253 +169,505 @@ void log_hook(char *data) {
   zeal->hooks->hook_map["logtextfile"]->original(log_hook)(data);
 }
 
+// Appends a {"type":color,"text":"..."} log object in a single pass. Non-printable characters are
+// dropped and quotes and backslashes escaped, matching the output of the previous json based sanitizer.
+static void append_chat_line(std::string &out, const char *data, int color_index) {
+  out += "{\"type\":";
+  out += std::to_string(color_index);
+  out += ",\"text\":\"";
+  for (const unsigned char *c = reinterpret_cast<const unsigned char *>(data); *c; ++c) {
+    if (*c < 0x20 || *c > 0x7e) continue;
+    if (*c == '"' || *c == '\\') out.push_back('\\');
+    out.push_back(static_cast<char>(*c));
+  }
+  out += "\"}";
+}
+
 void NamedPipe::chat_msg(const char *data, int color_index) {
   if (!is_connected()) return;
 
-  try {
-    std::string sanitized_data(data);
-
-    // sanitization: Remove non-printable characters
-    sanitized_data.erase(
-        std::remove_if(sanitized_data.begin(), sanitized_data.end(), [](unsigned char c) { return !std::isprint(c); }),
-        sanitized_data.end());
+  if (!pipe_chat_batch.get()) {
+    chat_line.clear();  // Reused buffer.
+    append_chat_line(chat_line, data, color_index);
+    write(chat_line, pipe_data_type::log);
+    return;
+  }
 
-    nlohmann::json jd = {{"type", color_index}, {"text", sanitized_data}};
-    write(jd.dump(), pipe_data_type::log);
-  } catch (const std::exception &e) {
+  if (chat_batch.empty()) {
+    chat_batch.push_back('[');
+    chat_batch_start = GetTickCount64();
+  } else {
+    chat_batch.push_back(',');
   }
+  append_chat_line(chat_batch, data, color_index);
+  if (chat_batch.size() >= static_cast<size_t>(max(1, pipe_chat_batch_size.get()))) flush_chat();
 }
 
-bool IsPipeConnected(HANDLE hPipe) {
-  DWORD dwBytesAvailable, dwBytesLeftThisMessage, dwBytesMessage;
-  BOOL bSuccess = PeekNamedPipe(hPipe, NULL, 0, NULL, &dwBytesAvailable, &dwBytesLeftThisMessage);
-  if (!bSuccess) {
-    // Error occurred while checking pipe state
-    return false;
-  }
-  return dwBytesAvailable > 0;  // Return true if bytes are available for reading (pipe is connected)
+// Sends the accumulated chat lines as a single log_batch message.
+void NamedPipe::flush_chat() {
+  if (chat_batch.empty()) return;
+
+  chat_batch.push_back(']');
+  write(chat_batch, pipe_data_type::log_batch);
+  chat_batch.clear();  // Keeps the capacity for the next batch.
 }
 
 void NamedPipe::main_loop() {
   update_pipe_handles();  // Handle thread synchronization.
+  process_commands();
 
-  if (!is_connected() || pipe_delay.get() <= 0)  // Don't waste cpu time if not connected or disabled.
+  if (!is_connected()) {  // Don't waste cpu time if not connected.
+    chat_batch.clear();
     return;
+  }
 
-  static auto last_output = GetTickCount64();
-  if (GetTickCount64() - last_output > pipe_delay.get()) {
-    const auto *raid_info = Zeal::Game::RaidInfo;
-    if (raid_info->is_in_raid()) {
-      const auto entity_manager = ZealService::get_instance()->entity_manager.get();  // Short-term ptr.
-      nlohmann::json raid_array = nlohmann::json::array();
-      for (int i = 0; i < Zeal::GameStructures::RaidInfo::kRaidMaxMembers; i++) {
-        const Zeal::GameStructures::RaidMember &member = raid_info->MemberList[i];
-        if (member.Name[0] == 0) continue;  // Empty slot.
-
-        nlohmann::json raid_data = nlohmann::json::object();
-
-        const auto &entity = entity_manager->Get(member.Name);
-        if (entity) {
-          raid_data["loc"] = toJson(entity->Position);
-          raid_data["heading"] = entity->Heading;
-          if (pipe_verbose.get()) {
-            raid_data["hp_current"] = entity->HpCurrent;
-            raid_data["hp_max"] = entity->HpMax;
-            raid_data["zone_id"] = entity->ZoneId;
-          }
-        }
+  const ULONGLONG now = GetTickCount64();
+  if (!chat_batch.empty() && now - chat_batch_start >= static_cast<ULONGLONG>(max(0, pipe_chat_interval.get())))
+    flush_chat();
 
-        raid_data["group"] = (member.GroupNumber == Zeal::GameStructures::RaidMember::kRaidUngrouped)
-                                 ? "0"
-                                 : std::to_string(member.GroupNumber + 1);
-        raid_data["name"] = member.Name;
-        raid_data["level"] = member.PlayerLevel;
-        raid_data["class"] = member.Class;
-        raid_data["rank"] = (strcmp(member.Name, raid_info->LeaderName) == 0) ? "Raid Leader"
-                            : member.IsGroupLeader                            ? "Group Leader"
-                                                                              : "";
-
-        raid_array.push_back(raid_data);
-      }
-      write(raid_array.dump(), pipe_data_type::raid);
-    }
+  if (pipe_delay.get() <= 0)  // Disabled.
+    return;
 
-    const auto *group_info = Zeal::Game::GroupInfo;
-    if (group_info->is_in_group()) {
-      nlohmann::json group_array = nlohmann::json::array();
-
-      for (int i = 0; i < GAME_NUM_GROUP_MEMBERS; i++) {
-        Zeal::GameStructures::Entity *member = group_info->EntityList[i];
-        if ((strlen(group_info->Names[i]) > 0) && member) {
-          nlohmann::json group_data = nlohmann::json::object();
-          group_data["name"] = group_info->Names[i];
-          group_data["loc"] = toJson(member->Position);
-          group_data["heading"] = member->Heading;
-          if (pipe_verbose.get()) {
-            group_data["hp_current"] = member->HpCurrent;
-            group_data["hp_max"] = member->HpMax;
-            group_data["class"] = member->Class;
-            group_data["level"] = member->Level;
-            group_data["zone_id"] = member->ZoneId;
-          }
-
-          group_array.push_back(group_data);
-        } else {
-          continue;
-        }
-      }
-      write(group_array.dump(), pipe_data_type::group);
-    }
+  if (now - last_heartbeat >= static_cast<ULONGLONG>(pipe_delay.get())) {
+    last_heartbeat = now;
+    mark_dirty(kTopicAll);  // Low rate heartbeat that also resyncs anything the events missed.
+  }
 
-    nlohmann::json label_array = nlohmann::json::array();
-    for (auto &[id, name] : LabelNames) {
-      nlohmann::json meta_data = nlohmann::json::object();
-      nlohmann::json label_data = nlohmann::json::object();
-      std::string value;
-      if (id >= 45 && id <= 59 && Zeal::Game::get_char_info())  // buff
-      {
-        int spellId = Zeal::Game::get_char_info()->Buff[id - 45].SpellId;
-        int buffTicks = 0;
-        if (spellId != USHRT_MAX) buffTicks = Zeal::Game::get_char_info()->Buff[id - 45].Ticks;
-        meta_data["ticks"] = buffTicks;
-      }
-      if (ZealService::get_instance()->labels_hook->GetLabel(id, value)) {
-        label_data["type"] = id;
-        label_data["value"] = value;
-        label_data["meta"] = meta_data;
-        label_array.push_back(label_data);
-      }
-    }
-    nlohmann::json gauge_array = nlohmann::json::array();
-    for (auto &[id, name] : GaugeNames) {
-      nlohmann::json gauge_data = nlohmann::json::object();
-      std::string text;
-      int val = ZealService::get_instance()->labels_hook->GetGauge(id, text);
-      gauge_data["type"] = id;
-      gauge_data["text"] = text;
-      gauge_data["value"] = val;
-      gauge_array.push_back(gauge_data);
-    }
+  detect_changes(now);
+  publish_dirty(now);
+}
 
-    write(label_array.dump(), pipe_data_type::label);
-    write(gauge_array.dump(), pipe_data_type::gauge);
-
-    if (Zeal::Game::get_self()) {
-      nlohmann::json player_data = nlohmann::json::object();
-      player_data["zone"] = Zeal::Game::get_self()->ZoneId;
-      player_data["location"] = toJson(Zeal::Game::get_self()->Position);
-      player_data["heading"] = Zeal::Game::get_self()->Heading;
-      player_data["autoattack"] = (bool)(*(BYTE *)0x7f6ffe);
-      // nlohmann::json data = { {"zone", Zeal::Game::get_self()->ZoneId}, {"location",
-      // Zeal::Game::get_self()->Position.toJson() }, {"heading", Zeal::Game::get_self()->Heading}, {"autoattack",
-      // (bool)(*(BYTE*)0x7f6ffe)} };
-      write(player_data.dump(), pipe_data_type::player);
-    }
-    last_output = GetTickCount64();
+void NamedPipe::mark_dirty(unsigned topics) { dirty_topics |= topics; }
+
+// Handles the incoming server messages that change published state.
+void NamedPipe::handle_packet(UINT opcode) {
+  switch (opcode) {
+    case Zeal::Packets::HPUpdate:  // Self, target, group and raid hp (the latter two only in verbose).
+      mark_dirty(kTopicLabel | kTopicGauge | (pipe_verbose.get() ? (kTopicGroup | kTopicRaid) : 0));
+      break;
+    case Zeal::Packets::Stamina:
+      mark_dirty(kTopicLabel | kTopicGauge);
+      break;
+    case Zeal::Packets::RaidUpdate:
+      mark_dirty(kTopicRaid);
+      break;
+    case Zeal::Packets::GroupUpdate:
+      mark_dirty(kTopicGroup | kTopicLabel | kTopicGauge);
+      break;
+    default:
+      break;
   }
 }
 
-std::string ArgsToString(const std::vector<std::string> &vec, const std::string &delimiter) {
-  if (vec.size() <= 1) {
-    return "";
+// Compares a small snapshot of frequently changing state that isn't delivered through a packet
+// callback (position, target, mana, casting) against the last frame and marks the affected topics.
+void NamedPipe::detect_changes(ULONGLONG now) {
+  const auto *self = Zeal::Game::get_self();
+  if (!self) return;
+
+  FrameState state;
+  const auto *target = Zeal::Game::get_target();
+  state.target_id = target ? target->SpawnId : 0;
+  state.hp = self->HpCurrent;
+  const auto *char_info = Zeal::Game::get_char_info();
+  state.mana = char_info ? char_info->Mana : 0;
+  state.casting_spell_id = self->ActorInfo ? self->ActorInfo->CastingSpellId : Zeal::GameStructures::kInvalidSpellId;
+  state.zone_id = self->ZoneId;
+  state.position = self->Position;
+  state.heading = self->Heading;
+  state.autoattack = *(BYTE *)0x7f6ffe;
+
+  const auto *group_info = Zeal::Game::GroupInfo;
+  for (int i = 0; i < GAME_NUM_GROUP_MEMBERS; i++) {
+    const Zeal::GameStructures::Entity *member = group_info->EntityList[i];
+    if (member) state.group_position[i] = member->Position;
   }
 
-  std::string result = vec[1];
-  for (size_t i = 2; i < vec.size(); ++i) {
-    result += delimiter + vec[i];
+  unsigned topics = 0;
+  if (state.target_id != frame_state.target_id) topics |= kTopicLabel | kTopicGauge;
+  if (state.hp != frame_state.hp || state.mana != frame_state.mana) topics |= kTopicLabel | kTopicGauge;
+  if (state.casting_spell_id != Zeal::GameStructures::kInvalidSpellId ||
+      state.casting_spell_id != frame_state.casting_spell_id)
+    topics |= kTopicGauge;  // The casting gauge progresses every frame while casting.
+  if (state.zone_id != frame_state.zone_id) topics |= kTopicAll;
+  if (state.position != frame_state.position || state.heading != frame_state.heading ||
+      state.autoattack != frame_state.autoattack)
+    topics |= kTopicPlayer;
+  if (memcmp(state.group_position, frame_state.group_position, sizeof(state.group_position)) != 0)
+    topics |= kTopicGroup;
+
+  // Raid members also move without a packet. Their entities are looked up by name, so they are only
+  // rescanned once per coalescing window (the most often the raid topic is published anyway).
+  state.raid_entity_hash = frame_state.raid_entity_hash;
+  if (now - last_raid_scan >= get_coalesce_window()) {
+    last_raid_scan = now;
+    state.raid_entity_hash = get_raid_entity_hash();
+    if (state.raid_entity_hash != frame_state.raid_entity_hash) topics |= kTopicRaid;
   }
-  return result;
+
+  frame_state = state;
+  mark_dirty(topics);
 }
 
-struct PipeData {
-  OVERLAPPED overlapped;
-  HANDLE pipe;
+// Hashes the member entity fields publish_raid() reports (position and heading, plus hp and zone
+// in verbose mode). Returns 0 when not in a raid.
+uint32_t NamedPipe::get_raid_entity_hash() const {
+  const auto *raid_info = Zeal::Game::RaidInfo;
+  if (!raid_info->is_in_raid()) return 0;
+
+  uint32_t hash = 2166136261u;  // FNV-1a.
+  auto add = [&hash](const void *data, size_t size) {
+    for (size_t i = 0; i < size; ++i) hash = (hash ^ static_cast<const BYTE *>(data)[i]) * 16777619u;
+  };
+  const auto entity_manager = ZealService::get_instance()->entity_manager.get();  // Short-term ptr.
+  const bool verbose = pipe_verbose.get();
+  for (int i = 0; i < Zeal::GameStructures::RaidInfo::kRaidMaxMembers; i++) {
+    const Zeal::GameStructures::RaidMember &member = raid_info->MemberList[i];
+    if (member.Name[0] == 0) continue;  // Empty slot.
+
+    const auto *entity = entity_manager->Get(member.Name);
+    const BYTE in_zone = entity ? 1 : 0;
+    add(&in_zone, sizeof(in_zone));
+    if (!entity) continue;
+    add(&entity->Position, sizeof(entity->Position));
+    add(&entity->Heading, sizeof(entity->Heading));
+    if (verbose) {
+      add(&entity->HpCurrent, sizeof(entity->HpCurrent));
+      add(&entity->HpMax, sizeof(entity->HpMax));
+      add(&entity->ZoneId, sizeof(entity->ZoneId));
+    }
+  }
+  return hash;
+}
+
+ULONGLONG NamedPipe::get_coalesce_window() const {
+  return (pipe_coalesce.get() > 0) ? static_cast<ULONGLONG>(pipe_coalesce.get()) : 0;
+}
 
-  PipeData(HANDLE h) {
-    pipe = h;
-    ZeroMemory(&overlapped, sizeof(OVERLAPPED));
-    // overlapped.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+// Writes each dirty topic at most once per coalescing window. The first change after an idle
+// period goes out immediately and a burst of changes is folded into one trailing update.
+void NamedPipe::publish_dirty(ULONGLONG now) {
+  const ULONGLONG window = get_coalesce_window();
+  for (int i = 0; i < kNumTopics; ++i) {
+    const unsigned topic = 1u << i;
+    if (!(dirty_topics & topic) || now - last_publish[i] < window) continue;
+    publish_topic(i, now);
   }
-};
+}
 
-void CALLBACK WriteCompletion(DWORD dwErrorCode, DWORD dwNumberOfBytesTransfered, LPOVERLAPPED lpOverlapped) {
-  PipeData *pData = reinterpret_cast<PipeData *>(lpOverlapped);
-  delete pData;
+void NamedPipe::publish_topic(int index, ULONGLONG now) {
+  const unsigned topic = 1u << index;
+  dirty_topics &= ~topic;
+  last_publish[index] = now;
+  switch (topic) {
+    case kTopicRaid:
+      publish_raid();
+      break;
+    case kTopicGroup:
+      publish_group();
+      break;
+    case kTopicLabel:
+      publish_labels();
+      break;
+    case kTopicGauge:
+      publish_gauges();
+      break;
+    case kTopicPlayer:
+      publish_player();
+      break;
+  }
 }
 
-bool IsValidHandle(HANDLE h) {
-  return (h != INVALID_HANDLE_VALUE) && (GetFileType(h) != FILE_TYPE_UNKNOWN || GetLastError() == NO_ERROR);
+// Parses a newline terminated json request from a client. Called on the transport thread, so it
+// only validates and queues the request for execution on the game thread.
+void NamedPipe::receive_line(const std::string &line) {
+  nlohmann::json json = nlohmann::json::parse(line, nullptr, false);
+  if (json.is_discarded() || !json.is_object() || !json.contains("type") || !json["type"].is_string()) return;
+
+  PipeCommand command;
+  const std::string &type = json["type"].get_ref<const std::string &>();
+  if (json.contains("data") && json["data"].is_string()) command.data = json["data"].get<std::string>();
+  if (type == "command" && !command.data.empty() && command.data.front() == '/') {
+    command.type = PipeCommand::Type::Command;
+  } else if (type == "target" && !command.data.empty()) {
+    command.type = PipeCommand::Type::Target;
+  } else if (type == "resync") {
+    command.type = PipeCommand::Type::Resync;
+    if (json.contains("data") && json["data"].is_number_unsigned())
+      command.last_seq = json["data"].get<unsigned long long>();
+    else if (!command.data.empty())
+      command.last_seq = std::strtoull(command.data.c_str(), nullptr, 10);
+  } else if (type == "snapshot") {
+    command.type = PipeCommand::Type::Snapshot;
+    command.topics = parse_topics(command.data);
+    if (!command.topics) return;
+  } else if (type == "item_search" && !command.data.empty()) {
+    command.type = PipeCommand::Type::ItemSearch;
+    if (json.contains("limit") && json["limit"].is_number_unsigned()) command.limit = json["limit"].get<unsigned>();
+  } else {
+    return;
+  }
+  command_queue.push(std::move(command));  // Silently dropped if the game thread is that far behind.
 }
 
-bool WriteDataWithRetry(HANDLE h, const std::string &data, OVERLAPPED *pData,
-                        LPOVERLAPPED_COMPLETION_ROUTINE WriteCompletion) {
-  const int maxRetries = 3;
-  int attempt = 0;
-  if (IsValidHandle(h)) {
-    // DWORD bytesAvailable;
-    // DWORD totalBytes;
-    // DWORD bytesLeftThisMessage;
-    // if (PeekNamedPipe(h, NULL, 0, NULL, &bytesAvailable, &bytesLeftThisMessage)) {
-    //	std::cout << "Bytes available in pipe: " << bytesAvailable << std::endl;
-    //	while (bytesAvailable > 1024*16) {
-    //		PeekNamedPipe(h, NULL, 0, NULL, &bytesAvailable, &bytesLeftThisMessage);
-    //		Sleep(1); // Slow down if pipe is too full
-    //	}
-    // }
-    while (attempt < maxRetries) {
-      if (WriteFileEx(h, data.c_str(), static_cast<DWORD>(data.length()), pData, WriteCompletion)) {
-        return true;
-      } else {
-        DWORD errorCode = GetLastError();
-        char *errorMsg = nullptr;
-        FormatMessageA(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
-                       nullptr, errorCode, MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT),
-                       reinterpret_cast<LPSTR>(&errorMsg), 0, nullptr);
-
-        if (errorCode != 232)  // the pipe is being closed -- when closing the other end abruptly
-        {
-          if (errorMsg) {
-            Zeal::Game::print_chat("WriteFileEx failed on attempt %i with error %u: %s", attempt + 1, errorCode,
-                                   errorMsg);
-            Zeal::Game::print_chat("Parameters [%i] [%s] [%i] [%i]", h, data.c_str(), data.length(), pData);
-            LocalFree(errorMsg);  // Free the buffer allocated by FormatMessage
-          } else {
-            Zeal::Game::print_chat("WriteFileEx failed on attempt %i with error %u", attempt + 1, errorCode);
-          }
-        }
+// Converts a comma separated list of topic names (empty or "all" for every topic) to a bitmask.
+unsigned NamedPipe::parse_topics(const std::string &names) {
+  if (names.empty() || names == "all") return kTopicAll;
+
+  unsigned topics = 0;
+  std::vector<std::string_view> tokens;
+  Zeal::String::split(names, ",", tokens);
+  for (std::string_view name : tokens) {
+    name = Zeal::String::trim(name);
+    if (name == "raid")
+      topics |= kTopicRaid;
+    else if (name == "group")
+      topics |= kTopicGroup;
+    else if (name == "label")
+      topics |= kTopicLabel;
+    else if (name == "gauge")
+      topics |= kTopicGauge;
+    else if (name == "player")
+      topics |= kTopicPlayer;
+  }
+  return topics;
+}
 
-        Sleep(10);
-        attempt++;
-      }
+// Brings a client that last processed last_seq back up to date. Messages still held in the replay
+// buffers are re-sent with their original sequence numbers. State topics whose missed messages were
+// evicted get a fresh snapshot instead, and a final resync message reports the replayed range and
+// whether any log or custom messages were lost. Replies go to every client, which simply ignore
+// sequence numbers they have already processed.
+void NamedPipe::resync(unsigned long long last_seq) {
+  if (last_seq > sequence) last_seq = 0;  // Stale sequence from a previous session.
+
+  static const std::pair<pipe_data_type, unsigned> kStateTopics[] = {
+      {pipe_data_type::raid, kTopicRaid},   {pipe_data_type::group, kTopicGroup},
+      {pipe_data_type::label, kTopicLabel}, {pipe_data_type::gauge, kTopicGauge},
+      {pipe_data_type::player, kTopicPlayer},
+  };
+
+  unsigned snapshot_topics = 0;
+  bool complete = true;
+  std::vector<std::pair<unsigned long long, const std::string *>> missed;
+  for (int type = 0; type < kNumPipeDataTypes; ++type) {
+    if (type == static_cast<int>(pipe_data_type::resync) || type == static_cast<int>(pipe_data_type::item_search))
+      continue;  // Replies to a request, not part of the stream.
+    const ReplayBuffer &buffer = replay_buffers[type];
+    const bool evicted = buffer.evicted_seq > last_seq;
+    unsigned topic = 0;
+    for (const auto &[state_type, state_topic] : kStateTopics)
+      if (static_cast<int>(state_type) == type) topic = state_topic;
+    if (evicted && topic) {
+      snapshot_topics |= topic;
+      continue;
     }
+    if (evicted) complete = false;
+    for (int i = 0; i < ReplayBuffer::kDepth; ++i)
+      if (buffer.seq[i] > last_seq) missed.emplace_back(buffer.seq[i], &buffer.message[i]);
   }
 
-  return false;
+  std::sort(missed.begin(), missed.end());
+  const unsigned long long replayed_to = sequence;
+  for (const auto &[seq, message] : missed) write(*message);
+
+  const ULONGLONG now = GetTickCount64();
+  for (int index = 0; index < kNumTopics; ++index)
+    if (snapshot_topics & (1u << index)) publish_topic(index, now);
+
+  nlohmann::json status = {{"from", last_seq}, {"to", replayed_to}, {"complete", complete}};
+  write(status.dump(), pipe_data_type::resync);
 }
 
-void NamedPipe::write(std::string data, pipe_data_type data_type) {
-  pipe_data pd(data_type, data);
-  write(pd.serialize().dump());
+// Executes up to the per-frame budget of queued client requests on the game thread.
+void NamedPipe::process_commands() {
+  const int budget = pipe_command_budget.get();
+  PipeCommand command;
+  for (int i = 0; i < budget && command_queue.pop(command); ++i) {
+    switch (command.type) {
+      case PipeCommand::Type::Command:
+        if (pipe_commands.get()) ZealService::get_instance()->commands_hook->execute(command.data);
+        break;
+      case PipeCommand::Type::Target:
+        if (pipe_commands.get() && Zeal::Game::is_in_game() && Zeal::Game::get_self())
+          Zeal::Game::do_target(command.data.c_str());  // Dropped at character select or while zoning.
+        break;
+      case PipeCommand::Type::Snapshot: {
+        const ULONGLONG now = GetTickCount64();
+        for (int index = 0; index < kNumTopics; ++index)
+          if (command.topics & (1u << index)) publish_topic(index, now);
+        break;
+      }
+      case PipeCommand::Type::Resync:
+        resync(command.last_seq);
+        break;
+      case PipeCommand::Type::ItemSearch:
+        search_items(command.data, command.limit);
+        break;
+    }
+  }
 }
 
-void NamedPipe::write(std::string data) {
-  for (auto &h : pipe_handles) {
-    PipeData *pData = new PipeData(h);
+// Replies to an item search request with the ranked matches.
+void NamedPipe::search_items(const std::string &query, unsigned limit) {
+  static constexpr unsigned kDefaultResults = 20;
+  static constexpr unsigned kMaxResults = 50;
+  static constexpr const char *kMatchNames[] = {"exact", "prefix", "word", "substring", "fuzzy"};
+  ItemSearch::Result results[kMaxResults];
+  const unsigned max_results = limit ? min(limit, kMaxResults) : kDefaultResults;
+  ItemSearch *item_search = ZealService::get_instance()->item_search.get();
+  const bool ready = item_search && item_search->is_ready();
+  const size_t count = ready ? item_search->search(query, std::span<ItemSearch::Result>(results, max_results)) : 0;
+
+  nlohmann::json items = nlohmann::json::array();
+  for (size_t i = 0; i < count; ++i)
+    items.push_back({{"id", results[i].id},
+                     {"name", Zeal::Items::get_name(results[i].index)},
+                     {"match", kMatchNames[static_cast<int>(results[i].match)]},
+                     {"edits", results[i].edits}});
+  nlohmann::json reply = {{"query", query}, {"ready", ready}, {"items", items}};
+  write(reply.dump(), pipe_data_type::item_search);
+}
+
+void NamedPipe::publish_raid() {
+  const auto *raid_info = Zeal::Game::RaidInfo;
+  if (!raid_info->is_in_raid()) return;
+
+  const auto entity_manager = ZealService::get_instance()->entity_manager.get();  // Short-term ptr.
+  nlohmann::json raid_array = nlohmann::json::array();
+  for (int i = 0; i < Zeal::GameStructures::RaidInfo::kRaidMaxMembers; i++) {
+    const Zeal::GameStructures::RaidMember &member = raid_info->MemberList[i];
+    if (member.Name[0] == 0) continue;  // Empty slot.
+
+    nlohmann::json raid_data = nlohmann::json::object();
+
+    const auto &entity = entity_manager->Get(member.Name);
+    if (entity) {
+      raid_data["loc"] = toJson(entity->Position);
+      raid_data["heading"] = entity->Heading;
+      if (pipe_verbose.get()) {
+        raid_data["hp_current"] = entity->HpCurrent;
+        raid_data["hp_max"] = entity->HpMax;
+        raid_data["zone_id"] = entity->ZoneId;
+      }
+    }
+
+    raid_data["group"] = (member.GroupNumber == Zeal::GameStructures::RaidMember::kRaidUngrouped)
+                             ? "0"
+                             : std::to_string(member.GroupNumber + 1);
+    raid_data["name"] = member.Name;
+    raid_data["level"] = member.PlayerLevel;
+    raid_data["class"] = member.Class;
+    raid_data["rank"] = (strcmp(member.Name, raid_info->LeaderName) == 0) ? "Raid Leader"
+                        : member.IsGroupLeader                            ? "Group Leader"
+                                                                          : "";
+
+    raid_array.push_back(raid_data);
+  }
+  write(raid_array.dump(), pipe_data_type::raid);
+}
 
-    if (h != INVALID_HANDLE_VALUE) {
-      if (!WriteDataWithRetry(h, data, reinterpret_cast<LPOVERLAPPED>(pData), WriteCompletion)) {
-        DisconnectNamedPipe(h);
-        CloseHandle(h);
-        h = INVALID_HANDLE_VALUE;
-        delete pData;
+void NamedPipe::publish_group() {
+  const auto *group_info = Zeal::Game::GroupInfo;
+  if (!group_info->is_in_group()) return;
+
+  nlohmann::json group_array = nlohmann::json::array();
+  for (int i = 0; i < GAME_NUM_GROUP_MEMBERS; i++) {
+    Zeal::GameStructures::Entity *member = group_info->EntityList[i];
+    if ((strlen(group_info->Names[i]) > 0) && member) {
+      nlohmann::json group_data = nlohmann::json::object();
+      group_data["name"] = group_info->Names[i];
+      group_data["loc"] = toJson(member->Position);
+      group_data["heading"] = member->Heading;
+      if (pipe_verbose.get()) {
+        group_data["hp_current"] = member->HpCurrent;
+        group_data["hp_max"] = member->HpMax;
+        group_data["class"] = member->Class;
+        group_data["level"] = member->Level;
+        group_data["zone_id"] = member->ZoneId;
       }
+
+      group_array.push_back(group_data);
+    }
+  }
+  write(group_array.dump(), pipe_data_type::group);
+}
+
+void NamedPipe::publish_labels() {
+  nlohmann::json label_array = nlohmann::json::array();
+  for (auto &[id, name] : LabelNames) {
+    nlohmann::json meta_data = nlohmann::json::object();
+    nlohmann::json label_data = nlohmann::json::object();
+    std::string value;
+    if (id >= 45 && id <= 59 && Zeal::Game::get_char_info())  // buff
+    {
+      int spellId = Zeal::Game::get_char_info()->Buff[id - 45].SpellId;
+      int buffTicks = 0;
+      if (spellId != USHRT_MAX) buffTicks = Zeal::Game::get_char_info()->Buff[id - 45].Ticks;
+      meta_data["ticks"] = buffTicks;
+    }
+    if (ZealService::get_instance()->labels_hook->GetLabel(id, value)) {
+      label_data["type"] = id;
+      label_data["value"] = value;
+      label_data["meta"] = meta_data;
+      label_array.push_back(label_data);
     }
   }
-  pipe_handles.erase(
-      std::remove_if(pipe_handles.begin(), pipe_handles.end(), [](HANDLE x) { return x == INVALID_HANDLE_VALUE; }),
-      pipe_handles.end());
+  write(label_array.dump(), pipe_data_type::label);
+}
+
+void NamedPipe::publish_gauges() {
+  nlohmann::json gauge_array = nlohmann::json::array();
+  for (auto &[id, name] : GaugeNames) {
+    nlohmann::json gauge_data = nlohmann::json::object();
+    std::string text;
+    int val = ZealService::get_instance()->labels_hook->GetGauge(id, text);
+    gauge_data["type"] = id;
+    gauge_data["text"] = text;
+    gauge_data["value"] = val;
+    gauge_array.push_back(gauge_data);
+  }
+  write(gauge_array.dump(), pipe_data_type::gauge);
+}
+
+void NamedPipe::publish_player() {
+  if (!Zeal::Game::get_self()) return;
+
+  nlohmann::json player_data = nlohmann::json::object();
+  player_data["zone"] = Zeal::Game::get_self()->ZoneId;
+  player_data["location"] = toJson(Zeal::Game::get_self()->Position);
+  player_data["heading"] = Zeal::Game::get_self()->Heading;
+  player_data["autoattack"] = (bool)(*(BYTE *)0x7f6ffe);
+  write(player_data.dump(), pipe_data_type::player);
+}
+
+std::string ArgsToString(const std::vector<std::string> &vec, const std::string &delimiter) {
+  if (vec.size() <= 1) {
+    return "";
+  }
+
+  std::string result = vec[1];
+  for (size_t i = 2; i < vec.size(); ++i) {
+    result += delimiter + vec[i];
+  }
+  return result;
 }
 
+void NamedPipe::write(const std::string &data, pipe_data_type data_type) {
+  pipe_data pd(data_type, data);
+  pd.seq = ++sequence;
+
+  ReplayBuffer &buffer = replay_buffers[static_cast<int>(data_type)];
+  const int slot = buffer.next;
+  buffer.next = (buffer.next + 1) % ReplayBuffer::kDepth;
+  if (buffer.seq[slot]) buffer.evicted_seq = buffer.seq[slot];
+  buffer.seq[slot] = pd.seq;
+  buffer.message[slot] = pd.serialize().dump();
+  write(buffer.message[slot]);
+}
+
+void NamedPipe::write(std::string data) { transport->broadcast(data); }
+
 void NamedPipe::write(const char *format, ...) {
   va_list argptr;
   char buffer[512];
@@ -424,30 +679,37 @@ void NamedPipe::write(const char *format, ...) {
 
 void NamedPipe::update_delay(unsigned new_delay) {
   pipe_delay.set(new_delay);
-  Zeal::Game::print_chat("pipe delay is now set to %i", pipe_delay);
+  Zeal::Game::print_chat("pipe heartbeat delay is now set to %i ms", pipe_delay.get());
 }
 
-// Adds the handle to the thread protected transfer queue.
-void NamedPipe::add_new_pipe_handle(const HANDLE &handle) {
-  std::scoped_lock lock(pipe_handle_mutex);
-  pipe_handle_queue.push_back(handle);
+void NamedPipe::update_coalesce(unsigned new_window) {
+  pipe_coalesce.set(new_window);
+  Zeal::Game::print_chat("pipe coalescing window is now set to %i ms", pipe_coalesce.get());
 }
 
-// Copies handles from thread protected queue to main thread vector.
+// Moves newly connected clients (accepted on the transport thread) to the active list.
 void NamedPipe::update_pipe_handles() {
-  std::scoped_lock lock(pipe_handle_mutex);
-  for (auto &h : pipe_handle_queue) pipe_handles.push_back(h);
-  pipe_handle_queue.clear();
+  if (transport->update_clients()) mark_dirty(kTopicAll);  // Send a full snapshot to the new client(s).
 }
 
 NamedPipe::NamedPipe(ZealService *zeal) {
-  zeal->tick->AddTickCallback([this]() { chat_msg(TICK_MESSAGE, 0); });
+  zeal->tick->AddTickCallback([this]() {
+    chat_msg(TICK_MESSAGE, 0);
+    mark_dirty(kTopicLabel | kTopicGauge);  // Buff ticks and the server tick gauge.
+  });
   zeal->chat_hook->add_print_chat_callback([this](const char *data, int color_index) { chat_msg(data, color_index); });
   zeal->callbacks->AddGeneric([this]() { main_loop(); });
-  zeal->commands_hook->Add("/pipedelay", {}, "delay between the pipe loop output in milliseconds",
+  zeal->callbacks->AddGeneric([this]() { mark_dirty(kTopicAll); }, callback_type::EnterZone);
+  zeal->callbacks->AddPacket(
+      [this](UINT opcode, char *buffer, UINT len) {
+        if (is_connected()) handle_packet(opcode);
+        return false;  // continue processing
+      },
+      callback_type::WorldMessagePost);
+  zeal->commands_hook->Add("/pipedelay", {}, "heartbeat delay between full pipe state resyncs in milliseconds",
                            [this](std::vector<std::string> &args) {
                              if (args.size() > 1) {
-                               int del = 100;
+                               int del = 1000;
                                Zeal::String::tryParse(args[1], &del);
                                update_delay(del);
                              } else {
@@ -456,6 +718,35 @@ NamedPipe::NamedPipe(ZealService *zeal) {
                              return true;  // return true to stop the game from processing any further on this command,
                                            // false if you want to just add features to an existing cmd
                            });
+  zeal->commands_hook->Add("/pipecoalesce", {}, "minimum milliseconds between pipe updates of the same state",
+                           [this](std::vector<std::string> &args) {
+                             int window = 0;
+                             if (args.size() > 1 && Zeal::String::tryParse(args[1], &window) && window >= 0)
+                               update_coalesce(window);
+                             else
+                               Zeal::Game::print_chat("usage: /pipecoalesce <ms> (currently %i ms)",
+                                                      pipe_coalesce.get());
+                             return true;
+                           });
+  zeal->commands_hook->Add(
+      "/pipechat", {}, "controls batching of chat lines sent over the pipe", [this](std::vector<std::string> &args) {
+        int value = 0;
+        if (args.size() == 3 && args[1] == "batch" && (args[2] == "on" || args[2] == "off")) {
+          flush_chat();
+          pipe_chat_batch.set(args[2] == "on");
+        } else if (args.size() == 3 && args[1] == "interval" && Zeal::String::tryParse(args[2], &value) && value >= 0) {
+          pipe_chat_interval.set(value);
+        } else if (args.size() == 3 && args[1] == "size" && Zeal::String::tryParse(args[2], &value) && value > 0) {
+          pipe_chat_batch_size.set(value);
+        } else if (args.size() > 1) {
+          Zeal::Game::print_chat("usage: /pipechat [batch <on|off>] [interval <ms>] [size <bytes>]");
+          return true;
+        }
+        Zeal::Game::print_chat("pipe chat batch: %s, interval: %i ms, size: %i bytes",
+                               pipe_chat_batch.get() ? "on" : "off", pipe_chat_interval.get(),
+                               pipe_chat_batch_size.get());
+        return true;
+      });
   zeal->commands_hook->Add("/pipeverbose", {}, "toggle verbose pipe output with additional fields",
                            [this](std::vector<std::string> &args) {
                              if (args.size() > 1) {
@@ -480,65 +771,19 @@ NamedPipe::NamedPipe(ZealService *zeal) {
   });
   // zeal->hooks->Add("logtextfile", 0x5240dc, log_hook, hook_type_detour); //receiving this via print chat so we can
   // get color indexes
-  name += std::to_string(GetCurrentProcessId());
-  pipe_thread = std::thread([this]() {
-    while (!end_thread) {
-      HANDLE pipe_handle = CreateNamedPipeA(name.c_str(), PIPE_ACCESS_OUTBOUND | FILE_FLAG_OVERLAPPED,
-                                            PIPE_TYPE_BYTE | PIPE_WAIT | PIPE_READMODE_BYTE, PIPE_UNLIMITED_INSTANCES,
-                                            32768, 32768, NMPWAIT_USE_DEFAULT_WAIT, NULL);
-      if (pipe_handle != INVALID_HANDLE_VALUE) {
-        OVERLAPPED overlapped;
-        memset(&overlapped, 0, sizeof(overlapped));
-        overlapped.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
-        if (overlapped.hEvent == NULL) {
-          MessageBoxA(0, "Unable to create pipe event", "Pipe error", 0);
-          CloseHandle(pipe_handle);
-          end_thread = true;
-          continue;
-        }
-        // Connect named pipe with overlapped I/O
-        if (ConnectNamedPipe(pipe_handle, &overlapped)) {
-          // Connection succeeded immediately
-          add_new_pipe_handle(pipe_handle);
-        } else {
-          // Check if connection is pending
-          DWORD error = GetLastError();
-          if (error == ERROR_IO_PENDING) {
-            // Wait for the connection with a timeout
-            DWORD result = WaitForSingleObject(overlapped.hEvent, 500);
-            if (result == WAIT_OBJECT_0) {
-              // Connection completed successfully
-              add_new_pipe_handle(pipe_handle);
-            } else if (result == WAIT_TIMEOUT) {
-              // Timeout occurred, cancel the pending operation
-              CancelIo(pipe_handle);
-              CloseHandle(pipe_handle);
-            } else {
-              // Handle error
-              CloseHandle(pipe_handle);
-            }
-          } else {
-            MessageBoxA(0, "Unhandled error in named pipe", "Pipe error", 0);
-            // Handle error
-            CloseHandle(pipe_handle);
-          }
-        }
-
-        // Cleanup
-        CloseHandle(overlapped.hEvent);
-      }
-    }
-  });
-  pipe_thread.detach();
+  zeal->commands_hook->Add("/pipecommands", {}, "toggle execution of commands and targeting sent by pipe clients",
+                           [this](std::vector<std::string> &args) {
+                             if (args.size() > 1 && args[1] == "on")
+                               pipe_commands.set(true);
+                             else if (args.size() > 1 && args[1] == "off")
+                               pipe_commands.set(false);
+                             else
+                               pipe_commands.toggle();
+                             Zeal::Game::print_chat("pipe commands are now %s", pipe_commands.get() ? "on" : "off");
+                             return true;
+                           });
+  transport = std::make_unique<Win32PipeTransport>(name + std::to_string(GetCurrentProcessId()),
+                                                   [this](const std::string &line) { receive_line(line); });
 }
 
-NamedPipe::~NamedPipe() {
-  end_thread = true;
-  if (pipe_thread.joinable()) pipe_thread.join();
-
-  update_pipe_handles();  // Just in case copy over queued handles for cleanup.
-  for (auto &h : pipe_handles) {
-    DisconnectNamedPipe(h);
-    CloseHandle(h);
-  }
-}
\ No newline at end of file
+NamedPipe::~NamedPipe() {}
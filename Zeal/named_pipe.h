@@ -1,25 +1,29 @@
 #pragma once
 #include <Windows.h>
 
-#include <mutex>
+#include <memory>
 #include <string>
-#include <thread>
-#include <vector>
 
+#include "game_structures.h"
 #include "json.hpp"
+#include "lockfree_queue.h"
+#include "pipe_transport.h"
 #include "zeal_settings.h"
 
-enum struct pipe_data_type { log, label, gauge, player, custom, raid, group };
+enum struct pipe_data_type { log, label, gauge, player, custom, raid, group, log_batch, resync, item_search };
+static constexpr int kNumPipeDataTypes = static_cast<int>(pipe_data_type::item_search) + 1;
 
 struct pipe_data {
   pipe_data_type type;
   std::string data;
   std::string character;
-  pipe_data(pipe_data_type _type, std::string _data);
+  unsigned long long seq = 0;  // Monotonically increasing across all messages of the session.
+  pipe_data(pipe_data_type _type, const std::string &_data);
   pipe_data() : type(pipe_data_type::custom), data{""}, character{""} {};
 
   nlohmann::json serialize() const {
-    return nlohmann::json{{"type", type}, {"data_len", data.length()}, {"data", data}, {"character", character}};
+    return nlohmann::json{
+        {"type", type}, {"data_len", data.length()}, {"data", data}, {"character", character}, {"seq", seq}};
   }
 
   void deserialize(nlohmann::json json_obj) {
@@ -28,28 +32,105 @@ struct pipe_data {
   }
 };
 
+// Inbound client request, parsed on the pipe thread and executed on the game thread.
+struct PipeCommand {
+  enum class Type { Command, Target, Snapshot, Resync, ItemSearch };
+  Type type = Type::Command;
+  std::string data;                 // Slash command, target name or item search query.
+  unsigned topics = 0;              // Snapshot topics.
+  unsigned long long last_seq = 0;  // Resync: last sequence number the client processed.
+  unsigned limit = 0;               // Item search: maximum number of results.
+};
+
 class NamedPipe {
  public:
   NamedPipe(class ZealService *zeal);
   ~NamedPipe();
   void chat_msg(const char *data, int color_index);
-  void write(std::string data, pipe_data_type data_type);
+  void write(const std::string &data, pipe_data_type data_type);
   void write(std::string data);
   void write(const char *format, ...);
   void main_loop();
   void update_delay(unsigned new_delay);
+  void update_coalesce(unsigned new_window);
 
-  bool is_connected() const { return pipe_handles.size() != 0; }
+  bool is_connected() const { return transport && transport->client_count() != 0; }
 
  private:
-  void add_new_pipe_handle(const HANDLE &handle);
+  // Bitmask of the state topics written by the main loop. Topics are marked dirty by game events
+  // and change detection and then published at most once per coalescing window.
+  enum Topic : unsigned {
+    kTopicRaid = 1 << 0,
+    kTopicGroup = 1 << 1,
+    kTopicLabel = 1 << 2,
+    kTopicGauge = 1 << 3,
+    kTopicPlayer = 1 << 4,
+    kTopicAll = (1 << 5) - 1,
+  };
+  static constexpr int kNumTopics = 5;
+
+  // Small per-frame snapshot of state that changes without a packet callback.
+  struct FrameState {
+    WORD target_id = 0;
+    int hp = 0;
+    int mana = 0;
+    WORD casting_spell_id = Zeal::GameStructures::kInvalidSpellId;
+    DWORD zone_id = 0;
+    Vec3 position;
+    float heading = 0;
+    BYTE autoattack = 0;
+    Vec3 group_position[GAME_NUM_GROUP_MEMBERS];
+    uint32_t raid_entity_hash = 0;  // Carried over between the raid scans.
+  };
+
   void update_pipe_handles();
-  ZealSetting<int> pipe_delay = {100, "Zeal", "PipeDelay", false};
+  void flush_chat();
+  void mark_dirty(unsigned topics);
+  void handle_packet(UINT opcode);
+  void detect_changes(ULONGLONG now);
+  uint32_t get_raid_entity_hash() const;
+  ULONGLONG get_coalesce_window() const;
+  void publish_dirty(ULONGLONG now);
+  void publish_topic(int index, ULONGLONG now);
+  void receive_line(const std::string &line);
+  static unsigned parse_topics(const std::string &names);
+  void process_commands();
+  void resync(unsigned long long last_seq);
+  void search_items(const std::string &query, unsigned limit);
+  void publish_raid();
+  void publish_group();
+  void publish_labels();
+  void publish_gauges();
+  void publish_player();
+
+  ZealSetting<int> pipe_delay = {1000, "Zeal", "PipeDelay", false};  // Heartbeat (full resync) period.
+  ZealSetting<int> pipe_coalesce = {50, "Zeal", "PipeCoalesce", false};
   ZealSetting<bool> pipe_verbose = {false, "Zeal", "PipeVerbose", false};
-  bool end_thread = false;
+  ZealSetting<bool> pipe_chat_batch = {false, "Zeal", "PipeChatBatch", false};  // Opt-in: older clients need type 0.
+  ZealSetting<int> pipe_chat_interval = {0, "Zeal", "PipeChatInterval", false};       // 0 = flush every frame.
+  ZealSetting<int> pipe_chat_batch_size = {8192, "Zeal", "PipeChatBatchSize", false};  // Flush at this many bytes.
+  ZealSetting<bool> pipe_commands = {false, "Zeal", "PipeCommands", false};  // Allow clients to act in game.
+  ZealSetting<int> pipe_command_budget = {8, "Zeal", "PipeCommandBudget", false};  // Max requests per frame.
+  unsigned dirty_topics = kTopicAll;
+  ULONGLONG last_publish[kNumTopics] = {};
+  ULONGLONG last_heartbeat = 0;
+  ULONGLONG last_raid_scan = 0;
+  FrameState frame_state;
+  std::string chat_batch;  // Pending log_batch json array (reused across flushes).
+  std::string chat_line;   // Reused buffer for unbatched lines.
+  ULONGLONG chat_batch_start = 0;
   std::string name = "\\\\.\\pipe\\zeal_";
-  std::vector<HANDLE> pipe_handles;
-  std::vector<HANDLE> pipe_handle_queue;  // Mutex protected transfer queue.
-  std::thread pipe_thread;
-  std::mutex pipe_handle_mutex;
+  // Recent serialized messages of one pipe_data_type, kept for replay on a client resync request.
+  struct ReplayBuffer {
+    static constexpr int kDepth = 32;
+    unsigned long long seq[kDepth] = {};
+    std::string message[kDepth];  // Slots are reassigned in place to reuse their capacity.
+    int next = 0;
+    unsigned long long evicted_seq = 0;  // Highest sequence number that has been overwritten.
+  };
+
+  unsigned long long sequence = 0;
+  ReplayBuffer replay_buffers[kNumPipeDataTypes];
+  LockFreeQueue<PipeCommand, 256> command_queue;
+  std::unique_ptr<PipeTransport> transport;  // Destroyed first: joins the thread that pushes to the queue.
 };
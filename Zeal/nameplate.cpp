@@ -817,6 +817,7 @@ static bool distance_comparison(const Zeal::GameStructures::Entity *a, const Zea
 bool NamePlate::handle_tag_target(const std::string &target_text) {
   // Scan all nameplates for tag_text that contains the target text.
   std::vector<Zeal::GameStructures::Entity *> matches;
+  std::vector<std::string_view> split;  // Reused for each candidate's fields.
   for (const auto &entry : nameplate_info_map) {
     const auto &tag_text = entry.second.tag_text;
     if (!entry.first || tag_text.empty() || tag_text.find(target_text) == std::string::npos) continue;
@@ -828,9 +829,8 @@ bool NamePlate::handle_tag_target(const std::string &target_text) {
     if (!current_ent || entry.first->Type != Zeal::GameEnums::NPC) continue;
 
     // There's a substring match but do a secondary exact check also.
-    auto split = Zeal::String::split_text(tag_text, kDelimiter);
-    if (!split.empty() && !split.back().empty() && split.back().back() == '\n')
-      split.back().erase(split.back().length() - 1);
+    Zeal::String::split_text(tag_text, kDelimiter, split);
+    if (!split.empty() && !split.back().empty() && split.back().back() == '\n') split.back().remove_suffix(1);
     for (const auto &field : split) {
       if (field == target_text) {
         matches.push_back(entry.first);
@@ -1018,12 +1018,13 @@ static void RemoveTagTextField(const std::string &field_text, std::string &tag_t
   // Do an initial quick check if the text is even in the original tag_text.
   if (field_text.empty() || tag_text.empty() || tag_text.find(field_text) == std::string::npos) return;
 
-  // It exists, so now check if a unique matching field and then remove it.
-  auto split = Zeal::String::split_text(tag_text, kDelimiter);
-  if (!split.empty() && !split.back().empty() && split.back().back() == '\n')
-    split.back().erase(split.back().length() - 1);
+  // It exists, so now check if a unique matching field and then remove it. This runs for every
+  // nameplate when flushing a tag, so the field list is reused.
+  static std::vector<std::string_view> split;
+  Zeal::String::split_text(tag_text, kDelimiter, split);
+  if (!split.empty() && !split.back().empty() && split.back().back() == '\n') split.back().remove_suffix(1);
   auto original_size = split.size();
-  std::erase_if(split, [&](const std::string &a) { return a == field_text; });
+  std::erase_if(split, [&](std::string_view a) { return a == field_text; });
   if (split.size() == original_size) return;  // No exact match so quick exit.
 
   // Handle the case where it went blank (all tag_text removed).
@@ -1033,9 +1034,10 @@ static void RemoveTagTextField(const std::string &field_text, std::string &tag_t
     return;
   }
 
-  tag_text = split[0];
-  for (auto i = 1; i < split.size(); ++i) tag_text += kDelimiter + split[i];
-  tag_text += "\n";
+  std::string result(split[0]);  // The fields point into tag_text, so build the new text apart.
+  for (auto i = 1; i < split.size(); ++i) result.append(kDelimiter).append(split[i]);
+  result += "\n";
+  tag_text = std::move(result);
 }
 
 // Parses "raw" (w/out any channel prefix like "Bob tells the raid, '") tag message to
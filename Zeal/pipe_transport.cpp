@@ -0,0 +1,432 @@
+#include "pipe_transport.h"
+
+#include <algorithm>
+
+#ifdef _WIN32
+#include <Windows.h>
+
+#include "game_functions.h"
+#else
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+#endif
+
+int PipeTransport::update_clients() {
+  if (!has_pending) return 0;  // Skip the lock in the common (no new clients) case.
+
+  std::scoped_lock lock(pending_mutex);
+  int count = static_cast<int>(pending_clients.size());
+  for (auto &client : pending_clients) clients.push_back(std::move(client));
+  pending_clients.clear();
+  has_pending = false;
+  return count;
+}
+
+void PipeTransport::broadcast(const std::string &data) {
+  std::erase_if(clients, [&data](const std::unique_ptr<PipeClient> &client) { return !client->write(data); });
+}
+
+void PipeTransport::add_pending_client(std::unique_ptr<PipeClient> client) {
+  std::scoped_lock lock(pending_mutex);
+  pending_clients.push_back(std::move(client));
+  has_pending = true;
+}
+
+void PipeTransport::receive(std::string &partial_line, const char *data, size_t length) const {
+  const char *end = data + length;
+  while (data < end) {
+    const char *newline = std::find(data, end, '\n');
+    partial_line.append(data, newline);
+    if (newline == end) break;
+    data = newline + 1;
+
+    if (!partial_line.empty() && partial_line.back() == '\r') partial_line.pop_back();
+    if (!partial_line.empty() && partial_line.size() <= kMaxLineLength && receive_callback)
+      receive_callback(partial_line);
+    partial_line.clear();
+  }
+
+  // Bound the memory a misbehaving client can hold. The rest of the line is dropped once the
+  // terminating newline arrives since it then exceeds the max length.
+  if (partial_line.size() > kMaxLineLength) partial_line.resize(kMaxLineLength + 1);
+}
+
+class LoopbackPipeTransport::Client : public PipeClient {
+ public:
+  explicit Client(std::shared_ptr<Endpoint> endpoint) : endpoint(std::move(endpoint)) {}
+
+  bool write(const std::string &data) override { return deliver(*endpoint, data); }
+
+ private:
+  std::shared_ptr<Endpoint> endpoint;
+};
+
+std::string LoopbackPipeTransport::Endpoint::read() {
+  std::scoped_lock lock(mutex);
+  std::string result;
+  result.swap(buffer);
+  return result;
+}
+
+size_t LoopbackPipeTransport::Endpoint::bytes_received() const {
+  std::scoped_lock lock(mutex);
+  return total_bytes;
+}
+
+void LoopbackPipeTransport::Endpoint::send(const std::string &data) {
+  std::scoped_lock lock(mutex);
+  if (connected) transport.receive(partial_line, data.data(), data.size());
+}
+
+void LoopbackPipeTransport::Endpoint::disconnect() {
+  std::scoped_lock lock(mutex);
+  connected = false;
+}
+
+std::shared_ptr<LoopbackPipeTransport::Endpoint> LoopbackPipeTransport::connect() {
+  auto endpoint = std::make_shared<Endpoint>(*this);
+  add_pending_client(std::make_unique<Client>(endpoint));
+  return endpoint;
+}
+
+bool LoopbackPipeTransport::deliver(Endpoint &endpoint, const std::string &data) {
+  std::scoped_lock lock(endpoint.mutex);
+  if (!endpoint.connected) return false;
+  endpoint.buffer += data;
+  endpoint.total_bytes += data.size();
+  return true;
+}
+
+#ifdef _WIN32
+namespace {
+
+struct PipeData {
+  OVERLAPPED overlapped;
+  HANDLE pipe;
+
+  PipeData(HANDLE h) {
+    pipe = h;
+    ZeroMemory(&overlapped, sizeof(OVERLAPPED));
+  }
+};
+
+void CALLBACK WriteCompletion(DWORD dwErrorCode, DWORD dwNumberOfBytesTransfered, LPOVERLAPPED lpOverlapped) {
+  PipeData *pData = reinterpret_cast<PipeData *>(lpOverlapped);
+  delete pData;
+}
+
+bool IsValidHandle(HANDLE h) {
+  return (h != INVALID_HANDLE_VALUE) && (GetFileType(h) != FILE_TYPE_UNKNOWN || GetLastError() == NO_ERROR);
+}
+
+bool WriteDataWithRetry(HANDLE h, const std::string &data, OVERLAPPED *pData,
+                        LPOVERLAPPED_COMPLETION_ROUTINE WriteCompletion) {
+  const int maxRetries = 3;
+  int attempt = 0;
+  if (IsValidHandle(h)) {
+    while (attempt < maxRetries) {
+      if (WriteFileEx(h, data.c_str(), static_cast<DWORD>(data.length()), pData, WriteCompletion)) {
+        return true;
+      } else {
+        DWORD errorCode = GetLastError();
+        char *errorMsg = nullptr;
+        FormatMessageA(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
+                       nullptr, errorCode, MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT),
+                       reinterpret_cast<LPSTR>(&errorMsg), 0, nullptr);
+
+        if (errorCode != 232)  // the pipe is being closed -- when closing the other end abruptly
+        {
+          if (errorMsg) {
+            Zeal::Game::print_chat("WriteFileEx failed on attempt %i with error %u: %s", attempt + 1, errorCode,
+                                   errorMsg);
+            Zeal::Game::print_chat("Parameters [%i] [%s] [%i] [%i]", h, data.c_str(), data.length(), pData);
+            LocalFree(errorMsg);  // Free the buffer allocated by FormatMessage
+          } else {
+            Zeal::Game::print_chat("WriteFileEx failed on attempt %i with error %u", attempt + 1, errorCode);
+          }
+        }
+
+        Sleep(10);
+        attempt++;
+      }
+    }
+  }
+
+  return false;
+}
+
+// Pipe instance shared by the writing client (game thread) and its reader (pipe thread). The
+// handle is closed once both sides are done with it.
+struct Win32Connection {
+  HANDLE handle;
+
+  explicit Win32Connection(HANDLE h) : handle(h) {}
+
+  ~Win32Connection() {
+    DisconnectNamedPipe(handle);
+    CloseHandle(handle);
+  }
+};
+
+class Win32PipeClient : public PipeClient {
+ public:
+  explicit Win32PipeClient(std::shared_ptr<Win32Connection> connection) : connection(std::move(connection)) {}
+
+  bool write(const std::string &data) override {
+    PipeData *pData = new PipeData(connection->handle);
+    if (WriteDataWithRetry(connection->handle, data, reinterpret_cast<LPOVERLAPPED>(pData), WriteCompletion))
+      return true;
+    delete pData;
+    return false;
+  }
+
+ private:
+  std::shared_ptr<Win32Connection> connection;
+};
+
+// Overlapped read state of one client. Owned by the pipe thread (which issues the reads, as CancelIo
+// requires).
+struct Win32Reader {
+  std::shared_ptr<Win32Connection> connection;
+  OVERLAPPED overlapped = {};
+  char buffer[1024];
+  std::string partial_line;
+  bool read_issued = false;  // The kernel may still write to buffer and overlapped.
+
+  explicit Win32Reader(std::shared_ptr<Win32Connection> connection) : connection(std::move(connection)) {
+    overlapped.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+  }
+
+  ~Win32Reader() {
+    // Wait for the cancelled read to complete so it can't write into the freed buffer and overlapped.
+    if (read_issued) {
+      DWORD unused = 0;
+      CancelIo(connection->handle);
+      GetOverlappedResult(connection->handle, &overlapped, &unused, TRUE);
+    }
+    if (overlapped.hEvent) CloseHandle(overlapped.hEvent);
+  }
+
+  // Issues the next read. The event is signaled on completion (including immediate completion).
+  bool start_read() {
+    ResetEvent(overlapped.hEvent);
+    read_issued = ReadFile(connection->handle, buffer, sizeof(buffer), NULL, &overlapped) ||
+                  GetLastError() == ERROR_IO_PENDING;
+    return read_issued;
+  }
+
+  // Collects the result of the signaled read. Returns false if it failed (the client closed).
+  bool finish_read(DWORD &bytes_read) {
+    read_issued = false;
+    return GetOverlappedResult(connection->handle, &overlapped, &bytes_read, FALSE);
+  }
+};
+
+}  // namespace
+
+Win32PipeTransport::Win32PipeTransport(const std::string &pipe_name, ReceiveCallback callback)
+    : PipeTransport(std::move(callback)), name(pipe_name) {
+  pipe_thread = std::thread([this]() { pipe_loop(); });
+}
+
+// The pipe loop waits with a timeout, so it notices end_thread within one wait period and then cancels
+// its pending connect and reads and closes the handles itself (CancelIo only applies to the calling
+// thread's I/O).
+Win32PipeTransport::~Win32PipeTransport() {
+  end_thread = true;
+  if (pipe_thread.joinable()) pipe_thread.join();
+}
+
+// Keeps one pipe instance listening for the next client while servicing the reads of the
+// connected ones with a single wait. Clients beyond the wait object limit are output only.
+void Win32PipeTransport::pipe_loop() {
+  OVERLAPPED connect_overlapped;
+  memset(&connect_overlapped, 0, sizeof(connect_overlapped));
+  connect_overlapped.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+  if (connect_overlapped.hEvent == NULL) {
+    MessageBoxA(0, "Unable to create pipe event", "Pipe error", 0);
+    return;
+  }
+
+  std::vector<std::unique_ptr<Win32Reader>> readers;
+  HANDLE listen_handle = INVALID_HANDLE_VALUE;
+
+  auto add_client = [&](HANDLE handle) {
+    auto connection = std::make_shared<Win32Connection>(handle);
+    if (readers.size() < MAXIMUM_WAIT_OBJECTS - 1) {
+      auto reader = std::make_unique<Win32Reader>(connection);
+      if (reader->overlapped.hEvent && reader->start_read()) readers.push_back(std::move(reader));
+    }
+    add_pending_client(std::make_unique<Win32PipeClient>(std::move(connection)));
+  };
+
+  while (!end_thread) {
+    if (listen_handle == INVALID_HANDLE_VALUE) {
+      listen_handle = CreateNamedPipeA(name.c_str(), PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED,
+                                       PIPE_TYPE_BYTE | PIPE_WAIT | PIPE_READMODE_BYTE, PIPE_UNLIMITED_INSTANCES,
+                                       32768, 32768, NMPWAIT_USE_DEFAULT_WAIT, NULL);
+      if (listen_handle == INVALID_HANDLE_VALUE) {
+        Sleep(500);
+        continue;
+      }
+
+      // Connect named pipe with overlapped I/O
+      ResetEvent(connect_overlapped.hEvent);
+      if (!ConnectNamedPipe(listen_handle, &connect_overlapped)) {
+        DWORD error = GetLastError();
+        if (error == ERROR_PIPE_CONNECTED) {
+          // Client connected between the create and connect calls.
+          add_client(listen_handle);
+          listen_handle = INVALID_HANDLE_VALUE;
+          continue;
+        } else if (error != ERROR_IO_PENDING) {
+          MessageBoxA(0, "Unhandled error in named pipe", "Pipe error", 0);
+          CloseHandle(listen_handle);
+          listen_handle = INVALID_HANDLE_VALUE;
+          Sleep(500);
+          continue;
+        }
+      }
+    }
+
+    HANDLE events[MAXIMUM_WAIT_OBJECTS];
+    DWORD count = 0;
+    events[count++] = connect_overlapped.hEvent;
+    for (const auto &reader : readers) events[count++] = reader->overlapped.hEvent;
+
+    // Wait with a timeout so end_thread is periodically checked.
+    DWORD result = WaitForMultipleObjects(count, events, FALSE, 500);
+    if (result == WAIT_TIMEOUT) continue;
+    DWORD index = result - WAIT_OBJECT_0;
+    if (index >= count) {
+      Sleep(10);  // Unexpected wait failure, avoid spinning.
+      continue;
+    }
+
+    if (index == 0) {
+      DWORD unused = 0;
+      if (GetOverlappedResult(listen_handle, &connect_overlapped, &unused, FALSE))
+        add_client(listen_handle);
+      else
+        CloseHandle(listen_handle);
+      listen_handle = INVALID_HANDLE_VALUE;
+      continue;
+    }
+
+    auto &reader = readers[index - 1];
+    DWORD bytes_read = 0;
+    if (reader->finish_read(bytes_read)) {
+      receive(reader->partial_line, reader->buffer, bytes_read);
+      if (reader->start_read()) continue;
+    }
+    readers.erase(readers.begin() + (index - 1));  // Client closed (or failed), stop reading.
+  }
+
+  readers.clear();
+  if (listen_handle != INVALID_HANDLE_VALUE) {
+    CancelIo(listen_handle);
+    CloseHandle(listen_handle);
+  }
+  CloseHandle(connect_overlapped.hEvent);
+}
+#else
+namespace {
+
+// Socket shared by the writing client (game thread) and its reader (socket thread).
+struct UnixConnection {
+  int fd;
+
+  explicit UnixConnection(int fd) : fd(fd) {}
+
+  ~UnixConnection() { close(fd); }
+};
+
+class UnixSocketPipeClient : public PipeClient {
+ public:
+  explicit UnixSocketPipeClient(std::shared_ptr<UnixConnection> connection) : connection(std::move(connection)) {}
+
+  bool write(const std::string &data) override {
+    size_t offset = 0;
+    while (offset < data.size()) {
+      ssize_t sent = send(connection->fd, data.data() + offset, data.size() - offset, MSG_NOSIGNAL);
+      if (sent <= 0) return false;
+      offset += static_cast<size_t>(sent);
+    }
+    return true;
+  }
+
+ private:
+  std::shared_ptr<UnixConnection> connection;
+};
+
+struct UnixReader {
+  std::shared_ptr<UnixConnection> connection;
+  std::string partial_line;
+};
+
+}  // namespace
+
+UnixSocketPipeTransport::UnixSocketPipeTransport(const std::string &socket_path, ReceiveCallback callback)
+    : PipeTransport(std::move(callback)), path(socket_path) {
+  sockaddr_un addr = {};
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path)) return;  // Leaves the transport without any clients.
+  std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+  unlink(path.c_str());
+  listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listen_fd < 0) return;
+  if (bind(listen_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || listen(listen_fd, 16) != 0) {
+    close(listen_fd);
+    listen_fd = -1;
+    return;
+  }
+  socket_thread = std::thread([this]() { socket_loop(); });
+}
+
+UnixSocketPipeTransport::~UnixSocketPipeTransport() {
+  end_thread = true;
+  if (socket_thread.joinable()) socket_thread.join();
+  if (listen_fd >= 0) {
+    close(listen_fd);
+    unlink(path.c_str());
+  }
+}
+
+void UnixSocketPipeTransport::socket_loop() {
+  std::vector<UnixReader> readers;
+  std::vector<pollfd> fds;
+  while (!end_thread) {
+    fds.clear();
+    fds.push_back({listen_fd, POLLIN, 0});
+    for (const auto &reader : readers) fds.push_back({reader.connection->fd, POLLIN, 0});
+
+    if (poll(fds.data(), fds.size(), 500) <= 0) continue;  // Timeout so end_thread is periodically checked.
+
+    // Service reads back to front (before accepting) so the fds indices still line up with the readers.
+    for (size_t i = fds.size() - 1; i > 0; --i) {
+      if (!fds[i].revents) continue;
+      UnixReader &reader = readers[i - 1];
+      char buffer[1024];
+      ssize_t bytes_read = recv(reader.connection->fd, buffer, sizeof(buffer), 0);
+      if (bytes_read > 0)
+        receive(reader.partial_line, buffer, static_cast<size_t>(bytes_read));
+      else
+        readers.erase(readers.begin() + (i - 1));  // Client closed (or failed), stop reading.
+    }
+
+    if (fds[0].revents & POLLIN) {
+      int fd = accept(listen_fd, nullptr, nullptr);
+      if (fd >= 0) {
+        auto connection = std::make_shared<UnixConnection>(fd);
+        readers.push_back({connection, {}});
+        add_pending_client(std::make_unique<UnixSocketPipeClient>(std::move(connection)));
+      }
+    }
+  }
+}
+#endif
@@ -0,0 +1,122 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// A single connected pipe client. All calls are made from the game thread.
+class PipeClient {
+ public:
+  virtual ~PipeClient() = default;
+
+  // Writes the data to the client. Returns false if the client is gone and should be dropped.
+  virtual bool write(const std::string &data) = 0;
+};
+
+// Owns the connected clients of the pipe. Implementations accept new clients on their own thread
+// and hand them over through a mutex protected queue that the game thread drains in update_clients(),
+// so the per-frame broadcast path never takes the lock. The transport only moves bytes; message
+// framing and content stay with the NamedPipe.
+//
+// Inbound data from clients is split into newline terminated lines that are passed to the receive
+// callback on the transport's thread (never the game thread).
+class PipeTransport {
+ public:
+  using ReceiveCallback = std::function<void(const std::string &line)>;
+  static constexpr size_t kMaxLineLength = 4096;  // Longer inbound lines are discarded.
+
+  explicit PipeTransport(ReceiveCallback callback = nullptr) : receive_callback(std::move(callback)) {}
+  virtual ~PipeTransport() = default;
+
+  // Moves newly accepted clients to the active list. Returns the number of clients added.
+  int update_clients();
+
+  // Writes the data to every active client and drops any that fail.
+  void broadcast(const std::string &data);
+
+  size_t client_count() const { return clients.size(); }
+
+ protected:
+  // Queues a newly accepted client for the game thread. Thread safe.
+  void add_pending_client(std::unique_ptr<PipeClient> client);
+
+  // Appends received bytes to a client's partial line and reports every completed line.
+  void receive(std::string &partial_line, const char *data, size_t length) const;
+
+ private:
+  const ReceiveCallback receive_callback;
+  std::vector<std::unique_ptr<PipeClient>> clients;
+  std::vector<std::unique_ptr<PipeClient>> pending_clients;  // Mutex protected transfer queue.
+  std::mutex pending_mutex;
+  std::atomic<bool> has_pending = false;
+};
+
+// In-process transport that hands out endpoints instead of OS handles. It has no platform
+// dependencies so the pipe protocol can be exercised (and measured) with simulated clients.
+class LoopbackPipeTransport : public PipeTransport {
+ public:
+  // Client side of a loopback connection. Thread safe.
+  class Endpoint {
+   public:
+    explicit Endpoint(const LoopbackPipeTransport &transport) : transport(transport) {}
+
+    std::string read();  // Returns and clears the data received since the last read.
+    size_t bytes_received() const;
+    void send(const std::string &data);  // Delivered to the receive callback on the calling thread.
+    void disconnect();                   // The transport drops the client on its next write.
+
+   private:
+    friend class LoopbackPipeTransport;
+
+    const LoopbackPipeTransport &transport;
+    mutable std::mutex mutex;
+    std::string buffer;
+    std::string partial_line;
+    size_t total_bytes = 0;
+    bool connected = true;
+  };
+
+  explicit LoopbackPipeTransport(ReceiveCallback callback = nullptr) : PipeTransport(std::move(callback)) {}
+
+  // Connects a new simulated client. Thread safe (may be called from any thread).
+  std::shared_ptr<Endpoint> connect();
+
+ private:
+  class Client;
+  static bool deliver(Endpoint &endpoint, const std::string &data);
+};
+
+#ifdef _WIN32
+// Win32 named pipe transport. A background thread creates duplex pipe instances with the given name,
+// waits (with a timeout so it can exit) for clients to connect and reads their inbound data.
+class Win32PipeTransport : public PipeTransport {
+ public:
+  Win32PipeTransport(const std::string &pipe_name, ReceiveCallback callback);
+  ~Win32PipeTransport();
+
+ private:
+  void pipe_loop();
+
+  std::string name;
+  std::atomic<bool> end_thread = false;
+  std::thread pipe_thread;
+};
+#else
+// POSIX Unix-domain stream socket transport with the same accept and read on a thread behavior.
+class UnixSocketPipeTransport : public PipeTransport {
+ public:
+  UnixSocketPipeTransport(const std::string &socket_path, ReceiveCallback callback);
+  ~UnixSocketPipeTransport();
+
+ private:
+  void socket_loop();
+
+  std::string path;
+  int listen_fd = -1;
+  std::atomic<bool> end_thread = false;
+  std::thread socket_thread;
+};
+#endif
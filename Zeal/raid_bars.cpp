@@ -335,7 +335,8 @@ void RaidBars::SyncClassPriority() {
   // Capitalize to simplify comparisons.
   std::transform(priority_list.begin(), priority_list.end(), priority_list.begin(), ::toupper);
 
-  auto split = Zeal::String::split_text(priority_list, " ");
+  std::vector<std::string_view> split;
+  Zeal::String::split_text(priority_list, " ", split);
   std::vector<int> entries;
   for (const auto &entry : split) {
     for (int i = 0; i < class_priority.size(); ++i) {
@@ -372,7 +373,8 @@ void RaidBars::SyncClassAlways() {
   // Capitalize to simplify comparisons.
   std::transform(always_list.begin(), always_list.end(), always_list.begin(), ::toupper);
 
-  auto split = Zeal::String::split_text(always_list, " ");
+  std::vector<std::string_view> split;
+  Zeal::String::split_text(always_list, " ", split);
   for (const auto &entry : split) {
     for (int i = 0; i < kNumClasses; ++i) {
       if (entry == Zeal::Game::class_name_short(i + kClassIndexOffset)) {
@@ -394,7 +396,8 @@ void RaidBars::SyncClassNever() {
   // Capitalize to simplify comparisons.
   std::transform(never_list.begin(), never_list.end(), never_list.begin(), ::toupper);
 
-  auto split = Zeal::String::split_text(never_list, " ");
+  std::vector<std::string_view> split;
+  Zeal::String::split_text(never_list, " ", split);
   for (const auto &entry : split) {
     for (int i = 0; i < kNumClasses; ++i) {
       if (entry == Zeal::Game::class_name_short(i + kClassIndexOffset)) {
@@ -416,7 +419,8 @@ void RaidBars::SyncClassFilter() {
   // Capitalize to simplify comparisons.
   std::transform(filter_list.begin(), filter_list.end(), filter_list.begin(), ::toupper);
 
-  auto split = Zeal::String::split_text(filter_list, " ");
+  std::vector<std::string_view> split;
+  Zeal::String::split_text(filter_list, " ", split);
   for (const auto &entry : split) {
     for (int i = 0; i < kNumClasses; ++i) {
       if (entry == Zeal::Game::class_name_short(i + kClassIndexOffset)) {
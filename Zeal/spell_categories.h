@@ -3,7 +3,9 @@
 
 #include <algorithm>
 #include <array>
+#include <cstdint>
 #include <string>
+#include <string_view>
 
 // original credits for this go to mmofry
 struct SpellCat {
@@ -2341,696 +2343,442 @@ static constexpr std::array<TransportEntry, 157> alt_transport_lut = {{
     {3921, 164},  // Guide Evacuation,
 }};
 
-SpellCat getSpellCategoryAndSubcategory(int spellID, bool use_alt_transport) {
-  // Perform binary search for the spellID.
-  auto it = std::lower_bound(spell_cat_lut.begin(), spell_cat_lut.end(), spellID,
-                             [](const SpellCatEntry &entry, int value) { return entry.spell_id < value; });
+// Dense copies of the luts above indexed by spell id, built at compile time so a lookup is a single
+// index instead of two binary searches. Category and subcategory ids fit in a byte.
+struct SpellCatCode {
+  uint8_t category = 0;  // Zero if the spell is not categorized.
+  uint8_t subcategory = 0;
+  uint8_t name_index = 0;  // One based index into spell_new_names (zero keeps the game name).
+};
 
-  if (it != spell_cat_lut.end() && it->spell_id == spellID) {
-    auto spell_cat = it->spell_cat;
-    if (it->spell_cat.Category == 123 && use_alt_transport) {
-      // Look up the alternative sub-categorization for transport spells.
-      auto alt_it = std::lower_bound(alt_transport_lut.begin(), alt_transport_lut.end(), spellID,
-                                     [](const TransportEntry &entry, int value) { return entry.spell_id < value; });
-      if (alt_it != alt_transport_lut.end() && alt_it->spell_id == spellID)
-        spell_cat.SubCategory = alt_it->transport_type;
-    }
-    return spell_cat;
-  }
+static constexpr size_t kSpellCatTableSize = spell_cat_lut.back().spell_id + 1;
 
-  return SpellCat(0, 0);  // or throw std::out_of_range("Spell ID not found");
+static constexpr size_t count_spell_new_names() {
+  size_t count = 0;
+  for (const auto &entry : spell_cat_lut) count += (entry.spell_cat.NewName != nullptr);
+  return count;
 }
 
-static inline std::string GetSpellCategoryName(DWORD categoryID) {
-  switch (categoryID) {
-    case 1:
-      return "Aegolism";
-    case 2:
-      return "Agility";
-    case 3:
-      return "Alliance";
-    case 4:
-      return "Animal";
-    case 5:
-      return "Antonica";
-    case 6:
-      return "Armor Class";
-    case 7:
-      return "Attack";
-    case 8:
-      return "Bane";
-    case 9:
-      return "Blind";
-    case 10:
-      return "Block";
-    case 11:
-      return "Calm";
-    case 12:
-      return "Charisma";
-    case 13:
-      return "Charm";
-    case 14:
-      return "Cold";
-    case 15:
-      return "Combat Abilities";
-    case 16:
-      return "Combat Innates";
-    case 17:
-      return "Conversions";
-    case 18:
-      return "Create Item";
-    case 19:
-      return "Cure";
-    case 20:
-      return "Damage Over Time";
-    case 21:
-      return "Damage Shield";
-    case 22:
-      return "Defensive";
-    case 23:
-      return "Destroy";
-    case 24:
-      return "Dexterity";
-    case 25:
-      return "Direct Damage ";
-    case 26:
-      return "Disarm Traps";
-    case 27:
-      return "Disciplines";
-    case 28:
-      return "Discord";
-    case 29:
-      return "Disease";
-    case 30:
-      return "Disempowering";
-    case 31:
-      return "Dispel";
-    case 32:
-      return "Duration Heals";
-    case 33:
-      return "Duration Tap";
-    case 34:
-      return "Enchant Metal";
-    case 35:
-      return "Enthrall";
-    case 36:
-      return "Faydwer";
-    case 37:
-      return "Fear";
-    case 38:
-      return "Fire";
-    case 39:
-      return "Fizzle Rate";
-    case 40:
-      return "Fumble";
-    case 41:
-      return "Haste";
-    case 42:
-      return "Heals";
-    case 43:
-      return "Health";
-    case 44:
-      return "Health/Mana";
-    case 45:
-      return "HP Buffs";
-    case 46:
-      return "HP type one";
-    case 47:
-      return "HP type two";
-    case 48:
-      return "Illusion: Other";
-    case 49:
-      return "Illusion: Player";
-    case 50:
-      return "Imbue Gem";
-    case 51:
-      return "Invisibility";
-    case 52:
-      return "Invulnerability";
-    case 53:
-      return "Jolt";
-    case 54:
-      return "Kunark";
-    case 55:
-      return "Levitate";
-    case 56:
-      return "Life Flow";
-    case 57:
-      return "Luclin";
-    case 58:
-      return "Magic";
-    case 59:
-      return "Mana";
-    case 60:
-      return "Mana Drain";
-    case 61:
-      return "Mana Flow";
-    case 62:
-      return "Melee Guard";
-    case 63:
-      return "Memory Blur";
-    case 64:
-      return "Misc";
-    case 65:
-      return "Movement";
-    case 66:
-      return "Objects";
-    case 67:
-      return "Odus";
-    case 68:
-      return "Offensive";
-    case 69:
-      return "Pet";
-    case 70:
-      return "Pet Haste";
-    case 71:
-      return "Pet Misc Buffs";
-    case 72:
-      return "Physical";
-    case 73:
-      return "Picklock";
-    case 74:
-      return "Plant";
-    case 75:
-      return "Poison";
-    case 76:
-      return "Power Tap";
-    case 77:
-      return "Quick Heal";
-    case 78:
-      return "Reflection";
-    case 79:
-      return "Regen";
-    case 80:
-      return "Resist Buff";
-    case 81:
-      return "Resist Debuffs";
-    case 82:
-      return "Resurrection";
-    case 83:
-      return "Root";
-    case 84:
-      return "Rune";
-    case 85:
-      return "Sense Trap";
-    case 86:
-      return "Shadowstep";
-    case 87:
-      return "Shielding";
-    case 88:
-      return "Slow";
-    case 89:
-      return "Snare";
-    case 90:
-      return "Special";
-    case 91:
-      return "Spell Focus";
-    case 92:
-      return "Spell Guard";
-    case 93:
-      return "Spellshield";
-    case 94:
-      return "Stamina";
-    case 95:
-      return "Statistic Buffs";
-    case 96:
-      return "Strength";
-    case 97:
-      return "Stun";
-    case 98:
-      return "Sum: Air";
-    case 99:
-      return "Sum: Animation";
-    case 100:
-      return "Sum: Earth";
-    case 101:
-      return "Sum: Familiar";
-    case 102:
-      return "Sum: Fire";
-    case 103:
-      return "Sum: Undead";
-    case 104:
-      return "Sum: Warder";
-    case 105:
-      return "Sum: Water";
-    case 106:
-      return "Summon Armor";
-    case 107:
-      return "Summon Focus";
-    case 108:
-      return "Summon Food/Water";
-    case 109:
-      return "Summon Utility";
-    case 110:
-      return "Summon Weapon";
-    case 111:
-      return "Summoned";
-    case 112:
-      return "Symbol";
-    case 113:
-      return "Taelosia";
-    case 114:
-      return "Taps";
-    case 115:
-      return "Techniques";
-    case 116:
-      return "The Planes";
-    case 117:
-      return "Timer 1";
-    case 118:
-      return "Timer 2";
-    case 119:
-      return "Timer 3";
-    case 120:
-      return "Timer 4";
-    case 121:
-      return "Timer 5";
-    case 122:
-      return "Timer 6";
-    case 123:
-      return "Transport";
-    case 124:
-      return "Undead";
-    case 125:
-      return "Utility Beneficial";
-    case 126:
-      return "Utility Detrimental";
-    case 127:
-      return "Velious";
-    case 128:
-      return "Visages";
-    case 129:
-      return "Vision";
-    case 130:
-      return "Wisdom/Intelligence";
-    case 131:
-      return "Traps";
-    case 132:
-      return "Auras";
-    case 133:
-      return "Endurance";
-    case 134:
-      return "Serpent's Spine";
-    case 135:
-      return "Corruption";
-    case 136:
-      return "Learning";
-    case 137:
-      return "Chromatic";
-    case 138:
-      return "Prismatic";
-    case 139:
-      return "Sum: Swarm";
-    case 140:
-      return "Delayed";
-    case 141:
-      return "Temporary";
-    case 142:
-      return "Twincast";
-    case 143:
-      return "Sum: Bodyguard";
-    case 144:
-      return "Humanoid";
-    case 145:
-      return "Haste/Spell Focus";
-    case 146:
-      return "Timer 7";
-    case 147:
-      return "Timer 8";
-    case 148:
-      return "Timer 9";
-    case 149:
-      return "Timer 10";
-    case 150:
-      return "Timer 11";
-    case 151:
-      return "Timer 12";
-    case 152:
-      return "Hatred";
-    case 153:
-      return "Fast";
-    case 154:
-      return "Illusion: Special";
-    case 155:
-      return "Timer 13";
-    case 156:
-      return "Timer 14";
-    case 157:
-      return "Timer 15";
-    case 158:
-      return "Timer 16";
-    case 159:
-      return "Timer 17";
-    case 160:
-      return "Timer 18";
-    case 161:
-      return "Timer 19";
-    case 162:
-      return "Timer 20";
-    case 163:
-      return "Alaris";
-    default:
-      return "Unknown";
+static constexpr std::array<const char *, count_spell_new_names()> spell_new_names = [] {
+  std::array<const char *, count_spell_new_names()> names = {};
+  size_t count = 0;
+  for (const auto &entry : spell_cat_lut)
+    if (entry.spell_cat.NewName) names[count++] = entry.spell_cat.NewName;
+  return names;
+}();
+
+static constexpr std::array<SpellCatCode, kSpellCatTableSize> spell_cat_table = [] {
+  std::array<SpellCatCode, kSpellCatTableSize> table = {};
+  uint8_t name_count = 0;
+  for (const auto &entry : spell_cat_lut) {
+    SpellCatCode &code = table[entry.spell_id];
+    code.category = static_cast<uint8_t>(entry.spell_cat.Category);
+    code.subcategory = static_cast<uint8_t>(entry.spell_cat.SubCategory);
+    if (entry.spell_cat.NewName) code.name_index = ++name_count;
   }
+  return table;
+}();
+
+// Alternate transport subcategory overlay (zero if the spell has none).
+static constexpr std::array<uint8_t, kSpellCatTableSize> alt_transport_table = [] {
+  std::array<uint8_t, kSpellCatTableSize> table = {};
+  for (const auto &entry : alt_transport_lut) table[entry.spell_id] = static_cast<uint8_t>(entry.transport_type);
+  return table;
+}();
+
+// Compile time checks that the luts are sorted without duplicates and that the dense tables hold
+// exactly their contents (which also catches ids that do not fit in a byte). Split into separate
+// evaluations to stay within the compiler's constexpr step limits.
+template <typename Lut>
+static constexpr bool is_sorted_by_spell_id(const Lut &lut) {
+  for (size_t i = 1; i < lut.size(); ++i)
+    if (lut[i - 1].spell_id >= lut[i].spell_id) return false;
+  return true;
 }
 
-static inline std::string GetSpellSubCategoryName(DWORD subcategoryID) {
-  switch (subcategoryID) {
-    case 1:
-      return "Aegolism";
-    case 2:
-      return "Agility";
-    case 3:
-      return "Alliance";
-    case 4:
-      return "Animal";
-    case 5:
-      return "Antonica";
-    case 6:
-      return "Armor Class";
-    case 7:
-      return "Attack";
-    case 8:
-      return "Bane";
-    case 9:
-      return "Blind";
-    case 10:
-      return "Block";
-    case 11:
-      return "Calm";
-    case 12:
-      return "Charisma";
-    case 13:
-      return "Charm";
-    case 14:
-      return "Cold";
-    case 15:
-      return "Combat Abilities";
-    case 16:
-      return "Combat Innates";
-    case 17:
-      return "Conversions";
-    case 18:
-      return "Create Item";
-    case 19:
-      return "Cure";
-    case 20:
-      return "Damage Over Time";
-    case 21:
-      return "Damage Shield";
-    case 22:
-      return "Defensive";
-    case 23:
-      return "Destroy";
-    case 24:
-      return "Dexterity";
-    case 25:
-      return "Direct Damage ";
-    case 26:
-      return "Disarm Traps";
-    case 27:
-      return "Disciplines";
-    case 28:
-      return "Discord";
-    case 29:
-      return "Disease";
-    case 30:
-      return "Disempowering";
-    case 31:
-      return "Dispel";
-    case 32:
-      return "Duration Heals";
-    case 33:
-      return "Duration Tap";
-    case 34:
-      return "Enchant Metal";
-    case 35:
-      return "Enthrall";
-    case 36:
-      return "Faydwer";
-    case 37:
-      return "Fear";
-    case 38:
-      return "Fire";
-    case 39:
-      return "Fizzle Rate";
-    case 40:
-      return "Fumble";
-    case 41:
-      return "Haste";
-    case 42:
-      return "Heals";
-    case 43:
-      return "Health";
-    case 44:
-      return "Health/Mana";
-    case 45:
-      return "HP Buffs";
-    case 46:
-      return "HP type one";
-    case 47:
-      return "HP type two";
-    case 48:
-      return "Illusion: Other";
-    case 49:
-      return "Illusion: Player";
-    case 50:
-      return "Imbue Gem";
-    case 51:
-      return "Invisibility";
-    case 52:
-      return "Invulnerability";
-    case 53:
-      return "Jolt";
-    case 54:
-      return "Kunark";
-    case 55:
-      return "Levitate";
-    case 56:
-      return "Life Flow";
-    case 57:
-      return "Luclin";
-    case 58:
-      return "Magic";
-    case 59:
-      return "Mana";
-    case 60:
-      return "Mana Drain";
-    case 61:
-      return "Mana Flow";
-    case 62:
-      return "Melee Guard";
-    case 63:
-      return "Memory Blur";
-    case 64:
-      return "Misc";
-    case 65:
-      return "Movement";
-    case 66:
-      return "Objects";
-    case 67:
-      return "Odus";
-    case 68:
-      return "Offensive";
-    case 69:
-      return "Pet";
-    case 70:
-      return "Pet Haste";
-    case 71:
-      return "Pet Misc Buffs";
-    case 72:
-      return "Physical";
-    case 73:
-      return "Picklock";
-    case 74:
-      return "Plant";
-    case 75:
-      return "Poison";
-    case 76:
-      return "Power Tap";
-    case 77:
-      return "Quick Heal";
-    case 78:
-      return "Reflection";
-    case 79:
-      return "Regen";
-    case 80:
-      return "Resist Buff";
-    case 81:
-      return "Resist Debuffs";
-    case 82:
-      return "Resurrection";
-    case 83:
-      return "Root";
-    case 84:
-      return "Rune";
-    case 85:
-      return "Sense Trap";
-    case 86:
-      return "Shadowstep";
-    case 87:
-      return "Shielding";
-    case 88:
-      return "Slow";
-    case 89:
-      return "Snare";
-    case 90:
-      return "Special";
-    case 91:
-      return "Spell Focus";
-    case 92:
-      return "Spell Guard";
-    case 93:
-      return "Spellshield";
-    case 94:
-      return "Stamina";
-    case 95:
-      return "Statistic Buffs";
-    case 96:
-      return "Strength";
-    case 97:
-      return "Stun";
-    case 98:
-      return "Sum: Air";
-    case 99:
-      return "Sum: Animation";
-    case 100:
-      return "Sum: Earth";
-    case 101:
-      return "Sum: Familiar";
-    case 102:
-      return "Sum: Fire";
-    case 103:
-      return "Sum: Undead";
-    case 104:
-      return "Sum: Warder";
-    case 105:
-      return "Sum: Water";
-    case 106:
-      return "Summon Armor";
-    case 107:
-      return "Summon Focus";
-    case 108:
-      return "Summon Food/Water";
-    case 109:
-      return "Summon Utility";
-    case 110:
-      return "Summon Weapon";
-    case 111:
-      return "Summoned";
-    case 112:
-      return "Symbol";
-    case 113:
-      return "Taelosia";
-    case 114:
-      return "Taps";
-    case 115:
-      return "Techniques";
-    case 116:
-      return "The Planes";
-    case 117:
-      return "Timer 1";
-    case 118:
-      return "Timer 2";
-    case 119:
-      return "Timer 3";
-    case 120:
-      return "Timer 4";
-    case 121:
-      return "Timer 5";
-    case 122:
-      return "Timer 6";
-    case 123:
-      return "Transport";
-    case 124:
-      return "Undead";
-    case 125:
-      return "Utility Beneficial";
-    case 126:
-      return "Utility Detrimental";
-    case 127:
-      return "Velious";
-    case 128:
-      return "Visages";
-    case 129:
-      return "Vision";
-    case 130:
-      return "Wisdom/Intelligence";
-    case 131:
-      return "Traps";
-    case 132:
-      return "Auras";
-    case 133:
-      return "Endurance";
-    case 134:
-      return "Serpent's Spine";
-    case 135:
-      return "Corruption";
-    case 136:
-      return "Learning";
-    case 137:
-      return "Chromatic";
-    case 138:
-      return "Prismatic";
-    case 139:
-      return "Sum: Swarm";
-    case 140:
-      return "Delayed";
-    case 141:
-      return "Temporary";
-    case 142:
-      return "Twincast";
-    case 143:
-      return "Sum: Bodyguard";
-    case 144:
-      return "Humanoid";
-    case 145:
-      return "Haste/Spell Focus";
-    case 146:
-      return "Timer 7";
-    case 147:
-      return "Timer 8";
-    case 148:
-      return "Timer 9";
-    case 149:
-      return "Timer 10";
-    case 150:
-      return "Timer 11";
-    case 151:
-      return "Timer 12";
-    case 152:
-      return "Hatred";
-    case 153:
-      return "Fast";
-    case 154:
-      return "Illusion: Special";
-    case 155:
-      return "Timer 13";
-    case 156:
-      return "Timer 14";
-    case 157:
-      return "Timer 15";
-    case 158:
-      return "Timer 16";
-    case 159:
-      return "Timer 17";
-    case 160:
-      return "Timer 18";
-    case 161:
-      return "Timer 19";
-    case 162:
-      return "Timer 20";
-    case 163:
-      return "Alaris";
-    case 164:  // Alternative transport subcategories.
-      return "Self";
-    case 165:
-      return "Group";
-    case 166:
-      return "Target";
-    case 167:
-      return "Area";
-    default:
-      return "Unknown";
+static constexpr bool is_spell_cat_table_valid() {
+  size_t categorized = 0;
+  for (const auto &code : spell_cat_table) categorized += (code.category != 0);
+  if (categorized != spell_cat_lut.size()) return false;
+  for (const auto &entry : spell_cat_lut) {
+    const SpellCatCode &code = spell_cat_table[entry.spell_id];
+    if (code.category != entry.spell_cat.Category || code.subcategory != entry.spell_cat.SubCategory) return false;
+    const char *new_name = code.name_index ? spell_new_names[code.name_index - 1] : nullptr;
+    if (new_name != entry.spell_cat.NewName) return false;
   }
-}
\ No newline at end of file
+  return true;
+}
+
+static constexpr bool is_alt_transport_table_valid() {
+  size_t overlays = 0;
+  for (uint8_t transport_type : alt_transport_table) overlays += (transport_type != 0);
+  if (overlays != alt_transport_lut.size()) return false;
+  for (const auto &entry : alt_transport_lut)
+    if (alt_transport_table[entry.spell_id] != entry.transport_type ||
+        spell_cat_table[entry.spell_id].category != 123)  // The overlay only applies to transport spells.
+      return false;
+  return true;
+}
+
+static_assert(is_sorted_by_spell_id(spell_cat_lut), "spell_cat_lut must be sorted by unique spell id");
+static_assert(is_sorted_by_spell_id(alt_transport_lut), "alt_transport_lut must be sorted by unique spell id");
+static_assert(is_spell_cat_table_valid(), "spell_cat_table does not match spell_cat_lut");
+static_assert(is_alt_transport_table_valid(), "alt_transport_table does not match alt_transport_lut");
+
+SpellCat getSpellCategoryAndSubcategory(int spellID, bool use_alt_transport) {
+  if (spellID < 0 || spellID >= static_cast<int>(kSpellCatTableSize)) return SpellCat(0, 0);
+
+  const SpellCatCode &code = spell_cat_table[spellID];
+  int subcategory = code.subcategory;
+  if (use_alt_transport && alt_transport_table[spellID]) subcategory = alt_transport_table[spellID];
+  return SpellCat(code.category, subcategory, code.name_index ? spell_new_names[code.name_index - 1] : nullptr);
+}
+
+// Display names indexed by spell category id.
+static constexpr std::array<std::string_view, 164> spell_category_names = {
+    "Unknown",              // 0
+    "Aegolism",             // 1
+    "Agility",              // 2
+    "Alliance",             // 3
+    "Animal",               // 4
+    "Antonica",             // 5
+    "Armor Class",          // 6
+    "Attack",               // 7
+    "Bane",                 // 8
+    "Blind",                // 9
+    "Block",                // 10
+    "Calm",                 // 11
+    "Charisma",             // 12
+    "Charm",                // 13
+    "Cold",                 // 14
+    "Combat Abilities",     // 15
+    "Combat Innates",       // 16
+    "Conversions",          // 17
+    "Create Item",          // 18
+    "Cure",                 // 19
+    "Damage Over Time",     // 20
+    "Damage Shield",        // 21
+    "Defensive",            // 22
+    "Destroy",              // 23
+    "Dexterity",            // 24
+    "Direct Damage ",       // 25
+    "Disarm Traps",         // 26
+    "Disciplines",          // 27
+    "Discord",              // 28
+    "Disease",              // 29
+    "Disempowering",        // 30
+    "Dispel",               // 31
+    "Duration Heals",       // 32
+    "Duration Tap",         // 33
+    "Enchant Metal",        // 34
+    "Enthrall",             // 35
+    "Faydwer",              // 36
+    "Fear",                 // 37
+    "Fire",                 // 38
+    "Fizzle Rate",          // 39
+    "Fumble",               // 40
+    "Haste",                // 41
+    "Heals",                // 42
+    "Health",               // 43
+    "Health/Mana",          // 44
+    "HP Buffs",             // 45
+    "HP type one",          // 46
+    "HP type two",          // 47
+    "Illusion: Other",      // 48
+    "Illusion: Player",     // 49
+    "Imbue Gem",            // 50
+    "Invisibility",         // 51
+    "Invulnerability",      // 52
+    "Jolt",                 // 53
+    "Kunark",               // 54
+    "Levitate",             // 55
+    "Life Flow",            // 56
+    "Luclin",               // 57
+    "Magic",                // 58
+    "Mana",                 // 59
+    "Mana Drain",           // 60
+    "Mana Flow",            // 61
+    "Melee Guard",          // 62
+    "Memory Blur",          // 63
+    "Misc",                 // 64
+    "Movement",             // 65
+    "Objects",              // 66
+    "Odus",                 // 67
+    "Offensive",            // 68
+    "Pet",                  // 69
+    "Pet Haste",            // 70
+    "Pet Misc Buffs",       // 71
+    "Physical",             // 72
+    "Picklock",             // 73
+    "Plant",                // 74
+    "Poison",               // 75
+    "Power Tap",            // 76
+    "Quick Heal",           // 77
+    "Reflection",           // 78
+    "Regen",                // 79
+    "Resist Buff",          // 80
+    "Resist Debuffs",       // 81
+    "Resurrection",         // 82
+    "Root",                 // 83
+    "Rune",                 // 84
+    "Sense Trap",           // 85
+    "Shadowstep",           // 86
+    "Shielding",            // 87
+    "Slow",                 // 88
+    "Snare",                // 89
+    "Special",              // 90
+    "Spell Focus",          // 91
+    "Spell Guard",          // 92
+    "Spellshield",          // 93
+    "Stamina",              // 94
+    "Statistic Buffs",      // 95
+    "Strength",             // 96
+    "Stun",                 // 97
+    "Sum: Air",             // 98
+    "Sum: Animation",       // 99
+    "Sum: Earth",           // 100
+    "Sum: Familiar",        // 101
+    "Sum: Fire",            // 102
+    "Sum: Undead",          // 103
+    "Sum: Warder",          // 104
+    "Sum: Water",           // 105
+    "Summon Armor",         // 106
+    "Summon Focus",         // 107
+    "Summon Food/Water",    // 108
+    "Summon Utility",       // 109
+    "Summon Weapon",        // 110
+    "Summoned",             // 111
+    "Symbol",               // 112
+    "Taelosia",             // 113
+    "Taps",                 // 114
+    "Techniques",           // 115
+    "The Planes",           // 116
+    "Timer 1",              // 117
+    "Timer 2",              // 118
+    "Timer 3",              // 119
+    "Timer 4",              // 120
+    "Timer 5",              // 121
+    "Timer 6",              // 122
+    "Transport",            // 123
+    "Undead",               // 124
+    "Utility Beneficial",   // 125
+    "Utility Detrimental",  // 126
+    "Velious",              // 127
+    "Visages",              // 128
+    "Vision",               // 129
+    "Wisdom/Intelligence",  // 130
+    "Traps",                // 131
+    "Auras",                // 132
+    "Endurance",            // 133
+    "Serpent's Spine",      // 134
+    "Corruption",           // 135
+    "Learning",             // 136
+    "Chromatic",            // 137
+    "Prismatic",            // 138
+    "Sum: Swarm",           // 139
+    "Delayed",              // 140
+    "Temporary",            // 141
+    "Twincast",             // 142
+    "Sum: Bodyguard",       // 143
+    "Humanoid",             // 144
+    "Haste/Spell Focus",    // 145
+    "Timer 7",              // 146
+    "Timer 8",              // 147
+    "Timer 9",              // 148
+    "Timer 10",             // 149
+    "Timer 11",             // 150
+    "Timer 12",             // 151
+    "Hatred",               // 152
+    "Fast",                 // 153
+    "Illusion: Special",    // 154
+    "Timer 13",             // 155
+    "Timer 14",             // 156
+    "Timer 15",             // 157
+    "Timer 16",             // 158
+    "Timer 17",             // 159
+    "Timer 18",             // 160
+    "Timer 19",             // 161
+    "Timer 20",             // 162
+    "Alaris",               // 163
+};
+
+static constexpr std::string_view GetSpellCategoryName(DWORD categoryID) {
+  return (categoryID < spell_category_names.size()) ? spell_category_names[categoryID] : spell_category_names[0];
+}
+
+// Display names indexed by spell subcategory id.
+static constexpr std::array<std::string_view, 168> spell_subcategory_names = {
+    "Unknown",              // 0
+    "Aegolism",             // 1
+    "Agility",              // 2
+    "Alliance",             // 3
+    "Animal",               // 4
+    "Antonica",             // 5
+    "Armor Class",          // 6
+    "Attack",               // 7
+    "Bane",                 // 8
+    "Blind",                // 9
+    "Block",                // 10
+    "Calm",                 // 11
+    "Charisma",             // 12
+    "Charm",                // 13
+    "Cold",                 // 14
+    "Combat Abilities",     // 15
+    "Combat Innates",       // 16
+    "Conversions",          // 17
+    "Create Item",          // 18
+    "Cure",                 // 19
+    "Damage Over Time",     // 20
+    "Damage Shield",        // 21
+    "Defensive",            // 22
+    "Destroy",              // 23
+    "Dexterity",            // 24
+    "Direct Damage ",       // 25
+    "Disarm Traps",         // 26
+    "Disciplines",          // 27
+    "Discord",              // 28
+    "Disease",              // 29
+    "Disempowering",        // 30
+    "Dispel",               // 31
+    "Duration Heals",       // 32
+    "Duration Tap",         // 33
+    "Enchant Metal",        // 34
+    "Enthrall",             // 35
+    "Faydwer",              // 36
+    "Fear",                 // 37
+    "Fire",                 // 38
+    "Fizzle Rate",          // 39
+    "Fumble",               // 40
+    "Haste",                // 41
+    "Heals",                // 42
+    "Health",               // 43
+    "Health/Mana",          // 44
+    "HP Buffs",             // 45
+    "HP type one",          // 46
+    "HP type two",          // 47
+    "Illusion: Other",      // 48
+    "Illusion: Player",     // 49
+    "Imbue Gem",            // 50
+    "Invisibility",         // 51
+    "Invulnerability",      // 52
+    "Jolt",                 // 53
+    "Kunark",               // 54
+    "Levitate",             // 55
+    "Life Flow",            // 56
+    "Luclin",               // 57
+    "Magic",                // 58
+    "Mana",                 // 59
+    "Mana Drain",           // 60
+    "Mana Flow",            // 61
+    "Melee Guard",          // 62
+    "Memory Blur",          // 63
+    "Misc",                 // 64
+    "Movement",             // 65
+    "Objects",              // 66
+    "Odus",                 // 67
+    "Offensive",            // 68
+    "Pet",                  // 69
+    "Pet Haste",            // 70
+    "Pet Misc Buffs",       // 71
+    "Physical",             // 72
+    "Picklock",             // 73
+    "Plant",                // 74
+    "Poison",               // 75
+    "Power Tap",            // 76
+    "Quick Heal",           // 77
+    "Reflection",           // 78
+    "Regen",                // 79
+    "Resist Buff",          // 80
+    "Resist Debuffs",       // 81
+    "Resurrection",         // 82
+    "Root",                 // 83
+    "Rune",                 // 84
+    "Sense Trap",           // 85
+    "Shadowstep",           // 86
+    "Shielding",            // 87
+    "Slow",                 // 88
+    "Snare",                // 89
+    "Special",              // 90
+    "Spell Focus",          // 91
+    "Spell Guard",          // 92
+    "Spellshield",          // 93
+    "Stamina",              // 94
+    "Statistic Buffs",      // 95
+    "Strength",             // 96
+    "Stun",                 // 97
+    "Sum: Air",             // 98
+    "Sum: Animation",       // 99
+    "Sum: Earth",           // 100
+    "Sum: Familiar",        // 101
+    "Sum: Fire",            // 102
+    "Sum: Undead",          // 103
+    "Sum: Warder",          // 104
+    "Sum: Water",           // 105
+    "Summon Armor",         // 106
+    "Summon Focus",         // 107
+    "Summon Food/Water",    // 108
+    "Summon Utility",       // 109
+    "Summon Weapon",        // 110
+    "Summoned",             // 111
+    "Symbol",               // 112
+    "Taelosia",             // 113
+    "Taps",                 // 114
+    "Techniques",           // 115
+    "The Planes",           // 116
+    "Timer 1",              // 117
+    "Timer 2",              // 118
+    "Timer 3",              // 119
+    "Timer 4",              // 120
+    "Timer 5",              // 121
+    "Timer 6",              // 122
+    "Transport",            // 123
+    "Undead",               // 124
+    "Utility Beneficial",   // 125
+    "Utility Detrimental",  // 126
+    "Velious",              // 127
+    "Visages",              // 128
+    "Vision",               // 129
+    "Wisdom/Intelligence",  // 130
+    "Traps",                // 131
+    "Auras",                // 132
+    "Endurance",            // 133
+    "Serpent's Spine",      // 134
+    "Corruption",           // 135
+    "Learning",             // 136
+    "Chromatic",            // 137
+    "Prismatic",            // 138
+    "Sum: Swarm",           // 139
+    "Delayed",              // 140
+    "Temporary",            // 141
+    "Twincast",             // 142
+    "Sum: Bodyguard",       // 143
+    "Humanoid",             // 144
+    "Haste/Spell Focus",    // 145
+    "Timer 7",              // 146
+    "Timer 8",              // 147
+    "Timer 9",              // 148
+    "Timer 10",             // 149
+    "Timer 11",             // 150
+    "Timer 12",             // 151
+    "Hatred",               // 152
+    "Fast",                 // 153
+    "Illusion: Special",    // 154
+    "Timer 13",             // 155
+    "Timer 14",             // 156
+    "Timer 15",             // 157
+    "Timer 16",             // 158
+    "Timer 17",             // 159
+    "Timer 18",             // 160
+    "Timer 19",             // 161
+    "Timer 20",             // 162
+    "Alaris",               // 163
+    "Self",                 // 164 (alternative transport subcategories)
+    "Group",                // 165
+    "Target",               // 166
+    "Area",                 // 167
+};
+
+static constexpr std::string_view GetSpellSubCategoryName(DWORD subcategoryID) {
+  return (subcategoryID < spell_subcategory_names.size()) ? spell_subcategory_names[subcategoryID]
+                                                          : spell_subcategory_names[0];
+}
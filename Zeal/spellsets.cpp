@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <filesystem>
 #include <format>
+#include <iterator>
 
 #include "callbacks.h"
 #include "commands.h"
@@ -118,7 +119,7 @@ void SpellSets::handle_finished_memorizing(int a1, int a2) {
 
 // Called after scribing a new spell into spellbook.
 void SpellSets::handle_finished_scribing(int a1, int a2) {
-  create_spells_menus();  // Update context menu with new spell.
+  update_spells_menus();  // Update context menu with new spell.
 }
 
 // Helper lookup function for spell information.
@@ -291,40 +292,14 @@ static bool compareBySpellLevel(const Zeal::GameStructures::SPELL *a, const Zeal
   return std::string(a->Name) < std::string(b->Name);  // Alphabetize as second priority.
 }
 
-// Assembles all spells in the spellbook and returns a categorized structure for the menus.
-std::map<std::string, std::map<std::string, std::list<menudata>>> SpellSets::get_spell_categories() {
-  Zeal::GameStructures::GAMECHARINFO *char_info = Zeal::Game::get_char_info();
+// Returns the spells in the spellbook sorted by spell id.
+static std::vector<Zeal::GameStructures::SPELL *> get_spell_book_spells() {
   std::vector<Zeal::GameStructures::SPELL *> spells;
   for (int N = 0; N < GAME_NUM_SPELL_BOOK_SPELLS; N++) {
     if (Zeal::GameStructures::SPELL *pSpell = GetSpell(N)) spells.push_back(pSpell);
   }
-  std::sort(spells.begin(), spells.end(), compareBySpellLevel);
-  std::map<std::string, std::map<std::string, std::list<menudata>>> spell_category;
-  for (auto &s : spells) {
-    SpellCat spell_cat_data = getSpellCategoryAndSubcategory(s->ID, setting_alternate_transport_categories.get());
-    menudata md;
-    md.ID = s->ID;
-    int level = s->ClassLevel[char_info->Class];
-
-    // The Alternate transport swaps the names to be first and level last.
-    const char *name = (spell_cat_data.NewName != nullptr) ? spell_cat_data.NewName : s->Name;
-    bool alt_transport = (spell_cat_data.Category == 123 && setting_alternate_transport_categories.get());
-    md.Name = alt_transport ? std::format("{0} - {1}", name, level) : std::format("{0} - {1}", level, name);
-
-    std::string category = GetSpellCategoryName(spell_cat_data.Category);
-    std::string subcategory = GetSpellSubCategoryName(spell_cat_data.SubCategory);
-    spell_category[category][subcategory].push_back(md);
-  }
-
-  // Perform an alphabetical sort of the alternate transport categories (one above was by level).
-  if (setting_alternate_transport_categories.get()) {
-    auto it = spell_category.find("Transport");
-    if (it != spell_category.end()) {
-      for (auto &sub : it->second) sub.second.sort();
-    }
-  }
-
-  return spell_category;
+  std::sort(spells.begin(), spells.end(), [](const auto *a, const auto *b) { return a->ID < b->ID; });
+  return spells;
 }
 
 // Callback provided to context manager to handle spell gem selection notifications.
@@ -335,29 +310,121 @@ static int __fastcall SpellsMenuNotification(void *menu_this, int unused_edx, Ze
   return 1;
 }
 
-// Creates the spells_menus context menus used in spell gem selection.
+// Returns the menu tree node with the id, appending a new one if it is not there yet.
+template <typename T>
+static T &find_or_add(std::vector<T> &nodes, int id) {
+  for (auto &node : nodes)
+    if (node.id == id) return node;
+  return nodes.emplace_back(T{id});
+}
+
+// Creates the spells_menus context menus used in spell gem selection from scratch.
 void SpellSets::create_spells_menus() {
   if (!Zeal::Game::is_new_ui() || !Zeal::Game::Windows->ContextMenuManager) {
     return;
   }  // prevent callback crashing oldui or an early setting update.
 
-  destroy_menus(spells_menus);
+  destroy_spells_menus();
 
   if (!Zeal::Game::get_self() || !Zeal::Game::get_char_info()) return;
 
-  auto spells_root_menu = CreateContextMenu(SpellsMenuNotification);
+  add_menu_to_manager(spells_menus, CreateContextMenu(SpellsMenuNotification));  // The root menu.
+  update_spells_menus();
+}
 
-  const auto &spell_categories = get_spell_categories();
-  for (auto &[cat, sub] : spell_categories) {
-    Zeal::GameUI::ContextMenu *sub_category = CreateContextMenu();
-    for (auto &[subcat, spells] : sub) {
-      Zeal::GameUI::ContextMenu *sub_menu = CreateContextMenu();
-      for (auto &sp : spells) sub_menu->AddMenuItem(sp.Name, kSpellsBaseMsgId + sp.ID);
-      sub_category->AddMenuItem(subcat, add_menu_to_manager(spells_menus, sub_menu), false, true);
-    }
-    spells_root_menu->AddMenuItem(cat, add_menu_to_manager(spells_menus, sub_category), false, true);
+// Brings the spells_menus up to date with the spellbook. Only the categories that gained or lost
+// spells are rebuilt, along with the root menu items that link to them.
+void SpellSets::update_spells_menus() {
+  if (spells_menus.empty()) {
+    create_spells_menus();
+    return;
   }
-  add_menu_to_manager(spells_menus, spells_root_menu);  // Root menu is added last (at .back()).
+  Zeal::GameStructures::GAMECHARINFO *char_info = Zeal::Game::get_char_info();
+  if (!char_info) return;
+
+  const bool alt_transport_setting = setting_alternate_transport_categories.get();
+  std::vector<Zeal::GameStructures::SPELL *> spells = get_spell_book_spells();
+  std::vector<int> book_ids;
+  for (const auto *spell : spells) book_ids.push_back(spell->ID);
+  std::vector<int> changed_ids;
+  std::set_symmetric_difference(book_ids.begin(), book_ids.end(), spell_book_ids.begin(), spell_book_ids.end(),
+                                std::back_inserter(changed_ids));
+  if (changed_ids.empty()) return;
+  spell_book_ids = std::move(book_ids);
+
+  std::vector<int> dirty_ids;  // Categories with added or removed spells.
+  for (int id : changed_ids) dirty_ids.push_back(getSpellCategoryAndSubcategory(id, alt_transport_setting).Category);
+  std::sort(dirty_ids.begin(), dirty_ids.end());
+  auto is_dirty = [&dirty_ids](int category_id) {
+    return std::binary_search(dirty_ids.begin(), dirty_ids.end(), category_id);
+  };
+  for (auto &category : spell_categories)
+    if (is_dirty(category.id)) destroy_menus(category.menus);
+  std::erase_if(spell_categories, [&is_dirty](const SpellCategory &category) { return is_dirty(category.id); });
+
+  // Collect the current spells of the dirty categories in their menu order.
+  std::erase_if(spells, [&](const auto *spell) {
+    return !is_dirty(getSpellCategoryAndSubcategory(spell->ID, alt_transport_setting).Category);
+  });
+  std::sort(spells.begin(), spells.end(), compareBySpellLevel);
+  std::vector<SpellCategory> rebuilt;
+  for (auto &s : spells) {
+    SpellCat spell_cat_data = getSpellCategoryAndSubcategory(s->ID, alt_transport_setting);
+    menudata md;
+    md.ID = s->ID;
+    int level = s->ClassLevel[char_info->Class];
+
+    // The Alternate transport swaps the names to be first and level last.
+    const char *name = (spell_cat_data.NewName != nullptr) ? spell_cat_data.NewName : s->Name;
+    bool alt_transport = (spell_cat_data.Category == 123 && alt_transport_setting);
+    md.Name = alt_transport ? std::format("{0} - {1}", name, level) : std::format("{0} - {1}", level, name);
+
+    SpellCategory &category = find_or_add(rebuilt, spell_cat_data.Category);
+    find_or_add(category.subcategories, spell_cat_data.SubCategory).spells.push_back(std::move(md));
+  }
+
+  auto is_category_before = [](const SpellCategory &a, const SpellCategory &b) {
+    return GetSpellCategoryName(a.id) < GetSpellCategoryName(b.id);
+  };
+  for (auto &category : rebuilt) {
+    std::sort(category.subcategories.begin(), category.subcategories.end(),
+              [](const SpellSubcategory &a, const SpellSubcategory &b) {
+                return GetSpellSubCategoryName(a.id) < GetSpellSubCategoryName(b.id);
+              });
+    // Perform an alphabetical sort of the alternate transport categories (one above was by level).
+    if (category.id == 123 && alt_transport_setting)
+      for (auto &sub : category.subcategories) std::sort(sub.spells.begin(), sub.spells.end());
+    create_category_menus(category);
+    auto position = std::upper_bound(spell_categories.begin(), spell_categories.end(), category, is_category_before);
+    spell_categories.insert(position, std::move(category));
+  }
+
+  Zeal::GameUI::ContextMenu *spells_root_menu = spells_menus.back().menu;
+  spells_root_menu->RemoveAllMenuItems();
+  for (const auto &category : spell_categories)
+    spells_root_menu->AddMenuItem(std::string(GetSpellCategoryName(category.id)), category.menus.back().index, false,
+                                  true);
+}
+
+// Creates the category menu and its subcategory menus from the cached category contents.
+void SpellSets::create_category_menus(SpellCategory &category) {
+  destroy_menus(category.menus);
+  Zeal::GameUI::ContextMenu *sub_category = CreateContextMenu();
+  for (const auto &sub : category.subcategories) {
+    Zeal::GameUI::ContextMenu *sub_menu = CreateContextMenu();
+    for (const auto &sp : sub.spells) sub_menu->AddMenuItem(sp.Name, kSpellsBaseMsgId + sp.ID);
+    sub_category->AddMenuItem(std::string(GetSpellSubCategoryName(sub.id)),
+                              add_menu_to_manager(category.menus, sub_menu), false, true);
+  }
+  add_menu_to_manager(category.menus, sub_category);  // Category menu is added last (at .back()).
+}
+
+// Releases the spells_menus and the cached menu tree.
+void SpellSets::destroy_spells_menus() {
+  for (auto &category : spell_categories) destroy_menus(category.menus);
+  spell_categories.clear();
+  spell_book_ids.clear();
+  destroy_menus(spells_menus);
 }
 
 // Callback provided to context manager to handle spell set selection notifications.
@@ -411,7 +478,7 @@ void SpellSets::callback_init_ui() {
 
 // Called right before client UI is de-allocated.
 void SpellSets::callback_clean_ui() {
-  destroy_menus(spells_menus);
+  destroy_spells_menus();
   destroy_menus(spellsets_menus);
   spellsets_map.clear();
   mem_buffer.clear();
@@ -13,8 +13,6 @@
 
 struct menudata {
   std::string Name;
-  std::string Category;
-  std::string SubCategory;
   DWORD ID;
 
   bool operator<(const menudata &other) const { return Name < other.Name; }  // For alphabetical sort.
@@ -45,14 +43,27 @@ class SpellSets {
     Zeal::GameUI::ContextMenu *menu;
   };
 
+  // Cached spellbook menu tree keyed by category and subcategory id, both kept in menu (name) order.
+  struct SpellSubcategory {
+    int id;
+    std::vector<menudata> spells;  // In menu order.
+  };
+  struct SpellCategory {
+    int id;
+    std::vector<SpellSubcategory> subcategories;
+    std::vector<MenuPair> menus;  // Subcategory menus with the category menu stored last.
+  };
+
   // File system storage of spell sets.
   void initialize_ini_filename();
   void save(const std::string &name);
   void load(const std::string &name);
   void remove(const std::string &name);
 
-  std::map<std::string, std::map<std::string, std::list<menudata>>> get_spell_categories();
   void create_spells_menus();
+  void update_spells_menus();
+  void create_category_menus(SpellCategory &category);
+  void destroy_spells_menus();
   void create_spellsets_menus();
   void destroy_menus(std::vector<SpellSets::MenuPair> &menus);
   int add_menu_to_manager(std::vector<SpellSets::MenuPair> &menus, Zeal::GameUI::ContextMenu *new_menu);
@@ -63,7 +74,9 @@ class SpellSets {
   void callback_main();
   void callback_init_ui();
 
-  std::vector<MenuPair> spells_menus;               // Spellbook spells.
+  std::vector<MenuPair> spells_menus;               // Spellbook spells root menu.
+  std::vector<SpellCategory> spell_categories;      // Cached category menus linked from the root menu.
+  std::vector<int> spell_book_ids;                  // Sorted spell ids the cached menus were built from.
   Zeal::GameUI::SpellGemWnd *last_gem_clicked = 0;  // Caches clicked gem between operations.
 
   std::vector<MenuPair> spellsets_menus;        // Spellsets.
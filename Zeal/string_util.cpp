@@ -1,6 +1,8 @@
 #include "string_util.h"
 
 #include <algorithm>
+#include <charconv>
+#include <iomanip>
 #include <regex>
 #include <sstream>
 
@@ -8,20 +10,49 @@
 
 namespace Zeal {
 namespace String {
+// ASCII-only lower case (bytes outside A-Z, including any multi-byte text, compare exactly).
+static inline char ascii_lower(char c) { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c; }
+
+// Returns the position of the next case-insensitive match of from (non-empty) at or after start.
+static size_t find_insensitive(const std::string &input, const std::string &from, size_t start) {
+  const char first = ascii_lower(from[0]);
+  const size_t from_length = from.length();
+  for (size_t i = start; i + from_length <= input.length(); ++i) {
+    if (ascii_lower(input[i]) != first) continue;
+    size_t j = 1;
+    while (j < from_length && ascii_lower(input[i + j]) == ascii_lower(from[j])) ++j;
+    if (j == from_length) return i;
+  }
+  return std::string::npos;
+}
+
 std::string replace(std::string &input, const std::string &from, const std::string &to) {
-  // Use regex with case-insensitive flag
-  std::regex from_regex(from, std::regex_constants::icase);
+  if (from.empty()) return input;
 
-  input = std::regex_replace(input, from_regex, to);
-  // Perform the replacement
+  size_t pos = find_insensitive(input, from, 0);
+  if (pos == std::string::npos) return input;  // Common case: nothing to do and no allocation.
+
+  // Count the (non-overlapping) matches so the output is sized once.
+  size_t count = 0;
+  for (size_t p = pos; p != std::string::npos; p = find_insensitive(input, from, p + from.length())) ++count;
+
+  std::string result;
+  result.reserve(input.length() - count * from.length() + count * to.length());
+  size_t last = 0;
+  for (; pos != std::string::npos; pos = find_insensitive(input, from, last)) {
+    result.append(input, last, pos - last);
+    result.append(to);
+    last = pos + from.length();
+  }
+  result.append(input, last, std::string::npos);
+  input.swap(result);
   return input;
+}
 
-  // size_t start_pos = 0;
-  // while ((start_pos = input.find(from, start_pos)) != std::string::npos) {
-  //	input.replace(start_pos, from.length(), to);
-  //	start_pos += to.length(); // Handles case where 'to' is a substring of 'from'
-  // }
-  // return input;
+std::string replace_regex(std::string &input, const std::string &pattern, const std::string &format) {
+  std::regex pattern_regex(pattern, std::regex_constants::icase);
+  input = std::regex_replace(input, pattern_regex, format);
+  return input;
 }
 
 std::string trim_and_reduce_spaces(const std::string &input) {
@@ -83,34 +114,35 @@ std::vector<std::string> split(const std::string &str, const std::string &delim)
   return tokens;
 }
 
-bool tryParse(const std::string &str, int *result, bool quiet) {
-  try {
-    *result = std::stoi(str);
-    return true;
-  } catch (const std::invalid_argument &e) {
-    if (!quiet) Zeal::Game::print_chat("Invalid Argument %s", e.what());
-    return false;
-  } catch (const std::out_of_range &e) {
-    if (!quiet) {
-      Zeal::Game::print_chat("Out of range: %s", e.what());
-    }
-    return false;
-  }
+// Skips the leading whitespace and a '+' sign (which std::from_chars rejects) of a number.
+static std::string_view get_number_start(std::string_view str) {
+  size_t start = 0;
+  while (start < str.size() && std::isspace(static_cast<unsigned char>(str[start]))) ++start;
+  if (start + 1 < str.size() && str[start] == '+' && str[start + 1] != '-') ++start;
+  return str.substr(start);
 }
 
-bool tryParse(const std::string &str, float *result, bool quiet) {
-  try {
-    *result = std::stof(str);
-    return true;
-  } catch (const std::invalid_argument &e) {
-    if (!quiet) Zeal::Game::print_chat("Invalid Argument %s", e.what());
+template <typename T>
+static bool parse_number(std::string_view str, T *result, bool quiet) {
+  std::string_view number = get_number_start(str);
+  T value = 0;
+  auto [ptr, ec] = std::from_chars(number.data(), number.data() + number.size(), value);
+  if (ec == std::errc::invalid_argument) {
+    if (!quiet) Zeal::Game::print_chat("Invalid Argument %.*s", static_cast<int>(str.size()), str.data());
     return false;
-  } catch (const std::out_of_range &e) {
-    if (!quiet) Zeal::Game::print_chat("Out of range: %s", e.what());
+  }
+  if (ec == std::errc::result_out_of_range) {
+    if (!quiet) Zeal::Game::print_chat("Out of range: %.*s", static_cast<int>(str.size()), str.data());
     return false;
   }
+  *result = value;
+  return true;
 }
 
+bool tryParse(std::string_view str, int *result, bool quiet) { return parse_number(str, result, quiet); }
+
+bool tryParse(std::string_view str, float *result, bool quiet) { return parse_number(str, result, quiet); }
+
 std::string bytes_to_hex(const char *byteArray, size_t length) {
   std::ostringstream oss;
   oss << std::hex << std::setfill('0');
@@ -134,5 +166,87 @@ std::vector<std::string> split_text(const std::string &input, const std::string
   return strings;
 }
 
+std::string_view trim(std::string_view input) {
+  size_t start = 0;
+  while (start < input.size() && std::isspace(static_cast<unsigned char>(input[start]))) ++start;
+  size_t end = input.size();
+  while (end > start && std::isspace(static_cast<unsigned char>(input[end - 1]))) --end;
+  return input.substr(start, end - start);
+}
+
+void split(std::string_view input, std::string_view delim, std::vector<std::string_view> &tokens) {
+  tokens.clear();
+  std::string_view trimmed = trim(input);
+  if (delim == " ") {
+    size_t start = 0;
+    while (start < trimmed.size()) {
+      size_t end = start;
+      while (end < trimmed.size() && !std::isspace(static_cast<unsigned char>(trimmed[end]))) ++end;
+      tokens.push_back(trimmed.substr(start, end - start));
+      start = end;
+      while (start < trimmed.size() && std::isspace(static_cast<unsigned char>(trimmed[start]))) ++start;
+    }
+    if (tokens.empty()) tokens.push_back(trimmed);  // Matches split() returning one empty token.
+    return;
+  }
+
+  size_t start = 0, end = 0;
+  while (!delim.empty() && (end = trimmed.find(delim, start)) != std::string_view::npos) {
+    tokens.push_back(trimmed.substr(start, end - start));
+    start = end + delim.length();
+  }
+  tokens.push_back(trimmed.substr(start));
+}
+
+void split_text(std::string_view input, std::string_view delimiter, std::vector<std::string_view> &tokens) {
+  tokens.clear();
+  size_t start = 0;
+  size_t end = 0;
+  while (end != std::string_view::npos && start < input.size()) {
+    end = delimiter.empty() ? std::string_view::npos : input.find(delimiter, start);
+    size_t count = (end == std::string_view::npos) ? std::string_view::npos : end - start;
+    tokens.push_back(input.substr(start, count));
+    start = end + delimiter.size();
+  }
+}
+
+// Windows-1252 code points of bytes 0x80 - 0x9f (the five undefined bytes map to themselves).
+static constexpr uint16_t kWindows1252Codepoints[32] = {
+    0x20ac, 0x0081, 0x201a, 0x0192, 0x201e, 0x2026, 0x2020, 0x2021, 0x02c6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008d,
+    0x017d, 0x008f, 0x0090, 0x2018, 0x2019, 0x201c, 0x201d, 0x2022, 0x2013, 0x2014, 0x02dc, 0x2122, 0x0161, 0x203a,
+    0x0153, 0x009d, 0x017e, 0x0178};
+
+uint32_t decode_codepoint(const char *&text) {
+  const uint8_t *bytes = reinterpret_cast<const uint8_t *>(text);
+  const uint8_t lead = bytes[0];
+  if (lead < 0x80) {
+    text += (lead != 0);
+    return lead;
+  }
+
+  // Only well-formed UTF-8 is accepted: no overlong forms, surrogates or code points past 0x10ffff.
+  static constexpr uint32_t kMinCodepoint[5] = {0, 0, 0x80, 0x800, 0x10000};
+  int length = (lead >= 0xc2 && lead <= 0xdf)   ? 2
+               : (lead >= 0xe0 && lead <= 0xef) ? 3
+               : (lead >= 0xf0 && lead <= 0xf4) ? 4
+                                                : 0;
+  uint32_t codepoint = lead & (0x7f >> length);
+  for (int i = 1; i < length; ++i) {
+    if ((bytes[i] & 0xc0) != 0x80) {  // Also stops at the null terminator.
+      length = 0;
+      break;
+    }
+    codepoint = (codepoint << 6) | (bytes[i] & 0x3f);
+  }
+  if (length && codepoint >= kMinCodepoint[length] && codepoint <= 0x10ffff &&
+      (codepoint < 0xd800 || codepoint > 0xdfff)) {
+    text += length;
+    return codepoint;
+  }
+
+  text++;
+  return (lead < 0xa0) ? kWindows1252Codepoints[lead - 0x80] : lead;  // Latin-1 above 0x9f.
+}
+
 }  // namespace String
 }  // namespace Zeal
\ No newline at end of file
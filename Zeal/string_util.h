@@ -1,5 +1,7 @@
 #pragma once
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace Zeal {
@@ -7,10 +9,30 @@ namespace String {
 std::string trim_and_reduce_spaces(const std::string &input);
 bool compare_insensitive(const std::string &str1, const std::string &str2);
 std::vector<std::string> split(const std::string &str, const std::string &delim);
-bool tryParse(const std::string &str, int *result, bool quiet = false);
-bool tryParse(const std::string &str, float *result, bool quiet = false);
+
+// Parses a number like std::stoi / std::stof (leading whitespace and an optional sign, then the longest
+// valid number prefix) but with std::from_chars so a bad argument doesn't throw. Hexadecimal floats
+// are not accepted. Prints the failure reason unless quiet.
+bool tryParse(std::string_view str, int *result, bool quiet = false);
+bool tryParse(std::string_view str, float *result, bool quiet = false);
 std::string bytes_to_hex(const char *byteArray, size_t length);
+// Replaces every case-insensitive (ASCII) occurrence of the literal from with to, scanning left to right
+// without overlaps. An empty from leaves the input unchanged. Updates and returns input.
 std::string replace(std::string &input, const std::string &from, const std::string &to);
+// Regex variant of replace(): pattern is a case-insensitive ECMAScript regex and format may use $n references.
+std::string replace_regex(std::string &input, const std::string &pattern, const std::string &format);
 std::vector<std::string> split_text(const std::string &input, const std::string &delimiter = "\n");
+
+// Allocation free variants. The returned views point into the input, so it must outlive them. The
+// token vectors are cleared first so callers can reuse them.
+std::string_view trim(std::string_view input);  // Removes leading and trailing whitespace.
+// Splits the trimmed input on delim. A " " delim treats any run of whitespace as one separator (the
+// tokens match split() then). Otherwise tokens are not space reduced.
+void split(std::string_view input, std::string_view delim, std::vector<std::string_view> &tokens);
+void split_text(std::string_view input, std::string_view delimiter, std::vector<std::string_view> &tokens);
+
+// Returns the code point at text and advances text past it. A valid UTF-8 sequence is decoded as
+// such and any other byte is a Windows-1252 character (the client's encoding). Stays on the null.
+uint32_t decode_codepoint(const char *&text);
 };  // namespace String
 }  // namespace Zeal
\ No newline at end of file
@@ -44,15 +44,16 @@ Survey::Survey(ZealService *zeal) {
 void Survey::check_message_for_survey_trigger(const char *message) {
   if (!setting_enable.get() || !message || !strstr(message, kZealSurveyHeader)) return;
 
-  std::string message_str = message;
+  std::string_view message_str = message;
   if (!message_str.starts_with(kZealSurveyHeader)) return;
 
-  auto split = Zeal::String::split_text(message_str, kDelimiter);
+  std::vector<std::string_view> split;
+  Zeal::String::split_text(message_str, kDelimiter, split);
   if (split.size() != 3) return;
 
   if (split[0] != kZealSurveyHeader) return;
 
-  handle_start_of_survey(split[1], split[2]);
+  handle_start_of_survey(std::string(split[1]), std::string(split[2]));
 }
 
 void Survey::handle_start_of_survey(const std::string &channel, const std::string &question) {
@@ -91,16 +92,15 @@ bool Survey::check_for_response_message(const char *message, int color_index) {
   std::string name = message_str.substr(0, first_space);
   if (name == "You" && Zeal::Game::get_self()) name = Zeal::Game::get_self()->Name;
   std::string response = extract_quoted_string(message_str);
-  auto split = Zeal::String::split_text(response, kDelimiter);
+  std::vector<std::string_view> split;
+  Zeal::String::split_text(response, kDelimiter, split);
   if (!name.empty() && split.size() == 2 && split[0] == kZealResponseHeader) {
     // Allow changing of votes (and prevent double-voting) by removing any existing votes.
     for (auto &pair : survey_responses) {
       auto it = std::find(pair.second.begin(), pair.second.end(), name);
       if (it != pair.second.end()) pair.second.erase(it);  // Future: Maybe log the change in vote.
     }
-    auto it = survey_responses.find(split[1]);
-    if (it == survey_responses.end()) survey_responses.insert({split[1], std::vector<std::string>()});
-    survey_responses[split[1]].push_back(name);
+    survey_responses[std::string(split[1])].push_back(name);
   }
 
   return true;
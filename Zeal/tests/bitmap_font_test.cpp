@@ -0,0 +1,248 @@
+// Golden test of the vertices BitmapFont and SpriteFont submit for the embedded default font through
+// the recording D3D stand-in. The expected output is golden/bitmap_font_vertices.txt. After an
+// intended change to the rendering, check the differences and rewrite it with:
+//   bitmap_font_test --update
+// Also checks the measurement of Windows-1252 and UTF-8 text (not part of the golden file).
+#include "bitmap_font.h"
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include "test_util.h"
+
+namespace {
+
+std::string format(const char *format, ...) {
+  char buffer[512];
+  va_list args;
+  va_start(args, format);
+  std::vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  return buffer;
+}
+
+template <typename T>
+T read_at(const std::vector<BYTE> &data, size_t offset) {
+  T value;
+  std::memcpy(&value, &data[offset], sizeof(T));
+  return value;
+}
+
+// Appends the draw calls made since first_draw (one line per vertex) to out. Each glyph is drawn as
+// four vertices with the fixed two triangle index pattern, which is checked here instead of written.
+void dump_draws(const IDirect3DDevice8 &device, size_t first_draw, std::string &out) {
+  const IDirect3DTexture8 *atlas_texture = FontAtlas::get_shared(const_cast<IDirect3DDevice8 &>(device))->get_texture();
+  static constexpr uint16_t kGlyphIndices[] = {0, 1, 2, 1, 3, 2};
+  for (size_t i = first_draw; i < device.draws.size(); ++i) {
+    const auto &draw = device.draws[i];
+    const size_t vertex_count = draw.vertices.size() / draw.vertex_stride;
+    out += format("draw fvf 0x%03x stride %u vertices %zu texture %s\n", draw.vertex_shader, draw.vertex_stride,
+                  vertex_count, (draw.texture && draw.texture == atlas_texture) ? "atlas" : "other");
+    CHECK_MSG(draw.indices.size() == vertex_count / 4 * 6, "draw %zu: %zu indices", i, draw.indices.size());
+    for (size_t k = 0; k < draw.indices.size(); ++k)
+      CHECK_MSG(draw.indices[k] == k / 6 * 4 + kGlyphIndices[k % 6], "draw %zu: index %zu is %u", i, k,
+                draw.indices[k]);
+    if (draw.vertex_stride == 24) {  // SpriteFont vertices are placed by the world matrix.
+      out += "world";
+      for (const auto &row : draw.world.m) out += format(" %.9g %.9g %.9g %.9g", row[0], row[1], row[2], row[3]);
+      out += "\n";
+    }
+    for (size_t v = 0; v < vertex_count; ++v) {
+      const size_t offset = v * draw.vertex_stride;
+      if (draw.vertex_stride == 28)  // x, y, z, rhw, color, u, v
+        out += format("%.9g %.9g %.9g %.9g %08x %.9g %.9g\n", read_at<float>(draw.vertices, offset),
+                      read_at<float>(draw.vertices, offset + 4), read_at<float>(draw.vertices, offset + 8),
+                      read_at<float>(draw.vertices, offset + 12), read_at<uint32_t>(draw.vertices, offset + 16),
+                      read_at<float>(draw.vertices, offset + 20), read_at<float>(draw.vertices, offset + 24));
+      else  // x, y, z, color, u, v
+        out += format("%.9g %.9g %.9g %08x %.9g %.9g\n", read_at<float>(draw.vertices, offset),
+                      read_at<float>(draw.vertices, offset + 4), read_at<float>(draw.vertices, offset + 8),
+                      read_at<uint32_t>(draw.vertices, offset + 12), read_at<float>(draw.vertices, offset + 16),
+                      read_at<float>(draw.vertices, offset + 20));
+    }
+  }
+}
+
+// Returns true if every state in after has its value in before (or 0, the stand-in's default).
+bool is_restored(const std::map<DWORD, DWORD> &before, const std::map<DWORD, DWORD> &after) {
+  return std::all_of(after.begin(), after.end(), [&before](const auto &entry) {
+    auto it = before.find(entry.first);
+    return entry.second == ((it != before.end()) ? it->second : 0);
+  });
+}
+
+// Flushes the font and appends its draws under a heading. Also checks the flush restored the state.
+template <typename TFont>
+void flush(IDirect3DDevice8 &device, TFont &font, const char *name, std::string &out) {
+  const auto render_states = device.render_states;
+  const auto texture_stage_states = device.texture_stage_states;
+  D3DMATRIX world;
+  device.GetTransform(D3DTS_WORLD, &world);
+  const size_t first_draw = device.draws.size();
+  font.flush_queue_to_screen();
+  out += format("## %s\n", name);
+  dump_draws(device, first_draw, out);
+  CHECK_MSG(is_restored(render_states, device.render_states), "%s: render states not restored", name);
+  CHECK_MSG(is_restored(texture_stage_states, device.texture_stage_states), "%s: texture stage states not restored",
+            name);
+  D3DMATRIX restored_world;
+  device.GetTransform(D3DTS_WORLD, &restored_world);
+  CHECK_MSG(std::memcmp(&restored_world, &world, sizeof(world)) == 0, "%s: world not restored", name);
+  CHECK_MSG(!device.texture && !device.stream_source && !device.indices, "%s: resources left bound", name);
+}
+
+void render_bitmap_font(IDirect3DDevice8 &device, std::string &out) {
+  auto font = BitmapFont::create_bitmap_font(device, BitmapFontBase::kDefaultFontName);
+  CHECK(font != nullptr);
+  if (!font) return;
+
+  font->queue_string("Hello, World!", Vec3(100.3f, 50.7f, 0), false, D3DCOLOR_XRGB(255, 255, 255));
+  flush(device, *font, "plain", out);
+
+  font->set_drop_shadow(true);
+  font->queue_string("Shadow", Vec3(400, 300, 0), true, D3DCOLOR_XRGB(255, 0, 0));
+  font->queue_string("Two strings", Vec3(400, 320, 0), true, D3DCOLOR_ARGB(128, 0, 255, 0));
+  flush(device, *font, "drop shadow", out);
+
+  // Repeated strings come from the layout cache and must render the same.
+  font->set_outlined(true);
+  font->set_align_bottom(true);
+  std::string first_pass;
+  std::string cached_pass;
+  for (std::string *pass : {&first_pass, &cached_pass}) {
+    font->queue_string("Line one\nLine two is longer", Vec3(640, 480, 0), true, D3DCOLOR_XRGB(240, 240, 0));
+    flush(device, *font, "outlined multi-line", *pass);
+  }
+  CHECK_MSG(first_pass == cached_pass, "cached layout rendered differently");
+  CHECK(font->get_layout_cache_stats().hits >= 1);
+  out += first_pass;
+
+  // The stats bars cast no shadow.
+  font->set_align_bottom(false);
+  font->set_hp_percent(60);
+  font->queue_background_rect({10, 10, 200, 60}, D3DCOLOR_ARGB(96, 0, 0, 0));
+  font->queue_string("Name\n\x01\x02", Vec3(20, 20, 0), false, D3DCOLOR_XRGB(255, 255, 255));
+  flush(device, *font, "background and stats bars", out);
+}
+
+void render_sprite_font(IDirect3DDevice8 &device, std::string &out) {
+  auto font = SpriteFont::create_sprite_font(device, SpriteFont::kDefaultFontName);
+  CHECK(font != nullptr);
+  if (!font) return;
+
+  const D3DMATRIX view = {{{0.8f, 0, -0.6f, 0}, {0, 1, 0, 0}, {0.6f, 0, 0.8f, 0}, {5, -2, 30, 1}}};
+  device.SetTransform(D3DTS_VIEW, &view);
+  const D3DMATRIX world = {{{2, 0, 0, 0}, {0, 2, 0, 0}, {0, 0, 2, 0}, {1, 2, 3, 1}}};
+  device.SetTransform(D3DTS_WORLD, &world);
+
+  font->set_outlined(true);
+  font->set_hp_percent(40);
+  font->set_mana_percent(75);
+  font->queue_string("Soandso\n\x01\x02", Vec3(10, 20, 30), true, D3DCOLOR_XRGB(255, 255, 255));
+  font->set_hp_percent(90);
+  font->queue_string("a gnoll\n\x01\x02\n\x01\x03", Vec3(-15, 4, 8), true, D3DCOLOR_XRGB(255, 80, 80));
+  flush(device, *font, "sprite nameplates", out);
+}
+
+// Text may be ASCII, Windows-1252 (the client's encoding) or UTF-8: the same characters in either
+// encoding measure the same, and malformed UTF-8 measures as its Windows-1252 bytes.
+void test_measure_encodings(IDirect3DDevice8 &device) {
+  auto font = BitmapFont::create_bitmap_font(device, BitmapFontBase::kDefaultFontName);
+  if (!font) return;
+  auto width = [&font](const char *text) { return font->measure_string(text).x; };
+  auto same_size = [&font](const char *text, const char *other) {
+    const Vec3 size = font->measure_string(text);
+    const Vec3 other_size = font->measure_string(other);
+    CHECK_MSG(size.x == other_size.x && size.y == other_size.y && size.z == other_size.z,
+              "\"%s\" measures %g x %g and \"%s\" %g x %g", text, size.x, size.y, other, other_size.x, other_size.y);
+  };
+
+  CHECK(width("Hello") > 0 && width("Hello") < width("Hello, World!"));
+  CHECK(width("Hello\nWorld!") == width("World!"));  // The widest line.
+  same_size("Caf\xE9", "Caf\xC3\xA9");
+  same_size("Na\xEFve r\xE9sum\xE9", "Na\xC3\xAFve r\xC3\xA9sum\xC3\xA9");
+  same_size("\x93quoted\x94 \x96 \x80" "5", "\xE2\x80\x9Cquoted\xE2\x80\x9D \xE2\x80\x93 \xE2\x82\xAC" "5");
+  same_size("x\xE9\xC3\xA9\x80y", "x\xC3\xA9\xC3\xA9\xE2\x82\xACy");  // Mixed in one string.
+  same_size("\xC0\xAF", "\xC3\x80\xC2\xAF");                      // Overlong '/' is two characters.
+  same_size("\xED\xA0\x80", "\xC3\xAD\xC2\xA0\xE2\x82\xAC");  // So is a surrogate.
+  same_size("\xC3", "\xC3\x83");                                    // Truncated by the null.
+
+  // Latin-1 letters missing from the font fall back to their base letter, and each code point
+  // (however many bytes) counts once toward the 100 character limit.
+  CHECK(width("\xC3\x89\xC3\xA9") == width("\xC9\xE9"));
+  std::string ascii(100, 'e');
+  std::string utf8;
+  for (int i = 0; i < 100; ++i) utf8 += "\xC3\xA9";
+  CHECK(width(utf8.c_str()) == width(std::string(100, static_cast<char>(0xe9)).c_str()));
+  CHECK(width((utf8 + "\xC3\xA9").c_str()) == width(utf8.c_str()));
+  CHECK(width((ascii + "e").c_str()) == width(ascii.c_str()));
+}
+
+// Enough outlined glyphs to wrap the vertex ring buffer: every glyph must be drawn once per pass.
+void test_batching(IDirect3DDevice8 &device) {
+  auto font = BitmapFont::create_bitmap_font(device, BitmapFontBase::kDefaultFontName);
+  if (!font) return;
+  font->set_outlined(true);
+  const size_t first_draw = device.draws.size();
+  const char *text = "0123456789abcdefghij";  // 20 glyphs.
+  for (int frame = 0; frame < 3; ++frame) {
+    for (int i = 0; i < 40; ++i) font->queue_string(text, Vec3(10, 12.f * i, 0), false);
+    font->flush_queue_to_screen();
+  }
+  size_t quads = 0;
+  for (size_t i = first_draw; i < device.draws.size(); ++i) {
+    const size_t draw_quads = device.draws[i].vertices.size() / device.draws[i].vertex_stride / 4;
+    CHECK_MSG(draw_quads <= 1000, "draw of %zu glyphs", draw_quads);
+    quads += draw_quads;
+  }
+  CHECK_MSG(quads == 3 * 40 * 20 * 3, "%zu glyphs drawn", quads);
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  const bool update = argc > 1 && std::strcmp(argv[1], "--update") == 0;
+  IDirect3DDevice8 device;
+  device.render_states = {{D3DRS_ZENABLE, TRUE}, {D3DRS_CULLMODE, 3}, {D3DRS_LIGHTING, TRUE}};
+  device.texture_stage_states = {{D3DTSS_COLOROP, 2}, {D3DTSS_MINFILTER, 1}};
+
+  std::string output;
+  render_bitmap_font(device, output);
+  render_sprite_font(device, output);
+  test_batching(device);
+  test_measure_encodings(device);
+
+  if (update) {
+    std::ofstream(FONT_GOLDEN_PATH, std::ios::binary) << output;
+    std::printf("Wrote %s\n", FONT_GOLDEN_PATH);
+    return test_result();
+  }
+
+  std::ifstream file(FONT_GOLDEN_PATH, std::ios::binary);
+  std::stringstream golden;
+  golden << file.rdbuf();
+  CHECK_MSG(file.good(), "failed to read %s", FONT_GOLDEN_PATH);
+  if (golden.str() != output) {
+    std::istringstream expected_lines(golden.str());
+    std::istringstream actual_lines(output);
+    std::string expected;
+    std::string actual;
+    for (int line = 1;; ++line) {
+      const bool has_expected = static_cast<bool>(std::getline(expected_lines, expected));
+      const bool has_actual = static_cast<bool>(std::getline(actual_lines, actual));
+      if (!has_expected && !has_actual) break;
+      if (!has_expected) expected = "(end of file)";
+      if (!has_actual) actual = "(end of output)";
+      if (expected == actual) continue;
+      CHECK_MSG(false, "vertex output differs from the golden file at line %d:\n  expected: %s\n  actual:   %s", line,
+                expected.c_str(), actual.c_str());
+      break;
+    }
+  }
+  return test_result();
+}
@@ -0,0 +1,53 @@
+// Per-stage cost of the chat processing over the shipped corpora (raid, group and market) with the
+// synthetic roster of chat_replay_fixture.h. Reports ns/line and heap allocations/line, counted by
+// the replacement operator new below.
+// Usage: chat_replay_bench [repeat_count]
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "chat_replay.h"
+#include "chat_replay_fixture.h"
+
+namespace {
+
+std::atomic<uint64_t> allocation_count = 0;
+
+}  // namespace
+
+void *operator new(size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (void *p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+int main(int argc, char *argv[]) {
+  const int repeat_count = argc > 1 ? std::atoi(argv[1]) : 20;
+  if (repeat_count < 1) {
+    std::printf("Usage: chat_replay_bench [repeat_count]\n");
+    return 1;
+  }
+
+  const auto context = chat_replay_fixture::make_context();
+  auto get_allocation_count = []() { return allocation_count.load(std::memory_order_relaxed); };
+  for (const char *name : chat_replay_fixture::kCorpora) {
+    const auto corpus = chat_replay_fixture::load_corpus(name);
+    if (corpus.empty()) return 1;
+    std::vector<Zeal::ChatReplay::Line> lines;
+    lines.reserve(corpus.size() * repeat_count);
+    for (int i = 0; i < repeat_count; ++i) lines.insert(lines.end(), corpus.begin(), corpus.end());
+
+    Zeal::ChatReplay::measure(context, lines, get_allocation_count);  // Warm up.
+    const auto costs = Zeal::ChatReplay::measure(context, lines, get_allocation_count);
+    std::printf("%s: %zu lines (%d x %zu)\n", name, lines.size(), repeat_count, corpus.size());
+    for (const auto &cost : costs)
+      std::printf("  %-14s %8.0f ns/line %6.2f allocs/line\n", cost.name, cost.ns_per_line, cost.allocations_per_line);
+  }
+  return 0;
+}
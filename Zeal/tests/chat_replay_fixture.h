@@ -0,0 +1,75 @@
+#pragma once
+// The replay state shared by chat_replay_test and chat_replay_bench: a synthetic roster matching the
+// names in corpora/, the channel rules of the chatfilter filters and a small trigger file.
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "chat_replay.h"
+
+namespace chat_replay_fixture {
+
+inline const char *const kCorpora[] = {"raid", "group", "market"};
+
+// Returns the lines of corpora/<name>.txt (empty if it can't be read).
+inline std::vector<Zeal::ChatReplay::Line> load_corpus(const std::string &name) {
+  std::vector<Zeal::ChatReplay::Line> lines;
+  const std::string path = std::string(CHAT_CORPORA_DIR) + "/" + name + ".txt";
+  std::ifstream file(path);
+  if (!file.is_open())
+    std::printf("Failed to open %s\n", path.c_str());
+  else
+    Zeal::ChatReplay::load_lines(file, 0, 1000000, lines);
+  return lines;
+}
+
+inline Zeal::ChatReplay::Context make_context() {
+  Zeal::ChatReplay::Context context;
+  context.self_name = "Varden";
+
+  // Stub roster with the default raid class colors (capitalized names, as the lookup is made).
+  const std::pair<const char *, uint32_t> roster[] = {
+      {"Aelindra", 0xff9bc1ff}, {"Borvak", 0xffc79c6e},  {"Kelsha", 0xffc285ff},  {"Dorwin", 0xff3fc7eb},
+      {"Fenmar", 0xffa9d271},   {"Gilthas", 0xfff48cba}, {"Hrothgar", 0xff0070de}, {"Ismera", 0xffff7c0a},
+      {"Jorund", 0xfffff468},   {"Kaveth", 0xff00ff98},  {"Lyssa", 0xffff8080},    {"Mordain", 0xff8788ee},
+      {"Nyrie", 0xff69ccf0},    {"Osric", 0xffc41e3a},   {"Varden", 0xfffff468},
+  };
+  for (const auto &[name, color] : roster) context.roster[name] = color;
+
+  // The chatfilter filters in registration order (USERCOLOR_ ids are 0xFF + n, CHANNEL_ ids 1000+).
+  using Dispatch = ChatFilterDispatch;
+  context.set_filters({
+      {"Random", Dispatch::Channels, {287}},
+      {"Loot", Dispatch::Channels, {286}},
+      {"Money", Dispatch::Channels, {285, 328}},
+      {"My Pet Say", Dispatch::Channels, {1002}},
+      {"My Pet Damage", Dispatch::Damage, {}},
+      {"Other Pet Say", Dispatch::Channels, {1003}},
+      {"Other Pet Damage", Dispatch::Damage, {}},
+      {"/who", Dispatch::Channels, {281}},
+      {"My Melee Special", Dispatch::Channels, {1004}},
+      {"Other Melee Special", Dispatch::Channels, {1005}},
+      {"/mystats", Dispatch::Channels, {1006}},
+      {"Item Speech", Dispatch::Channels, {1007}},
+      {"Other Melee Critical", Dispatch::Channels, {1008}},
+      {"Other Damage Shield", Dispatch::Channels, {1009}},
+      {"Zeal Spam", Dispatch::Always, {}},
+  });
+
+  const char *const triggers[] = {
+      "Add^Rampage^.* goes on a RAMPAGE!^30^0xFFFF4040",
+      "Add^Slow^.*tells the raid,  'slow landed'^60^0xFF40FF40",
+      "Clear^Slow^.*has been slain by.*^0^0xFFFFFFFF",
+      "Add^Clarity^Your Clarity spell has worn off\\.^10^0xFF4080FF",
+      "Add^Rez^.*tells (the group|you), '.*(rez|need a rez).*'^20^0xFFFFFF00",
+      "Add^Sale^.*tells you, 'is .* still for sale\\?'^15^0xFF00FFFF",
+  };
+  for (const char *line : triggers)
+    if (!context.triggers.add(line)) std::printf("Failed to add trigger: %s\n", line);
+
+  context.percent_values = {.mana = "83", .hp = "92", .loc = "120.50, -340.25, 4.00", .target_hp = "47"};
+  return context;
+}
+
+}  // namespace chat_replay_fixture
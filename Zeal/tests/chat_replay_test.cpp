@@ -0,0 +1,229 @@
+// Regression test of the chat processing stages (abbreviation, class colors, coalesce hash, percent
+// codes, filter classification and trigger matching) over the shipped corpora/ with the synthetic
+// roster of chat_replay_fixture.h. The expected output is golden/chat_replay_stages.txt. After an
+// intended change to a stage, check the differences and rewrite it with:
+//   chat_replay_test --update
+#include "chat_replay.h"
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "chat_replay_fixture.h"
+#include "test_util.h"
+
+namespace {
+
+std::string format(const char *format, ...) {
+  char buffer[512];
+  va_list args;
+  va_start(args, format);
+  std::vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  return buffer;
+}
+
+void replay_corpus(const Zeal::ChatReplay::Context &context, const char *name, std::string &output) {
+  const auto lines = chat_replay_fixture::load_corpus(name);
+  CHECK_MSG(lines.size() >= 100, "%s corpus has %zu lines", name, lines.size());
+
+  std::string player_rolling;
+  Zeal::ChatReplay::LineResult result;
+  for (size_t i = 0; i < lines.size(); ++i) {
+    const auto &line = lines[i];
+    Zeal::ChatReplay::process_line(context, line, player_rolling, result);
+    output += format("%s:%zu channel %d hash %08x", name, i + 1, line.channel, result.coalesce_hash);
+    if (result.filter >= 0) output += format(" filter \"%s\"", context.filters[result.filter].name.c_str());
+    if (result.channel != line.channel) output += format(" routed %d", result.channel);
+    if (result.trigger) output += format(" trigger \"%s\"", result.trigger->label.c_str());
+    output += '\n';
+    if (result.abbreviated)
+      output += "  abbreviation: " + (result.abbreviation.empty() ? "(suppressed)" : result.abbreviation) + '\n';
+    if (result.colored) output += "  class colors: " + result.class_colors + '\n';
+    if (result.percent_codes != line.text) output += "  percent codes: " + result.percent_codes + '\n';
+  }
+}
+
+void test_load_lines() {
+  std::istringstream stream(
+      "# comment\n"
+      "\n"
+      "327\tBorvak tells the raid,  'inc'\r\n"
+      "[Sat Oct 17 20:15:42 2026] Kelsha tells the group, 'oom'\n"
+      "abc\tnot a channel\n"
+      "[no timestamp\n"
+      "258\t\n"
+      "259\tlast line\n");
+  std::vector<Zeal::ChatReplay::Line> lines;
+  CHECK(Zeal::ChatReplay::load_lines(stream, 5, 4, lines) == 4);
+  CHECK(lines.size() == 4);
+  if (lines.size() != 4) return;
+  CHECK(lines[0].channel == 327 && lines[0].text == "Borvak tells the raid,  'inc'");
+  CHECK(lines[1].channel == 5 && lines[1].text == "Kelsha tells the group, 'oom'");
+  CHECK(lines[2].channel == 5 && lines[2].text == "abc\tnot a channel");
+  CHECK(lines[3].channel == 5 && lines[3].text == "[no timestamp");  // Max lines reached before the rest.
+}
+
+void test_stages(const Zeal::ChatReplay::Context &context) {
+  std::string rolling;
+  Zeal::ChatReplay::LineResult result;
+  Zeal::ChatReplay::process_line(context, {309, "You tell your party, 'at %loc with %hp'"}, rolling, result);
+  CHECK(result.abbreviated && result.abbreviation == "[P] [Varden]: at %loc with %hp");
+  CHECK(result.percent_codes == "You tell your party, 'at 120.50, -340.25, 4.00 with 92%'");
+  CHECK(result.filter == -1 && !result.trigger);
+
+  Zeal::ChatReplay::process_line(context, {287, "**A Magic Die is rolled by Jorund."}, rolling, result);
+  CHECK(result.abbreviated && result.abbreviation.empty() && rolling == "Jorund");
+  CHECK(result.filter == 0 && context.filters[0].name == "Random");
+  Zeal::ChatReplay::process_line(
+      context, {287, "**It could have been any number from 0 to 100, but this time it turned up a 42."}, rolling,
+      result);
+  CHECK(result.abbreviation == "[0-100]: 42 rolled by Jorund." && rolling.empty());
+
+  Zeal::ChatReplay::process_line(context, {279, "Borvak hits a fire giant for 12 points of damage."}, rolling, result);
+  CHECK(!result.abbreviated);
+  CHECK(result.colored && result.class_colors == "<c \"#c79c6e\">Borvak</c> hits a fire giant for 12 points of damage.");
+  Zeal::ChatReplay::LineResult other;
+  Zeal::ChatReplay::process_line(context, {279, "Borvak hits a fire giant for 345 points of damage."}, rolling, other);
+  CHECK(other.coalesce_hash == result.coalesce_hash);  // Numbers are ignored.
+}
+
+// Truncation backs off to before a tag or item link that doesn't fit and closes an open color.
+void test_truncate_stml() {
+  std::string text = "short";
+  CHECK(!Zeal::ChatText::truncate_stml(text, 5) && text == "short");
+
+  text = "abcdefghijklmnop";
+  CHECK(Zeal::ChatText::truncate_stml(text, 12) && text == "abcde...");
+
+  text = "Hi <c \"#c79c6e\">Borvak</c> and <c \"#ff7d0a\">Kelsha</c> there";
+  CHECK(Zeal::ChatText::truncate_stml(text, 30) && text == "Hi <c \"#c79c6e\">Borvak...</c>");
+  text = "Hi <c \"#c79c6e\">Borvak</c> and <c \"#ff7d0a\">Kelsha</c> there";
+  CHECK(Zeal::ChatText::truncate_stml(text, 40) && text == "Hi <c \"#c79c6e\">Borvak</c> and ...");
+  text = "Hi <c \"#c79c6e\">Borvak</c> and <c \"#ff7d0a\">Kelsha</c> there";
+  CHECK(Zeal::ChatText::truncate_stml(text, 10) && text == "Hi ...");
+
+  text = "wts \x12" "0012345Rusty Dagger\x12 cheap, pst";
+  CHECK(Zeal::ChatText::truncate_stml(text, 20) && text == "wts ...");
+  text = "wts \x12" "0012345Rusty Dagger\x12 cheap, pst";
+  CHECK(Zeal::ChatText::truncate_stml(text, 34) && text == "wts \x12" "0012345Rusty Dagger\x12 c...");
+
+  // Long lines always end up within the limit and balanced.
+  std::string line;
+  for (int i = 0; i < 100; ++i) line += "<c \"#c79c6e\">Borvak</c> hits ";
+  for (size_t max_length = 0; max_length < 200; ++max_length) {
+    text = line;
+    Zeal::ChatText::truncate_stml(text, max_length);
+    size_t opens = 0;
+    size_t closes = 0;
+    for (size_t pos = 0; (pos = text.find("<c ", pos)) != std::string::npos; ++pos) ++opens;
+    for (size_t pos = 0; (pos = text.find("</c>", pos)) != std::string::npos; ++pos) ++closes;
+    CHECK_MSG(text.size() <= std::max<size_t>(max_length, 3) && opens == closes, "max %zu: \"%s\"", max_length,
+              text.c_str());
+  }
+}
+
+// A filter that re-routes the channel offers the message to the later filters of the new channel only.
+void test_filter_reroute() {
+  struct Filter {
+    ChatFilterDispatch dispatch;
+    std::vector<short> channels;
+  };
+  const std::vector<Filter> filters = {{ChatFilterDispatch::Channels, {20}},
+                                       {ChatFilterDispatch::Always, {}},
+                                       {ChatFilterDispatch::Channels, {10}},
+                                       {ChatFilterDispatch::Channels, {20}},
+                                       {ChatFilterDispatch::Damage, {}}};
+  ChatFilterMasks masks;
+  masks.build(filters);
+  std::vector<size_t> offered;
+  short channel = 10;
+  masks.dispatch(channel, false, [&](size_t index) {
+    offered.push_back(index);
+    if (index == 1) channel = 20;
+  });
+  CHECK(channel == 20);
+  CHECK((offered == std::vector<size_t>{1, 2, 3}));
+
+  offered.clear();
+  channel = 30;
+  masks.dispatch(channel, true, [&](size_t index) { offered.push_back(index); });
+  CHECK((offered == std::vector<size_t>{1, 4}));
+}
+
+// Filters past the mask bits are offered every message, after the others, so none is dropped.
+void test_filter_overflow() {
+  struct Filter {
+    ChatFilterDispatch dispatch;
+    std::vector<short> channels;
+  };
+  std::vector<Filter> filters;
+  for (short i = 0; i < 70; ++i) filters.push_back({ChatFilterDispatch::Channels, {i}});
+  ChatFilterMasks masks;
+  masks.build(filters);
+
+  std::vector<size_t> offered;
+  short channel = 3;
+  masks.dispatch(channel, false, [&](size_t index) { offered.push_back(index); });
+  CHECK((offered == std::vector<size_t>{3, 64, 65, 66, 67, 68, 69}));
+
+  // The last masked filter re-routing to an overflow filter's channel still reaches it.
+  size_t handled = 0;
+  channel = 63;
+  masks.dispatch(channel, false, [&](size_t index) {
+    if (index == 63) channel = 67;
+    if (std::find(filters[index].channels.begin(), filters[index].channels.end(), channel) !=
+        filters[index].channels.end())
+      handled = index;
+  });
+  CHECK(handled == 67);
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  const bool update = argc > 1 && std::strcmp(argv[1], "--update") == 0;
+  const auto context = chat_replay_fixture::make_context();
+  CHECK(context.triggers.size() == 6);
+
+  test_load_lines();
+  test_stages(context);
+  test_truncate_stml();
+  test_filter_reroute();
+  test_filter_overflow();
+
+  std::string output;
+  for (const char *name : chat_replay_fixture::kCorpora) replay_corpus(context, name, output);
+
+  if (update) {
+    std::ofstream(CHAT_GOLDEN_PATH, std::ios::binary) << output;
+    std::printf("Wrote %s\n", CHAT_GOLDEN_PATH);
+    return test_result();
+  }
+
+  std::ifstream file(CHAT_GOLDEN_PATH, std::ios::binary);
+  std::stringstream golden;
+  golden << file.rdbuf();
+  CHECK_MSG(file.good(), "failed to read %s", CHAT_GOLDEN_PATH);
+  if (golden.str() != output) {
+    std::istringstream expected_lines(golden.str());
+    std::istringstream actual_lines(output);
+    std::string expected;
+    std::string actual;
+    for (int line = 1;; ++line) {
+      const bool has_expected = static_cast<bool>(std::getline(expected_lines, expected));
+      const bool has_actual = static_cast<bool>(std::getline(actual_lines, actual));
+      if (!has_expected && !has_actual) break;
+      if (!has_expected) expected = "(end of file)";
+      if (!has_actual) actual = "(end of output)";
+      if (expected == actual) continue;
+      CHECK_MSG(false, "stage output differs from the golden file at line %d:\n  expected: %s\n  actual:   %s", line,
+                expected.c_str(), actual.c_str());
+      break;
+    }
+  }
+  return test_result();
+}
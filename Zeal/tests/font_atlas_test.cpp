@@ -0,0 +1,155 @@
+// Checks the font atlas shelf packing on random sheet sets and the block copies of the sheets (and
+// their solid stats bar rows) into the atlas texture through the recording D3D stand-in.
+#include "font_atlas.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "directx.h"
+#include "test_util.h"
+
+namespace {
+
+using Size = FontAtlas::Size;
+using Point = FontAtlas::Point;
+
+uint32_t round_up_to_block(uint32_t value) { return (value + 3) / 4 * 4; }
+
+// Checks the packed positions are block aligned, inside the atlas and at least a gutter apart.
+void check_packing(std::span<const Size> sizes, std::span<const Point> positions, Size atlas) {
+  CHECK_MSG(std::has_single_bit(atlas.width) && std::has_single_bit(atlas.height), "atlas %ux%u", atlas.width,
+            atlas.height);
+  CHECK(atlas.width <= FontAtlas::kMaxSize && atlas.height <= FontAtlas::kMaxSize);
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    const Point &p = positions[i];
+    CHECK_MSG(p.x % FontAtlas::kBlockSize == 0 && p.y % FontAtlas::kBlockSize == 0, "sheet %zu at %u, %u", i, p.x,
+              p.y);
+    CHECK_MSG(p.x + sizes[i].width <= atlas.width && p.y + sizes[i].height <= atlas.height,
+              "sheet %zu (%ux%u at %u, %u) outside %ux%u", i, sizes[i].width, sizes[i].height, p.x, p.y, atlas.width,
+              atlas.height);
+    for (size_t j = 0; j < i; ++j) {
+      const Point &q = positions[j];
+      const bool apart = p.x >= q.x + round_up_to_block(sizes[j].width) + FontAtlas::kGutter ||
+                         q.x >= p.x + round_up_to_block(sizes[i].width) + FontAtlas::kGutter ||
+                         p.y >= q.y + round_up_to_block(sizes[j].height) + FontAtlas::kGutter ||
+                         q.y >= p.y + round_up_to_block(sizes[i].height) + FontAtlas::kGutter;
+      CHECK_MSG(apart, "sheets %zu and %zu overlap or touch", j, i);
+    }
+  }
+}
+
+void test_pack() {
+  Point positions[64];
+  CHECK(FontAtlas::pack({}, positions).width == 0);
+  const Size too_wide[] = {{FontAtlas::kMaxSize + 1, 16}};
+  CHECK(FontAtlas::pack(too_wide, positions).width == 0);
+  const Size too_many[] = {{4096, 2048}, {4096, 2048}};  // Fit only without the gutter.
+  CHECK(FontAtlas::pack(too_many, positions).width == 0);
+  const Size one[] = {{256, 132}};
+  const Size packed = FontAtlas::pack(one, positions);
+  CHECK_MSG(packed.width == 256 && packed.height == 256 && positions[0].x == 0 && positions[0].y == 0, "%ux%u",
+            packed.width, packed.height);
+
+  std::mt19937 rng(50);
+  for (int set = 0; set < 20000; ++set) {
+    std::vector<Size> sizes(1 + rng() % 12);
+    for (auto &size : sizes)  // DXT sheets are whole block rows.
+      size = {1 + static_cast<uint32_t>(rng() % 512), 4 + 4 * static_cast<uint32_t>(rng() % 128)};
+    const Size atlas = FontAtlas::pack(sizes, positions);
+    CHECK_MSG(atlas.width, "set %d of %zu sheets did not fit", set, sizes.size());
+    if (atlas.width) check_packing(sizes, std::span(positions, sizes.size()), atlas);
+  }
+}
+
+// Returns a DXT2 sheet with every block filled with its own id byte.
+std::vector<uint8_t> make_sheet(uint32_t width, uint32_t rows, uint32_t stride, uint8_t id) {
+  std::vector<uint8_t> data(size_t(stride) * rows, 0xee);  // Stride padding must not be copied.
+  for (uint32_t y = 0; y < rows; ++y)
+    std::memset(&data[y * stride], id, (width + 3) / 4 * FontAtlas::kBlockBytes);
+  return data;
+}
+
+// Returns the 16 bytes of the block at the pixel position of the texture.
+std::span<const uint8_t> get_block(const IDirect3DTexture8 &texture, uint32_t x, uint32_t y) {
+  return std::span(&texture.data[y / 4 * texture.pitch + x / 4 * FontAtlas::kBlockBytes], FontAtlas::kBlockBytes);
+}
+
+bool is_filled(std::span<const uint8_t> block, uint8_t value) {
+  return std::all_of(block.begin(), block.end(), [value](uint8_t byte) { return byte == value; });
+}
+
+// Checks the texture holds each sheet at its origin with the solid stats bar block below its first
+// block and zeros everywhere else.
+void check_texture(FontAtlas &atlas, const IDirect3DTexture8 &texture, const std::vector<int> &ids,
+                   const std::vector<Size> &sizes) {
+  CHECK(texture.width == atlas.get_size().width && texture.height == atlas.get_size().height);
+  std::vector<uint8_t> expected(size_t(texture.width / 4) * (texture.height / 4), 0);
+  for (size_t i = 0; i < ids.size(); ++i) {
+    const Point origin = atlas.get_origin(ids[i]);
+    for (uint32_t y = 0; y < sizes[i].height; y += 4)
+      for (uint32_t x = 0; x < round_up_to_block(sizes[i].width); x += 4)
+        expected[(origin.y + y) / 4 * (texture.width / 4) + (origin.x + x) / 4] = static_cast<uint8_t>(ids[i] + 1);
+    expected[(origin.y + sizes[i].height) / 4 * (texture.width / 4) + origin.x / 4] = 0xff;
+  }
+  for (uint32_t y = 0; y < texture.height; y += 4)
+    for (uint32_t x = 0; x < texture.width; x += 4) {
+      const uint8_t value = expected[y / 4 * (texture.width / 4) + x / 4];
+      CHECK_MSG(is_filled(get_block(texture, x, y), value), "block at %u, %u should be 0x%02x", x, y, value);
+    }
+}
+
+void test_sheets() {
+  IDirect3DDevice8 device;
+  auto atlas = FontAtlas::get_shared(device);
+  CHECK(FontAtlas::get_shared(device) == atlas);
+  IDirect3DDevice8 other_device;
+  CHECK(FontAtlas::get_shared(other_device) != atlas);  // Replaces the shared atlas.
+  atlas = FontAtlas::get_shared(device);
+
+  CHECK(atlas->get_texture() == nullptr);  // Nothing to pack yet.
+  CHECK(atlas->add_sheet(256, 130, 1024, 32, make_sheet(256, 32, 1024, 1).data()) == -1);  // Height not 4 * rows.
+  CHECK(atlas->add_sheet(256, 128, 512, 32, make_sheet(256, 32, 1024, 1).data()) == -1);   // Stride too short.
+
+  // The blocks of each sheet hold its id + 1 and the rows are padded to different strides.
+  std::vector<Size> sizes = {{256, 128}, {62, 40}, {128, 256}};
+  std::vector<int> ids;
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    const uint32_t rows = sizes[i].height / 4;
+    const uint32_t stride = (sizes[i].width + 3) / 4 * FontAtlas::kBlockBytes + 16 * static_cast<uint32_t>(i);
+    auto data = make_sheet(sizes[i].width, rows, stride, static_cast<uint8_t>(i + 1));
+    ids.push_back(atlas->add_sheet(sizes[i].width, sizes[i].height, stride, rows, data.data()));
+    CHECK(ids.back() == static_cast<int>(i));
+  }
+  CHECK(atlas->get_sheet_count() == 3);
+
+  IDirect3DTexture8 *texture = atlas->get_texture();
+  CHECK(texture != nullptr);
+  if (!texture) return;
+  CHECK(!texture->locked && device.textures_created == 1);
+  CHECK(atlas->get_texture() == texture);  // Not repacked until a sheet is added.
+  check_texture(*atlas, *texture, ids, sizes);
+
+  // A removed sheet leaves the next pack, and the others keep their contents.
+  atlas->remove_sheet(ids[0]);
+  CHECK(atlas->get_sheet_count() == 2);
+  auto data = make_sheet(20, 5, 80, 4);
+  ids.push_back(atlas->add_sheet(20, 20, 80, 5, data.data()));
+  sizes.push_back({20, 20});
+  texture = atlas->get_texture();
+  CHECK(texture != nullptr && device.textures_created == 2);
+  if (!texture) return;
+  ids.erase(ids.begin());
+  sizes.erase(sizes.begin());
+  check_texture(*atlas, *texture, ids, sizes);
+}
+
+}  // namespace
+
+int main() {
+  test_pack();
+  test_sheets();
+  return test_result();
+}
@@ -0,0 +1,233 @@
+// Checks the ItemSearch ranking (exact, prefix, word prefix, substring and typo matches) against a
+// brute-force scan of the full Zeal::Items table for a fixed query set, and that the slowest query
+// (including the typo tolerant ones) stays within the one millisecond budget of the game thread.
+#include "item_search.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "game_functions.h"
+#include "items.h"
+#include "string_util.h"
+#include "test_util.h"
+#include "zeal.h"
+
+using Match = ItemSearch::Match;
+
+namespace {
+
+constexpr size_t kMaxResults = 50;  // The largest pipe item_search limit.
+
+const char *const kQueries[] = {
+    "Rusty Dagger",                // Exact.
+    "  rusty dagger  ",            // Trimmed and case folded.
+    "sword",                       // Prefix, word prefix and substring.
+    "Crown of",                    // Word prefix heavy.
+    "of the",                      // Very common trigrams.
+    "sw",                          // Short: word starts only.
+    "a",                           // Single character.
+    "ring",                        //
+    "cloak of",                    //
+    "bone chips",                  //
+    "spell: gate",                 // Punctuation.
+    "manastone",                   //
+    "fungus covered scale tunic",  // Long exact.
+    "swrod of",                    // One typo.
+    "breastplte",                  // One typo (deletion).
+    "fungus coverd scale tunik",   // Two typos.
+    "jagged blade of war",         //
+    "zzzzzz",                      // No matches.
+    "quuxfrobnicate",              // No matches, typos allowed.
+    "abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyzabcdefghijk",  // kMaxQueryLength.
+};
+
+struct ReferenceResult {
+  size_t index;
+  Match match;
+  int edits;
+};
+
+std::vector<std::string> load_folded_names() {
+  std::vector<std::string> names;
+  for (Zeal::Items::NameReader reader; !reader.done(); reader.next()) {
+    std::string name(reader.name());
+    for (char &c : name)
+      if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+    names.push_back(std::move(name));
+  }
+  return names;
+}
+
+bool is_alnum(char c) { return std::isalnum(static_cast<unsigned char>(c)) != 0; }
+
+// Distinct trigrams over the same folded alphabet as the index (letters, digits, space, other).
+size_t count_trigrams(std::string_view text) {
+  auto code = [](char c) {
+    if (c >= 'a' && c <= 'z') return c - 'a';
+    if (c >= '0' && c <= '9') return 26 + c - '0';
+    return 36 + (c != ' ');
+  };
+  std::vector<int> keys;
+  for (size_t i = 0; i + 2 < text.size(); ++i)
+    keys.push_back((code(text[i]) * 38 + code(text[i + 1])) * 38 + code(text[i + 2]));
+  std::sort(keys.begin(), keys.end());
+  return std::unique(keys.begin(), keys.end()) - keys.begin();
+}
+
+// Fewest edits that turn the query into any substring of the name (plain dynamic programming).
+int get_substring_edit_distance(std::string_view query, std::string_view name) {
+  std::vector<int> row(name.size() + 1, 0);  // Row 0: a match may start anywhere.
+  for (size_t i = 1; i <= query.size(); ++i) {
+    int diagonal = row[0];
+    row[0] = static_cast<int>(i);
+    for (size_t j = 1; j <= name.size(); ++j) {
+      int above = row[j];
+      row[j] = std::min({above + 1, row[j - 1] + 1, diagonal + (query[i - 1] != name[j - 1])});
+      diagonal = above;
+    }
+  }
+  return *std::min_element(row.begin(), row.end());
+}
+
+// Classifies every name against the query the slow way and returns them in ItemSearch's order.
+std::vector<ReferenceResult> brute_force_search(const std::vector<std::string> &names, std::string_view query_text) {
+  std::string query(Zeal::String::trim(query_text));
+  for (char &c : query)
+    if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+  std::vector<ReferenceResult> results;
+  if (query.empty() || query.size() > ItemSearch::kMaxQueryLength) return results;
+
+  const size_t trigrams = count_trigrams(query);
+  const int typo_limit = (query.size() < 6) ? 0 : (query.size() < 10) ? 1 : 2;
+  const int max_edits = trigrams ? std::min(typo_limit, static_cast<int>(trigrams - 1) / 3) : 0;
+  for (size_t index = 0; index < names.size(); ++index) {
+    const std::string &name = names[index];
+    if (name.starts_with(query)) {
+      results.push_back({index, name.size() == query.size() ? Match::Exact : Match::Prefix, 0});
+      continue;
+    }
+    bool word_prefix = false;
+    for (size_t offset = 1; offset < name.size() && !word_prefix; ++offset)
+      word_prefix = is_alnum(name[offset]) && !is_alnum(name[offset - 1]) &&
+                    std::string_view(name).substr(offset).starts_with(query);
+    if (word_prefix) {
+      results.push_back({index, Match::WordPrefix, 0});
+    } else if (trigrams && name.find(query) != std::string::npos) {
+      results.push_back({index, Match::Substring, 0});
+    } else if (max_edits && name.size() + max_edits >= query.size()) {
+      int edits = get_substring_edit_distance(query, name);
+      if (edits <= max_edits) results.push_back({index, Match::Fuzzy, edits});
+    }
+  }
+
+  std::sort(results.begin(), results.end(), [&names](const ReferenceResult &a, const ReferenceResult &b) {
+    if (a.match != b.match) return a.match < b.match;
+    if (a.edits != b.edits) return a.edits < b.edits;
+    if (names[a.index].size() != names[b.index].size()) return names[a.index].size() < names[b.index].size();
+    return a.index < b.index;
+  });
+  return results;
+}
+
+void test_against_brute_force(ItemSearch &search, const std::vector<std::string> &names) {
+  ItemSearch::Result results[kMaxResults];
+  for (const char *query : kQueries) {
+    const auto expected = brute_force_search(names, query);
+    const size_t count = search.search(query, results);
+    const size_t expected_count = std::min(expected.size(), kMaxResults);
+    CHECK_MSG(count == expected_count, "\"%s\": %zu results, expected %zu", query, count, expected_count);
+    for (size_t i = 0; i < std::min(count, expected_count); ++i) {
+      const ItemSearch::Result &result = results[i];
+      const ReferenceResult &reference = expected[i];
+      CHECK_MSG(result.index == reference.index && result.match == reference.match && result.edits == reference.edits,
+                "\"%s\" result %zu: \"%s\" (match %d, %d edits), expected \"%s\" (match %d, %d edits)", query, i,
+                names[result.index].c_str(), static_cast<int>(result.match), result.edits,
+                names[reference.index].c_str(), static_cast<int>(reference.match), reference.edits);
+      CHECK(result.id == Zeal::Items::values[result.index]);
+    }
+  }
+
+  // Smaller spans keep the best results in the same order.
+  ItemSearch::Result few[3];
+  const size_t count = search.search("sword", results);
+  CHECK(search.search("sword", few) == std::min<size_t>(count, 3));
+  for (size_t i = 0; i < 3 && i < count; ++i) CHECK(few[i].index == results[i].index);
+
+  CHECK(search.search("", results) == 0);
+  CHECK(search.search("   ", results) == 0);
+  CHECK(search.search(std::string(ItemSearch::kMaxQueryLength + 1, 'a'), results) == 0);
+  CHECK(search.search("sword", std::span<ItemSearch::Result>()) == 0);
+}
+
+// Typo queries made from random item names (the expensive path) on top of the fixed set.
+std::vector<std::string> make_timing_queries(const std::vector<std::string> &names) {
+  std::vector<std::string> queries(std::begin(kQueries), std::end(kQueries));
+  std::mt19937 random(1234);
+  for (int i = 0; i < 500; ++i) {
+    std::string query = names[random() % names.size()].substr(0, ItemSearch::kMaxQueryLength);
+    if (query.size() > 6) query[random() % query.size()] = 'a' + random() % 26;
+    queries.push_back(std::move(query));
+  }
+  return queries;
+}
+
+// The fastest of several runs of each query filters out scheduler noise. The slowest query must
+// still fit the budget.
+void test_query_time(ItemSearch &search, const std::vector<std::string> &names) {
+  constexpr int kRuns = 5;
+  constexpr double kBudgetMs = 1.0;
+  ItemSearch::Result results[kMaxResults];
+  double worst_ms = 0;
+  std::string worst_query;
+  for (const std::string &query : make_timing_queries(names)) {
+    double best_ms = 1e9;
+    for (int run = 0; run < kRuns; ++run) {
+      auto start = std::chrono::steady_clock::now();
+      search.search(query, results);
+      std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+      best_ms = std::min(best_ms, elapsed.count());
+    }
+    if (best_ms > worst_ms) {
+      worst_ms = best_ms;
+      worst_query = query;
+    }
+  }
+  std::printf("Slowest query: \"%s\" %.3f ms\n", worst_query.c_str(), worst_ms);
+  CHECK_MSG(worst_ms <= kBudgetMs, "\"%s\" took %.3f ms", worst_query.c_str(), worst_ms);
+}
+
+void test_command(ZealService &zeal) {
+  auto &chat = Zeal::Game::get_test_chat_lines();
+  auto &commands = zeal.commands_hook->CommandFunctions;
+  CHECK(commands.count("/itemsearch") == 1);
+  if (!commands.count("/itemsearch")) return;
+
+  std::vector<std::string> args = {"/itemsearch", "rusty", "dagger"};
+  chat.clear();
+  CHECK(commands["/itemsearch"](args));
+  CHECK(chat.size() >= 2 && chat[0] == "Items matching: rusty dagger");
+  CHECK(chat.size() >= 2 && chat[1].starts_with("  Rusty Dagger ("));
+}
+
+}  // namespace
+
+int main() {
+  ZealService zeal;
+  ItemSearch search(&zeal);
+  while (!search.is_ready()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  const auto names = load_folded_names();
+  CHECK(names.size() == Zeal::Items::record_count);
+
+  test_against_brute_force(search, names);
+  test_query_time(search, names);
+  test_command(zeal);
+  return test_result();
+}
@@ -0,0 +1,196 @@
+// Throughput and latency benchmark of the pipe protocol over the loopback and Unix socket
+// transports. Messages use the same json envelope as NamedPipe::write() (see pipe_data::serialize).
+// Usage: pipe_transport_bench [message_count]
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "json.hpp"
+#include "pipe_transport.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+long long now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+// A typical chat log message (pipe_data_type::log) with the send time in the data for latency.
+std::string make_message(unsigned long long seq, long long sent_ns) {
+  std::string data = std::to_string(sent_ns) + " Soandso hits a gnoll pup for 24 points of damage.";
+  return nlohmann::json{{"type", 0}, {"data_len", data.length()}, {"data", data}, {"character", "Tester"}, {"seq", seq}}
+      .dump();
+}
+
+// Extracts the send time from the data of each complete message in the stream (consumed).
+void collect_latencies(std::string &stream, std::vector<long long> &latencies) {
+  const long long received_ns = now_ns();
+  static constexpr char kDataKey[] = "\"data\":\"";
+  size_t start = 0;
+  for (size_t end; (end = stream.find('}', start)) != std::string::npos; start = end + 1) {
+    size_t data = stream.find(kDataKey, start);
+    if (data != std::string::npos && data < end)
+      latencies.push_back(received_ns - std::atoll(stream.c_str() + data + sizeof(kDataKey) - 1));
+  }
+  stream.erase(0, start);
+}
+
+void print_result(const char *name, int clients, int messages, size_t total_size, double seconds,
+                  std::vector<long long> &latencies) {
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&latencies](double p) {
+    return latencies.empty() ? 0.0 : latencies[static_cast<size_t>(p * (latencies.size() - 1))] / 1000.0;
+  };
+  std::printf("%-12s %3d clients: %8.0f msgs/s, %7.1f MB/s delivered, latency p50 %7.1f us, p99 %7.1f us\n", name,
+              clients, messages / seconds, total_size * clients / seconds / 1e6, percentile(0.5),
+              percentile(0.99));
+}
+
+void bench_loopback(int clients, int messages) {
+  LoopbackPipeTransport transport;
+  std::vector<std::shared_ptr<LoopbackPipeTransport::Endpoint>> endpoints;
+  for (int i = 0; i < clients; ++i) endpoints.push_back(transport.connect());
+  transport.update_clients();
+
+  // One reader thread drains every endpoint like the tools polling their pipe.
+  std::atomic<bool> done = false;
+  std::vector<long long> latencies;
+  std::thread reader([&]() {
+    std::vector<std::string> streams(endpoints.size());
+    while (!done) {
+      for (size_t i = 0; i < endpoints.size(); ++i) {
+        streams[i] += endpoints[i]->read();
+        collect_latencies(streams[i], latencies);
+      }
+    }
+  });
+
+  const auto start = Clock::now();
+  size_t total_size = 0;
+  for (int seq = 0; seq < messages; ++seq) {
+    std::string message = make_message(seq, now_ns());
+    total_size += message.size();
+    transport.broadcast(message);
+  }
+  for (const auto &endpoint : endpoints)
+    while (endpoint->bytes_received() < total_size) std::this_thread::yield();
+  const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  done = true;
+  reader.join();
+  print_result("loopback", clients, messages, total_size, seconds, latencies);
+}
+
+void bench_unix_socket(int clients, int messages) {
+  const std::string path = "/tmp/zeal_bench_" + std::to_string(getpid()) + ".sock";
+  UnixSocketPipeTransport transport(path, nullptr);
+
+  std::vector<std::vector<long long>> latencies(clients);
+  std::vector<std::thread> readers;
+  std::atomic<int> connected = 0;
+  for (int client = 0; client < clients; ++client)
+    readers.emplace_back([&, client]() {
+      int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+      sockaddr_un addr = {};
+      addr.sun_family = AF_UNIX;
+      std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+      if (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+        close(fd);
+        return;
+      }
+      connected++;
+      std::string stream;
+      char buffer[65536];
+      int count = 0;
+      while (count < messages) {
+        ssize_t bytes = recv(fd, buffer, sizeof(buffer), 0);
+        if (bytes <= 0) break;
+        stream.append(buffer, static_cast<size_t>(bytes));
+        size_t before = latencies[client].size();
+        collect_latencies(stream, latencies[client]);
+        count += static_cast<int>(latencies[client].size() - before);
+      }
+      close(fd);
+    });
+
+  while (connected < clients || static_cast<int>(transport.client_count()) < clients) {
+    transport.update_clients();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  const auto start = Clock::now();
+  size_t total_size = 0;
+  for (int seq = 0; seq < messages; ++seq) {
+    std::string message = make_message(seq, now_ns());
+    total_size += message.size();
+    transport.broadcast(message);
+  }
+  for (auto &reader : readers) reader.join();
+  const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+  std::vector<long long> all;
+  for (const auto &client : latencies) all.insert(all.end(), client.begin(), client.end());
+  print_result("unix socket", clients, messages, total_size, seconds, all);
+}
+
+// Inbound requests: time from a client's send to the receive callback on the transport thread.
+void bench_requests(int requests) {
+  const std::string path = "/tmp/zeal_bench_requests_" + std::to_string(getpid()) + ".sock";
+  std::mutex mutex;
+  std::vector<long long> latencies;
+  UnixSocketPipeTransport transport(path, [&](const std::string &line) {
+    const long long received_ns = now_ns();
+    std::scoped_lock lock(mutex);
+    latencies.push_back(received_ns - std::atoll(line.c_str() + line.find(' ') + 1));
+  });
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un addr = {};
+  addr.sun_family = AF_UNIX;
+  std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+  if (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+    std::printf("requests: connect failed\n");
+    close(fd);
+    return;
+  }
+  for (int i = 0; i < requests; ++i) {
+    std::string line = "{\"type\":\"command\",\"data\":\"/who\"} " + std::to_string(now_ns()) + "\n";
+    send(fd, line.data(), line.size(), MSG_NOSIGNAL);
+    std::this_thread::sleep_for(std::chrono::microseconds(50));  // Individual requests, not a burst.
+  }
+  for (int i = 0; i < 100; ++i) {
+    {
+      std::scoped_lock lock(mutex);
+      if (static_cast<int>(latencies.size()) == requests) break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  close(fd);
+
+  std::scoped_lock lock(mutex);
+  std::sort(latencies.begin(), latencies.end());
+  if (latencies.empty()) return;
+  std::printf("requests     %zu received: latency p50 %7.1f us, p99 %7.1f us\n", latencies.size(),
+              latencies[latencies.size() / 2] / 1000.0, latencies[(latencies.size() - 1) * 99 / 100] / 1000.0);
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  const int messages = (argc > 1) ? std::max(1, std::atoi(argv[1])) : 20000;
+  for (int clients : {1, 8, 64}) bench_loopback(clients, messages);
+  for (int clients : {1, 8}) bench_unix_socket(clients, messages);
+  bench_requests(std::min(messages, 2000));
+  return 0;
+}
@@ -0,0 +1,214 @@
+// Soak test of the pipe transports with many simulated clients connecting, sending requests,
+// reading the broadcast stream and disconnecting while the "game thread" keeps broadcasting.
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "pipe_transport.h"
+#include "test_util.h"
+
+namespace {
+
+// Records the request lines delivered to the receive callback (called on client threads).
+struct ReceivedLines {
+  std::mutex mutex;
+  std::map<int, std::vector<int>> by_client;  // Line numbers in arrival order.
+  int unexpected = 0;
+
+  void add(const std::string &line) {
+    int client = 0;
+    int number = 0;
+    std::scoped_lock lock(mutex);
+    if (std::sscanf(line.c_str(), "request %d %d", &client, &number) == 2 &&
+        line == "request " + std::to_string(client) + " " + std::to_string(number))
+      by_client[client].push_back(number);
+    else
+      ++unexpected;
+  }
+};
+
+// Checks that the stream is whole "<seq>\n" messages with consecutive sequence numbers. Returns the count.
+int check_broadcast_stream(const std::string &stream, int client) {
+  int count = 0;
+  long long last_seq = -1;
+  size_t start = 0;
+  while (start < stream.size()) {
+    size_t end = stream.find('\n', start);
+    CHECK_MSG(end != std::string::npos, "client %d: partial message", client);
+    if (end == std::string::npos) break;
+    long long seq = std::stoll(stream.substr(start, end - start));
+    CHECK_MSG(last_seq < 0 || seq == last_seq + 1, "client %d: seq %lld after %lld", client, seq, last_seq);
+    last_seq = seq;
+    ++count;
+    start = end + 1;
+  }
+  return count;
+}
+
+// Sends the request lines split at random points (and with the occasional \r\n ending or
+// overlong line, which must be dropped) so the transport has to reassemble them.
+void send_requests(int client, int line_count, std::mt19937 &rng, const std::function<void(const std::string &)> &send) {
+  std::string pending;
+  for (int i = 0; i < line_count; ++i) {
+    if (i % 7 == 3) pending += std::string(PipeTransport::kMaxLineLength + 10, 'x') + "\n";
+    pending += "request " + std::to_string(client) + " " + std::to_string(i) + ((i % 5) ? "\n" : "\r\n");
+    if (rng() % 3) continue;
+    while (!pending.empty()) {
+      size_t length = std::min<size_t>(pending.size(), 1 + rng() % 40);
+      send(pending.substr(0, length));
+      pending.erase(0, length);
+    }
+  }
+  if (!pending.empty()) send(pending);
+}
+
+void check_requests(ReceivedLines &received, int client_count, int line_count) {
+  std::scoped_lock lock(received.mutex);
+  CHECK_MSG(received.unexpected == 0, "%d corrupted request lines", received.unexpected);
+  for (int client = 0; client < client_count; ++client) {
+    const auto &lines = received.by_client[client];
+    CHECK_MSG(static_cast<int>(lines.size()) == line_count, "client %d: %zu of %d requests", client, lines.size(),
+              line_count);
+    for (int i = 0; i < static_cast<int>(lines.size()); ++i)
+      CHECK_MSG(lines[i] == i, "client %d: request %d arrived as %d", client, i, lines[i]);
+  }
+}
+
+void soak_loopback() {
+  static constexpr int kClients = 64;
+  static constexpr int kConnectThreads = 8;
+  static constexpr int kRequestLines = 200;
+  static constexpr int kReads = 50;
+
+  ReceivedLines received;
+  LoopbackPipeTransport transport([&received](const std::string &line) { received.add(line); });
+  std::atomic<int> clients_done = 0;
+  std::vector<std::string> streams(kClients);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kConnectThreads; ++t)
+    threads.emplace_back([&, t]() {
+      std::mt19937 rng(t);
+      for (int client = t; client < kClients; client += kConnectThreads) {
+        auto endpoint = transport.connect();
+        send_requests(client, kRequestLines, rng, [&endpoint](const std::string &data) { endpoint->send(data); });
+        for (int i = 0; i < kReads; ++i) {
+          streams[client] += endpoint->read();
+          std::this_thread::sleep_for(std::chrono::microseconds(rng() % 200));
+        }
+        endpoint->disconnect();
+        streams[client] += endpoint->read();
+        clients_done++;
+      }
+    });
+
+  // The game thread: adopt new clients and broadcast one message per frame.
+  long long seq = 0;
+  int max_clients = 0;
+  while (clients_done < kClients) {
+    transport.update_clients();
+    transport.broadcast(std::to_string(seq++) + "\n");
+    max_clients = std::max(max_clients, static_cast<int>(transport.client_count()));
+  }
+  for (auto &thread : threads) thread.join();
+  transport.update_clients();
+  transport.broadcast(std::to_string(seq++) + "\n");
+
+  CHECK_MSG(transport.client_count() == 0, "%zu disconnected clients were not dropped", transport.client_count());
+  CHECK(max_clients > 1);
+  for (int client = 0; client < kClients; ++client) check_broadcast_stream(streams[client], client);
+  check_requests(received, kClients, kRequestLines);
+  std::printf("loopback: %d clients, %lld broadcasts, up to %d connected at once\n", kClients, seq, max_clients);
+}
+
+void soak_unix_socket() {
+  static constexpr int kClients = 16;
+  static constexpr int kRequestLines = 100;
+  static constexpr int kMessages = 2000;  // Read by each client before it disconnects.
+
+  const std::string path = "/tmp/zeal_soak_" + std::to_string(getpid()) + ".sock";
+  ReceivedLines received;
+  auto transport = std::make_unique<UnixSocketPipeTransport>(
+      path, [&received](const std::string &line) { received.add(line); });
+  std::atomic<int> clients_done = 0;
+  std::vector<std::string> streams(kClients);
+
+  std::vector<std::thread> threads;
+  for (int client = 0; client < kClients; ++client)
+    threads.emplace_back([&, client]() {
+      std::mt19937 rng(client);
+      int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+      sockaddr_un addr = {};
+      addr.sun_family = AF_UNIX;
+      std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+      bool connected = fd >= 0 && connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0;
+      CHECK_MSG(connected, "client %d failed to connect", client);
+      if (connected) {
+        send_requests(client, kRequestLines, rng, [fd](const std::string &data) {
+          send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+        });
+        std::string &stream = streams[client];
+        char buffer[4096];
+        while (std::count(stream.begin(), stream.end(), '\n') < kMessages) {
+          ssize_t bytes = recv(fd, buffer, sizeof(buffer), 0);
+          if (bytes <= 0) break;
+          stream.append(buffer, static_cast<size_t>(bytes));
+        }
+        // Keep exactly the first kMessages (the last read can run past them).
+        size_t end = 0;
+        for (int i = 0; i < kMessages && end != std::string::npos; ++i) end = stream.find('\n', end + (i > 0));
+        stream.erase(end == std::string::npos ? stream.size() : end + 1);
+      }
+      if (fd >= 0) close(fd);
+      clients_done++;
+    });
+
+  // Keep broadcasting until every client has disconnected and been dropped (or a time limit).
+  long long seq = 0;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+  while ((clients_done < kClients || transport->client_count()) && std::chrono::steady_clock::now() < deadline) {
+    transport->update_clients();
+    transport->broadcast(std::to_string(seq++) + "\n");
+    if (seq % 64 == 0) std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+  for (auto &thread : threads) thread.join();
+
+  CHECK_MSG(transport->client_count() == 0, "%zu closed sockets were not dropped", transport->client_count());
+  for (int client = 0; client < kClients; ++client)
+    CHECK_MSG(check_broadcast_stream(streams[client], client) == kMessages, "client %d: short stream", client);
+
+  // The requests were all sent before the reads, so they have arrived by the time the socket closed
+  // but the transport thread may still be handing them over.
+  for (int i = 0; i < 100; ++i) {
+    {
+      std::scoped_lock lock(received.mutex);
+      size_t total = 0;
+      for (const auto &[client, lines] : received.by_client) total += lines.size();
+      if (total == kClients * kRequestLines) break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  transport.reset();  // Joins the socket thread.
+  check_requests(received, kClients, kRequestLines);
+  std::printf("unix socket: %d clients, %lld broadcasts\n", kClients, seq);
+}
+
+}  // namespace
+
+int main() {
+  soak_loopback();
+  soak_unix_socket();
+  return test_result();
+}
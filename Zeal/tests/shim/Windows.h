@@ -0,0 +1,32 @@
+#pragma once
+// Test stand-in for the Windows types used by the headers under test. The sizes follow Windows
+// (LONG is 32 bits) since the font files are read straight into structs holding RECTs.
+#include <climits>
+#include <cstdint>
+#include <cstring>  // The real header pulls in the C runtime string functions.
+
+typedef uint32_t DWORD;  // 32 bits like Windows, so vertex layouts match.
+typedef unsigned char BYTE;
+typedef int BOOL;
+typedef int INT;
+typedef unsigned int UINT;
+typedef uint32_t ULONG;
+typedef int32_t LONG;
+typedef int32_t HRESULT;
+
+#undef LONG_MAX
+#define LONG_MAX 2147483647
+
+#define TRUE 1
+#define FALSE 0
+#define SUCCEEDED(hr) (((HRESULT)(hr)) >= 0)
+#define FAILED(hr) (((HRESULT)(hr)) < 0)
+#define S_OK ((HRESULT)0)
+#define E_FAIL ((HRESULT)0x80004005L)
+
+typedef struct tagRECT {
+  LONG left;
+  LONG top;
+  LONG right;
+  LONG bottom;
+} RECT;
@@ -0,0 +1,17 @@
+#pragma once
+// Test stand-in for commands.h. Registered commands are kept so a test can look them up.
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class ChatCommands {
+ public:
+  using Callback = std::function<bool(std::vector<std::string> &args)>;
+
+  void Add(std::string cmd, std::vector<std::string> /*aliases*/, std::string /*description*/, Callback callback) {
+    CommandFunctions[cmd] = std::move(callback);
+  }
+
+  std::unordered_map<std::string, Callback> CommandFunctions;
+};
@@ -0,0 +1,187 @@
+#pragma once
+// Test stand-in for the Direct3D 8 interfaces used by the rendering code under test. Resources are
+// plain memory and the device keeps its state in members and records every draw call (with a copy of
+// the vertices it draws) so tests can check the output.
+#include <map>
+#include <vector>
+
+#include "d3d8types.h"
+
+// Reference counted like the COM objects (created with one reference).
+struct IUnknown {
+  ULONG AddRef() { return ++references; }
+  ULONG Release() {
+    const ULONG count = --references;
+    if (!count) delete this;
+    return count;
+  }
+
+ protected:
+  virtual ~IUnknown() = default;
+
+ private:
+  ULONG references = 1;
+};
+
+struct IDirect3DTexture8 : IUnknown {
+  UINT width = 0;
+  UINT height = 0;
+  D3DFORMAT format = D3DFMT_UNKNOWN;
+  INT pitch = 0;
+  std::vector<BYTE> data;  // height / 4 block rows of pitch bytes (only DXT formats are supported).
+  bool locked = false;
+
+  HRESULT LockRect(UINT level, D3DLOCKED_RECT *locked_rect, const RECT *rect, DWORD /*flags*/) {
+    if (level || rect || locked) return E_FAIL;
+    locked = true;
+    locked_rect->Pitch = pitch;
+    locked_rect->pBits = data.data();
+    return S_OK;
+  }
+  HRESULT UnlockRect(UINT level) {
+    if (level || !locked) return E_FAIL;
+    locked = false;
+    return S_OK;
+  }
+};
+
+struct IDirect3DBuffer8 : IUnknown {
+  std::vector<BYTE> data;
+  bool locked = false;
+
+  HRESULT Lock(UINT offset, UINT size, BYTE **buffer, DWORD /*flags*/) {
+    if (locked || offset + size > data.size()) return E_FAIL;
+    locked = true;
+    *buffer = data.data() + offset;
+    return S_OK;
+  }
+  HRESULT Unlock() {
+    if (!locked) return E_FAIL;
+    locked = false;
+    return S_OK;
+  }
+};
+
+struct IDirect3DVertexBuffer8 : IDirect3DBuffer8 {
+  DWORD fvf = 0;
+};
+
+struct IDirect3DIndexBuffer8 : IDirect3DBuffer8 {};
+
+struct IDirect3DDevice8 {
+  // A DrawIndexedPrimitive call with the state it used.
+  struct Draw {
+    DWORD vertex_shader;
+    IDirect3DTexture8 *texture;
+    D3DMATRIX world;
+    UINT vertex_stride;
+    std::vector<BYTE> vertices;     // The vertex range of the call.
+    std::vector<uint16_t> indices;  // Relative to the start of the range.
+  };
+
+  std::map<DWORD, DWORD> render_states;
+  std::map<DWORD, DWORD> texture_stage_states;  // Stage 0 only.
+  std::map<DWORD, D3DMATRIX> transforms;
+  D3DVIEWPORT8 viewport = {0, 0, 1920, 1080, 0, 1};
+  DWORD vertex_shader = 0;
+  IDirect3DTexture8 *texture = nullptr;
+  IDirect3DVertexBuffer8 *stream_source = nullptr;
+  UINT stream_stride = 0;
+  IDirect3DIndexBuffer8 *indices = nullptr;
+  std::vector<Draw> draws;
+  int textures_created = 0;
+
+  HRESULT CreateVertexBuffer(UINT length, DWORD /*usage*/, DWORD fvf, D3DPOOL /*pool*/,
+                             IDirect3DVertexBuffer8 **buffer) {
+    *buffer = new IDirect3DVertexBuffer8();
+    (*buffer)->data.resize(length);
+    (*buffer)->fvf = fvf;
+    return S_OK;
+  }
+  HRESULT CreateIndexBuffer(UINT length, DWORD /*usage*/, D3DFORMAT format, D3DPOOL /*pool*/,
+                            IDirect3DIndexBuffer8 **buffer) {
+    if (format != D3DFMT_INDEX16) return E_FAIL;
+    *buffer = new IDirect3DIndexBuffer8();
+    (*buffer)->data.resize(length);
+    return S_OK;
+  }
+
+  HRESULT GetRenderState(D3DRENDERSTATETYPE state, DWORD *value) {
+    *value = render_states[state];
+    return S_OK;
+  }
+  HRESULT SetRenderState(D3DRENDERSTATETYPE state, DWORD value) {
+    render_states[state] = value;
+    return S_OK;
+  }
+  HRESULT GetTextureStageState(DWORD stage, D3DTEXTURESTAGESTATETYPE state, DWORD *value) {
+    *value = stage ? 0 : texture_stage_states[state];
+    return S_OK;
+  }
+  HRESULT SetTextureStageState(DWORD stage, D3DTEXTURESTAGESTATETYPE state, DWORD value) {
+    if (!stage) texture_stage_states[state] = value;
+    return S_OK;
+  }
+  HRESULT GetTransform(D3DTRANSFORMSTATETYPE state, D3DMATRIX *matrix) {
+    auto it = transforms.find(state);
+    *matrix = (it != transforms.end()) ? it->second
+                                        : D3DMATRIX{{{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}, {0, 0, 0, 1}}};
+    return S_OK;
+  }
+  HRESULT SetTransform(D3DTRANSFORMSTATETYPE state, const D3DMATRIX *matrix) {
+    transforms[state] = *matrix;
+    return S_OK;
+  }
+  HRESULT GetViewport(D3DVIEWPORT8 *value) {
+    *value = viewport;
+    return S_OK;
+  }
+  HRESULT SetViewport(const D3DVIEWPORT8 *value) {
+    viewport = *value;
+    return S_OK;
+  }
+
+  HRESULT SetVertexShader(DWORD handle) {
+    vertex_shader = handle;
+    return S_OK;
+  }
+  HRESULT SetTexture(DWORD stage, IDirect3DTexture8 *value) {
+    if (!stage) texture = value;
+    return S_OK;
+  }
+  HRESULT SetStreamSource(UINT stream, IDirect3DVertexBuffer8 *buffer, UINT stride) {
+    if (stream) return E_FAIL;
+    stream_source = buffer;
+    stream_stride = stride;
+    return S_OK;
+  }
+  HRESULT SetIndices(IDirect3DIndexBuffer8 *buffer, UINT base_vertex_index) {
+    if (base_vertex_index) return E_FAIL;
+    indices = buffer;
+    return S_OK;
+  }
+
+  // Records the vertex range and indices of the call. Fails like the debug runtime on a locked buffer
+  // or an index outside of [min_index, min_index + vertex_count).
+  HRESULT DrawIndexedPrimitive(D3DPRIMITIVETYPE type, UINT min_index, UINT vertex_count, UINT start_index,
+                               UINT primitive_count) {
+    if (type != D3DPT_TRIANGLELIST || !stream_source || !indices || stream_source->locked || indices->locked)
+      return E_FAIL;
+    const UINT index_count = primitive_count * 3;
+    if ((start_index + index_count) * sizeof(uint16_t) > indices->data.size() ||
+        (min_index + vertex_count) * stream_stride > stream_source->data.size())
+      return E_FAIL;
+    Draw draw = {vertex_shader, texture, {}, stream_stride, {}, {}};
+    GetTransform(D3DTS_WORLD, &draw.world);
+    const BYTE *vertices = &stream_source->data[min_index * stream_stride];
+    draw.vertices.assign(vertices, vertices + vertex_count * stream_stride);
+    for (UINT i = 0; i < index_count; ++i) {
+      uint16_t index;
+      std::memcpy(&index, &indices->data[(start_index + i) * sizeof(uint16_t)], sizeof(index));
+      if (index < min_index || index >= min_index + vertex_count) return E_FAIL;
+      draw.indices.push_back(static_cast<uint16_t>(index - min_index));
+    }
+    draws.push_back(std::move(draw));
+    return S_OK;
+  }
+};
@@ -0,0 +1,79 @@
+#pragma once
+// Test stand-in for the Direct3D 8 types and constants used by the rendering code under test.
+// The values match the real d3d8types.h.
+#include <Windows.h>
+
+typedef DWORD D3DCOLOR;
+#define D3DCOLOR_ARGB(a, r, g, b) \
+  ((D3DCOLOR)((((a) & 0xff) << 24) | (((r) & 0xff) << 16) | (((g) & 0xff) << 8) | ((b) & 0xff)))
+#define D3DCOLOR_XRGB(r, g, b) D3DCOLOR_ARGB(0xff, r, g, b)
+
+#define D3DFVF_XYZ 0x002
+#define D3DFVF_XYZRHW 0x004
+#define D3DFVF_DIFFUSE 0x040
+#define D3DFVF_TEX1 0x100
+
+#define D3DUSAGE_WRITEONLY 0x00000008L
+#define D3DUSAGE_DYNAMIC 0x00000200L
+#define D3DLOCK_NOOVERWRITE 0x00001000L
+#define D3DLOCK_DISCARD 0x00002000L
+
+#define D3DTA_DIFFUSE 0x00000000
+#define D3DTA_TEXTURE 0x00000002
+
+enum D3DFORMAT : DWORD {
+  D3DFMT_UNKNOWN = 0,
+  D3DFMT_INDEX16 = 101,
+  D3DFMT_DXT2 = 0x32545844,  // MAKEFOURCC('D', 'X', 'T', '2')
+};
+
+enum D3DPOOL { D3DPOOL_DEFAULT = 0, D3DPOOL_MANAGED = 1 };
+
+enum D3DPRIMITIVETYPE { D3DPT_TRIANGLELIST = 4 };
+
+enum D3DRENDERSTATETYPE {
+  D3DRS_ZENABLE = 7,
+  D3DRS_ZWRITEENABLE = 14,
+  D3DRS_SRCBLEND = 19,
+  D3DRS_DESTBLEND = 20,
+  D3DRS_CULLMODE = 22,
+  D3DRS_ALPHABLENDENABLE = 27,
+  D3DRS_LIGHTING = 137,
+  D3DRS_BLENDOP = 171,
+};
+
+enum D3DTEXTURESTAGESTATETYPE {
+  D3DTSS_COLOROP = 1,
+  D3DTSS_COLORARG1 = 2,
+  D3DTSS_COLORARG2 = 3,
+  D3DTSS_ALPHAOP = 4,
+  D3DTSS_ALPHAARG1 = 5,
+  D3DTSS_ALPHAARG2 = 6,
+  D3DTSS_MINFILTER = 17,
+};
+
+enum D3DTRANSFORMSTATETYPE { D3DTS_VIEW = 2, D3DTS_PROJECTION = 3, D3DTS_WORLD = 256 };
+
+enum D3DCULL { D3DCULL_NONE = 1 };
+enum D3DBLEND { D3DBLEND_SRCALPHA = 5, D3DBLEND_INVSRCALPHA = 6 };
+enum D3DBLENDOP { D3DBLENDOP_ADD = 1 };
+enum D3DTEXTUREOP { D3DTOP_MODULATE = 4 };
+enum D3DTEXTUREFILTERTYPE { D3DTEXF_LINEAR = 2 };
+
+struct D3DMATRIX {
+  float m[4][4];
+};
+
+struct D3DVIEWPORT8 {
+  DWORD X;
+  DWORD Y;
+  DWORD Width;
+  DWORD Height;
+  float MinZ;
+  float MaxZ;
+};
+
+struct D3DLOCKED_RECT {
+  INT Pitch;
+  void *pBits;
+};
@@ -0,0 +1,50 @@
+#pragma once
+// Test stand-in for the D3DX helpers (the real d3dx8math.h includes all of d3dx8.h).
+#include "d3d8.h"
+
+struct D3DXMATRIX : D3DMATRIX {
+  D3DXMATRIX() = default;
+  D3DXMATRIX(const D3DMATRIX &matrix) : D3DMATRIX(matrix) {}
+
+  float &operator()(UINT row, UINT col) { return m[row][col]; }
+  float operator()(UINT row, UINT col) const { return m[row][col]; }
+
+  D3DXMATRIX operator*(const D3DXMATRIX &other) const {
+    D3DXMATRIX result;
+    for (int row = 0; row < 4; ++row)
+      for (int col = 0; col < 4; ++col) {
+        result.m[row][col] = 0;
+        for (int k = 0; k < 4; ++k) result.m[row][col] += m[row][k] * other.m[k][col];
+      }
+    return result;
+  }
+};
+
+inline D3DXMATRIX *D3DXMatrixIdentity(D3DXMATRIX *out) {
+  *out = D3DMATRIX{{{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}, {0, 0, 0, 1}}};
+  return out;
+}
+
+inline D3DXMATRIX *D3DXMatrixScaling(D3DXMATRIX *out, float x, float y, float z) {
+  *out = D3DMATRIX{{{x, 0, 0, 0}, {0, y, 0, 0}, {0, 0, z, 0}, {0, 0, 0, 1}}};
+  return out;
+}
+
+inline D3DXMATRIX *D3DXMatrixTranslation(D3DXMATRIX *out, float x, float y, float z) {
+  *out = D3DMATRIX{{{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}, {x, y, z, 1}}};
+  return out;
+}
+
+// Creates a single level DXT texture of zeroed blocks.
+inline HRESULT D3DXCreateTexture(IDirect3DDevice8 *device, UINT width, UINT height, UINT mip_levels,
+                                 DWORD /*usage*/, D3DFORMAT format, D3DPOOL /*pool*/, IDirect3DTexture8 **texture) {
+  if (mip_levels != 1 || format != D3DFMT_DXT2 || !width || !height || width % 4 || height % 4) return E_FAIL;
+  *texture = new IDirect3DTexture8();
+  (*texture)->width = width;
+  (*texture)->height = height;
+  (*texture)->format = format;
+  (*texture)->pitch = static_cast<INT>(width / 4 * 16);
+  (*texture)->data.assign(size_t((*texture)->pitch) * (height / 4), 0xcd);  // Garbage until written.
+  device->textures_created++;
+  return S_OK;
+}
@@ -0,0 +1,35 @@
+#include "game_functions.h"
+
+#include <cstdarg>
+#include <cstdio>
+
+namespace Zeal {
+namespace Game {
+std::vector<std::string> &get_test_chat_lines() {
+  static std::vector<std::string> lines;
+  return lines;
+}
+
+static void print_chat_va(const char *format, va_list args) {
+  char buffer[2048];
+  std::vsnprintf(buffer, sizeof(buffer), format, args);
+  get_test_chat_lines().push_back(buffer);
+}
+
+void print_chat(const std::string &data) { get_test_chat_lines().push_back(data); }
+
+void print_chat(const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  print_chat_va(format, args);
+  va_end(args);
+}
+
+void print_chat(short /*color*/, const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  print_chat_va(format, args);
+  va_end(args);
+}
+}  // namespace Game
+}  // namespace Zeal
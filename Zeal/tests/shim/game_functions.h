@@ -0,0 +1,18 @@
+#pragma once
+// Test stand-in for the parts of game_functions.h used by the code under test. Chat output is
+// recorded instead of going to the client.
+#include <string>
+#include <vector>
+
+namespace Zeal {
+namespace Game {
+void print_chat(const std::string &data);
+void print_chat(const char *format, ...);
+void print_chat(short color, const char *format, ...);
+
+inline int get_screen_resolution_x() { return 1920; }
+inline int get_screen_resolution_y() { return 1080; }
+
+std::vector<std::string> &get_test_chat_lines();  // Every line printed so far.
+}  // namespace Game
+}  // namespace Zeal
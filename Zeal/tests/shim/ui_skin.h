@@ -0,0 +1,8 @@
+#pragma once
+// Test stand-in for the UI skin paths (fonts are loaded from the working directory).
+#include <filesystem>
+
+class UISkin {
+ public:
+  static std::filesystem::path get_zeal_resources_path() { return "."; }
+};
@@ -0,0 +1,10 @@
+#pragma once
+// Test stand-in for the ZealService members used by the code under test.
+#include <memory>
+
+#include "commands.h"
+
+class ZealService {
+ public:
+  std::unique_ptr<ChatCommands> commands_hook = std::make_unique<ChatCommands>();
+};
@@ -0,0 +1,706 @@
+// Checks the constexpr spell category and subcategory name tables against the switch statements
+// they replaced, over every id the switches handled and past the ends of the tables.
+#include "spell_categories.h"
+
+#include <string>
+
+#include "test_util.h"
+
+namespace old_switch {
+// The name lookups as they were before the tables (unchanged apart from the namespace).
+static inline std::string GetSpellCategoryName(DWORD categoryID) {
+  switch (categoryID) {
+    case 1:
+      return "Aegolism";
+    case 2:
+      return "Agility";
+    case 3:
+      return "Alliance";
+    case 4:
+      return "Animal";
+    case 5:
+      return "Antonica";
+    case 6:
+      return "Armor Class";
+    case 7:
+      return "Attack";
+    case 8:
+      return "Bane";
+    case 9:
+      return "Blind";
+    case 10:
+      return "Block";
+    case 11:
+      return "Calm";
+    case 12:
+      return "Charisma";
+    case 13:
+      return "Charm";
+    case 14:
+      return "Cold";
+    case 15:
+      return "Combat Abilities";
+    case 16:
+      return "Combat Innates";
+    case 17:
+      return "Conversions";
+    case 18:
+      return "Create Item";
+    case 19:
+      return "Cure";
+    case 20:
+      return "Damage Over Time";
+    case 21:
+      return "Damage Shield";
+    case 22:
+      return "Defensive";
+    case 23:
+      return "Destroy";
+    case 24:
+      return "Dexterity";
+    case 25:
+      return "Direct Damage ";
+    case 26:
+      return "Disarm Traps";
+    case 27:
+      return "Disciplines";
+    case 28:
+      return "Discord";
+    case 29:
+      return "Disease";
+    case 30:
+      return "Disempowering";
+    case 31:
+      return "Dispel";
+    case 32:
+      return "Duration Heals";
+    case 33:
+      return "Duration Tap";
+    case 34:
+      return "Enchant Metal";
+    case 35:
+      return "Enthrall";
+    case 36:
+      return "Faydwer";
+    case 37:
+      return "Fear";
+    case 38:
+      return "Fire";
+    case 39:
+      return "Fizzle Rate";
+    case 40:
+      return "Fumble";
+    case 41:
+      return "Haste";
+    case 42:
+      return "Heals";
+    case 43:
+      return "Health";
+    case 44:
+      return "Health/Mana";
+    case 45:
+      return "HP Buffs";
+    case 46:
+      return "HP type one";
+    case 47:
+      return "HP type two";
+    case 48:
+      return "Illusion: Other";
+    case 49:
+      return "Illusion: Player";
+    case 50:
+      return "Imbue Gem";
+    case 51:
+      return "Invisibility";
+    case 52:
+      return "Invulnerability";
+    case 53:
+      return "Jolt";
+    case 54:
+      return "Kunark";
+    case 55:
+      return "Levitate";
+    case 56:
+      return "Life Flow";
+    case 57:
+      return "Luclin";
+    case 58:
+      return "Magic";
+    case 59:
+      return "Mana";
+    case 60:
+      return "Mana Drain";
+    case 61:
+      return "Mana Flow";
+    case 62:
+      return "Melee Guard";
+    case 63:
+      return "Memory Blur";
+    case 64:
+      return "Misc";
+    case 65:
+      return "Movement";
+    case 66:
+      return "Objects";
+    case 67:
+      return "Odus";
+    case 68:
+      return "Offensive";
+    case 69:
+      return "Pet";
+    case 70:
+      return "Pet Haste";
+    case 71:
+      return "Pet Misc Buffs";
+    case 72:
+      return "Physical";
+    case 73:
+      return "Picklock";
+    case 74:
+      return "Plant";
+    case 75:
+      return "Poison";
+    case 76:
+      return "Power Tap";
+    case 77:
+      return "Quick Heal";
+    case 78:
+      return "Reflection";
+    case 79:
+      return "Regen";
+    case 80:
+      return "Resist Buff";
+    case 81:
+      return "Resist Debuffs";
+    case 82:
+      return "Resurrection";
+    case 83:
+      return "Root";
+    case 84:
+      return "Rune";
+    case 85:
+      return "Sense Trap";
+    case 86:
+      return "Shadowstep";
+    case 87:
+      return "Shielding";
+    case 88:
+      return "Slow";
+    case 89:
+      return "Snare";
+    case 90:
+      return "Special";
+    case 91:
+      return "Spell Focus";
+    case 92:
+      return "Spell Guard";
+    case 93:
+      return "Spellshield";
+    case 94:
+      return "Stamina";
+    case 95:
+      return "Statistic Buffs";
+    case 96:
+      return "Strength";
+    case 97:
+      return "Stun";
+    case 98:
+      return "Sum: Air";
+    case 99:
+      return "Sum: Animation";
+    case 100:
+      return "Sum: Earth";
+    case 101:
+      return "Sum: Familiar";
+    case 102:
+      return "Sum: Fire";
+    case 103:
+      return "Sum: Undead";
+    case 104:
+      return "Sum: Warder";
+    case 105:
+      return "Sum: Water";
+    case 106:
+      return "Summon Armor";
+    case 107:
+      return "Summon Focus";
+    case 108:
+      return "Summon Food/Water";
+    case 109:
+      return "Summon Utility";
+    case 110:
+      return "Summon Weapon";
+    case 111:
+      return "Summoned";
+    case 112:
+      return "Symbol";
+    case 113:
+      return "Taelosia";
+    case 114:
+      return "Taps";
+    case 115:
+      return "Techniques";
+    case 116:
+      return "The Planes";
+    case 117:
+      return "Timer 1";
+    case 118:
+      return "Timer 2";
+    case 119:
+      return "Timer 3";
+    case 120:
+      return "Timer 4";
+    case 121:
+      return "Timer 5";
+    case 122:
+      return "Timer 6";
+    case 123:
+      return "Transport";
+    case 124:
+      return "Undead";
+    case 125:
+      return "Utility Beneficial";
+    case 126:
+      return "Utility Detrimental";
+    case 127:
+      return "Velious";
+    case 128:
+      return "Visages";
+    case 129:
+      return "Vision";
+    case 130:
+      return "Wisdom/Intelligence";
+    case 131:
+      return "Traps";
+    case 132:
+      return "Auras";
+    case 133:
+      return "Endurance";
+    case 134:
+      return "Serpent's Spine";
+    case 135:
+      return "Corruption";
+    case 136:
+      return "Learning";
+    case 137:
+      return "Chromatic";
+    case 138:
+      return "Prismatic";
+    case 139:
+      return "Sum: Swarm";
+    case 140:
+      return "Delayed";
+    case 141:
+      return "Temporary";
+    case 142:
+      return "Twincast";
+    case 143:
+      return "Sum: Bodyguard";
+    case 144:
+      return "Humanoid";
+    case 145:
+      return "Haste/Spell Focus";
+    case 146:
+      return "Timer 7";
+    case 147:
+      return "Timer 8";
+    case 148:
+      return "Timer 9";
+    case 149:
+      return "Timer 10";
+    case 150:
+      return "Timer 11";
+    case 151:
+      return "Timer 12";
+    case 152:
+      return "Hatred";
+    case 153:
+      return "Fast";
+    case 154:
+      return "Illusion: Special";
+    case 155:
+      return "Timer 13";
+    case 156:
+      return "Timer 14";
+    case 157:
+      return "Timer 15";
+    case 158:
+      return "Timer 16";
+    case 159:
+      return "Timer 17";
+    case 160:
+      return "Timer 18";
+    case 161:
+      return "Timer 19";
+    case 162:
+      return "Timer 20";
+    case 163:
+      return "Alaris";
+    default:
+      return "Unknown";
+  }
+}
+
+static inline std::string GetSpellSubCategoryName(DWORD subcategoryID) {
+  switch (subcategoryID) {
+    case 1:
+      return "Aegolism";
+    case 2:
+      return "Agility";
+    case 3:
+      return "Alliance";
+    case 4:
+      return "Animal";
+    case 5:
+      return "Antonica";
+    case 6:
+      return "Armor Class";
+    case 7:
+      return "Attack";
+    case 8:
+      return "Bane";
+    case 9:
+      return "Blind";
+    case 10:
+      return "Block";
+    case 11:
+      return "Calm";
+    case 12:
+      return "Charisma";
+    case 13:
+      return "Charm";
+    case 14:
+      return "Cold";
+    case 15:
+      return "Combat Abilities";
+    case 16:
+      return "Combat Innates";
+    case 17:
+      return "Conversions";
+    case 18:
+      return "Create Item";
+    case 19:
+      return "Cure";
+    case 20:
+      return "Damage Over Time";
+    case 21:
+      return "Damage Shield";
+    case 22:
+      return "Defensive";
+    case 23:
+      return "Destroy";
+    case 24:
+      return "Dexterity";
+    case 25:
+      return "Direct Damage ";
+    case 26:
+      return "Disarm Traps";
+    case 27:
+      return "Disciplines";
+    case 28:
+      return "Discord";
+    case 29:
+      return "Disease";
+    case 30:
+      return "Disempowering";
+    case 31:
+      return "Dispel";
+    case 32:
+      return "Duration Heals";
+    case 33:
+      return "Duration Tap";
+    case 34:
+      return "Enchant Metal";
+    case 35:
+      return "Enthrall";
+    case 36:
+      return "Faydwer";
+    case 37:
+      return "Fear";
+    case 38:
+      return "Fire";
+    case 39:
+      return "Fizzle Rate";
+    case 40:
+      return "Fumble";
+    case 41:
+      return "Haste";
+    case 42:
+      return "Heals";
+    case 43:
+      return "Health";
+    case 44:
+      return "Health/Mana";
+    case 45:
+      return "HP Buffs";
+    case 46:
+      return "HP type one";
+    case 47:
+      return "HP type two";
+    case 48:
+      return "Illusion: Other";
+    case 49:
+      return "Illusion: Player";
+    case 50:
+      return "Imbue Gem";
+    case 51:
+      return "Invisibility";
+    case 52:
+      return "Invulnerability";
+    case 53:
+      return "Jolt";
+    case 54:
+      return "Kunark";
+    case 55:
+      return "Levitate";
+    case 56:
+      return "Life Flow";
+    case 57:
+      return "Luclin";
+    case 58:
+      return "Magic";
+    case 59:
+      return "Mana";
+    case 60:
+      return "Mana Drain";
+    case 61:
+      return "Mana Flow";
+    case 62:
+      return "Melee Guard";
+    case 63:
+      return "Memory Blur";
+    case 64:
+      return "Misc";
+    case 65:
+      return "Movement";
+    case 66:
+      return "Objects";
+    case 67:
+      return "Odus";
+    case 68:
+      return "Offensive";
+    case 69:
+      return "Pet";
+    case 70:
+      return "Pet Haste";
+    case 71:
+      return "Pet Misc Buffs";
+    case 72:
+      return "Physical";
+    case 73:
+      return "Picklock";
+    case 74:
+      return "Plant";
+    case 75:
+      return "Poison";
+    case 76:
+      return "Power Tap";
+    case 77:
+      return "Quick Heal";
+    case 78:
+      return "Reflection";
+    case 79:
+      return "Regen";
+    case 80:
+      return "Resist Buff";
+    case 81:
+      return "Resist Debuffs";
+    case 82:
+      return "Resurrection";
+    case 83:
+      return "Root";
+    case 84:
+      return "Rune";
+    case 85:
+      return "Sense Trap";
+    case 86:
+      return "Shadowstep";
+    case 87:
+      return "Shielding";
+    case 88:
+      return "Slow";
+    case 89:
+      return "Snare";
+    case 90:
+      return "Special";
+    case 91:
+      return "Spell Focus";
+    case 92:
+      return "Spell Guard";
+    case 93:
+      return "Spellshield";
+    case 94:
+      return "Stamina";
+    case 95:
+      return "Statistic Buffs";
+    case 96:
+      return "Strength";
+    case 97:
+      return "Stun";
+    case 98:
+      return "Sum: Air";
+    case 99:
+      return "Sum: Animation";
+    case 100:
+      return "Sum: Earth";
+    case 101:
+      return "Sum: Familiar";
+    case 102:
+      return "Sum: Fire";
+    case 103:
+      return "Sum: Undead";
+    case 104:
+      return "Sum: Warder";
+    case 105:
+      return "Sum: Water";
+    case 106:
+      return "Summon Armor";
+    case 107:
+      return "Summon Focus";
+    case 108:
+      return "Summon Food/Water";
+    case 109:
+      return "Summon Utility";
+    case 110:
+      return "Summon Weapon";
+    case 111:
+      return "Summoned";
+    case 112:
+      return "Symbol";
+    case 113:
+      return "Taelosia";
+    case 114:
+      return "Taps";
+    case 115:
+      return "Techniques";
+    case 116:
+      return "The Planes";
+    case 117:
+      return "Timer 1";
+    case 118:
+      return "Timer 2";
+    case 119:
+      return "Timer 3";
+    case 120:
+      return "Timer 4";
+    case 121:
+      return "Timer 5";
+    case 122:
+      return "Timer 6";
+    case 123:
+      return "Transport";
+    case 124:
+      return "Undead";
+    case 125:
+      return "Utility Beneficial";
+    case 126:
+      return "Utility Detrimental";
+    case 127:
+      return "Velious";
+    case 128:
+      return "Visages";
+    case 129:
+      return "Vision";
+    case 130:
+      return "Wisdom/Intelligence";
+    case 131:
+      return "Traps";
+    case 132:
+      return "Auras";
+    case 133:
+      return "Endurance";
+    case 134:
+      return "Serpent's Spine";
+    case 135:
+      return "Corruption";
+    case 136:
+      return "Learning";
+    case 137:
+      return "Chromatic";
+    case 138:
+      return "Prismatic";
+    case 139:
+      return "Sum: Swarm";
+    case 140:
+      return "Delayed";
+    case 141:
+      return "Temporary";
+    case 142:
+      return "Twincast";
+    case 143:
+      return "Sum: Bodyguard";
+    case 144:
+      return "Humanoid";
+    case 145:
+      return "Haste/Spell Focus";
+    case 146:
+      return "Timer 7";
+    case 147:
+      return "Timer 8";
+    case 148:
+      return "Timer 9";
+    case 149:
+      return "Timer 10";
+    case 150:
+      return "Timer 11";
+    case 151:
+      return "Timer 12";
+    case 152:
+      return "Hatred";
+    case 153:
+      return "Fast";
+    case 154:
+      return "Illusion: Special";
+    case 155:
+      return "Timer 13";
+    case 156:
+      return "Timer 14";
+    case 157:
+      return "Timer 15";
+    case 158:
+      return "Timer 16";
+    case 159:
+      return "Timer 17";
+    case 160:
+      return "Timer 18";
+    case 161:
+      return "Timer 19";
+    case 162:
+      return "Timer 20";
+    case 163:
+      return "Alaris";
+    case 164:  // Alternative transport subcategories.
+      return "Self";
+    case 165:
+      return "Group";
+    case 166:
+      return "Target";
+    case 167:
+      return "Area";
+    default:
+      return "Unknown";
+  }
+}
+
+}  // namespace old_switch
+
+static_assert(GetSpellCategoryName(0) == "Unknown" && GetSpellSubCategoryName(0) == "Unknown");
+static_assert(GetSpellCategoryName(1) == "Aegolism" && GetSpellSubCategoryName(167) == "Area");
+static_assert(GetSpellCategoryName(0xffffffff) == "Unknown" && GetSpellSubCategoryName(168) == "Unknown");
+
+int main() {
+  int checked = 0;
+  for (DWORD id = 0; id < 1024; ++id, ++checked) {
+    CHECK_MSG(GetSpellCategoryName(id) == old_switch::GetSpellCategoryName(id), "category %u: \"%s\" vs \"%s\"", id,
+              std::string(GetSpellCategoryName(id)).c_str(), old_switch::GetSpellCategoryName(id).c_str());
+    CHECK_MSG(GetSpellSubCategoryName(id) == old_switch::GetSpellSubCategoryName(id),
+              "subcategory %u: \"%s\" vs \"%s\"", id, std::string(GetSpellSubCategoryName(id)).c_str(),
+              old_switch::GetSpellSubCategoryName(id).c_str());
+  }
+  for (DWORD id : {0x7fffffffUL, 0x80000000UL, 0xfffffffeUL, 0xffffffffUL}) {
+    CHECK(GetSpellCategoryName(id) == old_switch::GetSpellCategoryName(id));
+    CHECK(GetSpellSubCategoryName(id) == old_switch::GetSpellSubCategoryName(id));
+  }
+  std::printf("spell categories: %d ids checked\n", checked);
+  return test_result();
+}
@@ -0,0 +1,117 @@
+// Compares the allocating string_util paths with the string_view variants used by the hot callers
+// (command parsing, nameplate tags, survey messages and the raid bars class lists).
+// Usage: string_util_bench [iterations]
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "string_util.h"
+
+namespace {
+
+const std::vector<std::string> kCommandLines = {
+    "/zeal chatbench eqlog_Varden_pq.proj.txt 20000",
+    "  /nameplate   tagarrows  on ",
+    "hello there, this is a plain chat line that is not a command",
+    "/pipe verbose on",
+};
+const std::vector<std::string> kTagMessages = {
+    "ZEAL_TAG | ^sTank one | 0 | 1234",
+    "ZTAG | +Off tank | 1 | 987",
+    "ZEAL_SURVEY | survey123 | Do we pull the next wing now?",
+};
+const std::vector<std::string> kNumbers = {"42", " 1500", "+7", "-12", "200abc"};
+
+template <typename Fn>
+void run(const char *name, int iterations, size_t ops_per_iteration, Fn &&fn) {
+  volatile size_t sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) sink = sink + fn();
+  std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  std::printf("  %-40s %8.1f ns/op\n", name, elapsed.count() / (static_cast<double>(iterations) * ops_per_iteration));
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  const int iterations = argc > 1 ? std::atoi(argv[1]) : 200000;
+  if (iterations < 1) {
+    std::printf("Usage: string_util_bench [iterations]\n");
+    return 1;
+  }
+
+  std::printf("split (command lines):\n");
+  run("split -> vector<string>", iterations, kCommandLines.size(), [] {
+    size_t count = 0;
+    for (const auto &line : kCommandLines) count += Zeal::String::split(line, " ").size();
+    return count;
+  });
+  std::vector<std::string_view> tokens;
+  run("split -> reused vector<string_view>", iterations, kCommandLines.size(), [&tokens] {
+    size_t count = 0;
+    for (const auto &line : kCommandLines) {
+      Zeal::String::split(line, " ", tokens);
+      count += tokens.size();
+    }
+    return count;
+  });
+
+  std::printf("split_text (tag and survey messages):\n");
+  run("split_text -> vector<string>", iterations, kTagMessages.size(), [] {
+    size_t count = 0;
+    for (const auto &message : kTagMessages) count += Zeal::String::split_text(message, " | ").size();
+    return count;
+  });
+  run("split_text -> reused vector<string_view>", iterations, kTagMessages.size(), [&tokens] {
+    size_t count = 0;
+    for (const auto &message : kTagMessages) {
+      Zeal::String::split_text(message, " | ", tokens);
+      count += tokens.size();
+    }
+    return count;
+  });
+
+  std::printf("trim:\n");
+  run("trim_and_reduce_spaces", iterations, kCommandLines.size(), [] {
+    size_t length = 0;
+    for (const auto &line : kCommandLines) length += Zeal::String::trim_and_reduce_spaces(line).size();
+    return length;
+  });
+  run("trim (string_view)", iterations, kCommandLines.size(), [] {
+    size_t length = 0;
+    for (const auto &line : kCommandLines) length += Zeal::String::trim(line).size();
+    return length;
+  });
+
+  std::printf("number parsing:\n");
+  run("std::stoi (previous tryParse)", iterations, kNumbers.size(), [] {
+    size_t total = 0;
+    for (const auto &number : kNumbers) total += std::stoi(number);
+    return total;
+  });
+  run("tryParse (std::from_chars)", iterations, kNumbers.size(), [] {
+    size_t total = 0;
+    for (const auto &number : kNumbers) {
+      int value = 0;
+      if (Zeal::String::tryParse(number, &value, true)) total += value;
+    }
+    return total;
+  });
+  run("std::stoi, invalid argument (throws)", std::max(iterations / 10, 1), 1, [] {
+    try {
+      return static_cast<size_t>(std::stoi("abc"));
+    } catch (const std::exception &) {
+      return size_t(0);
+    }
+  });
+  run("tryParse, invalid argument", std::max(iterations / 10, 1), 1, [] {
+    int value = 0;
+    return static_cast<size_t>(Zeal::String::tryParse("abc", &value, true));
+  });
+  return 0;
+}
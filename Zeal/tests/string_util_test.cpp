@@ -0,0 +1,276 @@
+#include "string_util.h"
+
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "game_functions.h"
+#include "test_util.h"
+
+namespace {
+
+std::string replaced(std::string input, const std::string &from, const std::string &to) {
+  std::string result = Zeal::String::replace(input, from, to);
+  CHECK_MSG(result == input, "replace() returned \"%s\" but left \"%s\"", result.c_str(), input.c_str());
+  return input;
+}
+
+void test_replace_overlapping() {
+  // Matches are taken left to right and a match consumes its characters.
+  CHECK(replaced("aaaa", "aa", "b") == "bb");
+  CHECK(replaced("aaa", "aa", "b") == "ba");
+  CHECK(replaced("abababa", "aba", "X") == "XbX");
+  CHECK(replaced("%n%n%n", "%n", "50%") == "50%50%50%");
+  // The replacement is not rescanned, even when it contains (or forms) the needle.
+  CHECK(replaced("cat", "a", "aa") == "caat");
+  CHECK(replaced("xax", "a", "xa") == "xxax");
+  CHECK(replaced("hp", "hp", "hphp") == "hphp");
+}
+
+void test_replace_empty() {
+  CHECK(replaced("unchanged", "", "x") == "unchanged");
+  CHECK(replaced("", "", "x") == "");
+  CHECK(replaced("", "a", "x") == "");
+  CHECK(replaced("remove all of the o's", "o", "") == "remve all f the 's");
+  CHECK(replaced("ab", "ab", "") == "");
+  CHECK(replaced("short", "much longer needle", "x") == "short");
+}
+
+void test_replace_mixed_case() {
+  CHECK(replaced("Hello HELLO hello hElLo", "hello", "x") == "x x x x");
+  CHECK(replaced("Hello HELLO hello hElLo", "HeLLo", "x") == "x x x x");
+  CHECK(replaced("MANA: %MANA, %Mana", "%mana", "80%") == "MANA: 80%, 80%");
+  CHECK(replaced("AbC", "abc", "XyZ") == "XyZ");  // The replacement keeps its own case.
+  CHECK(replaced("[Target]", "[target]", "Soandso") == "Soandso");
+  // Only ASCII letters fold. Other bytes (Windows-1252 or UTF-8 text) must match exactly.
+  CHECK(replaced("Caf\xC9 caf\xE9", "caf\xE9", "x") == "Caf\xC9 x");
+  CHECK(replaced("a@b`c", "A@B`C", "x") == "x");
+  CHECK(replaced("[{", "{[", "x") == "[{");  // '[' and '{' differ by the case bit but aren't letters.
+}
+
+// For needles without regex syntax the literal replace must match the regex implementation it replaced.
+void test_replace_matches_regex() {
+  std::mt19937 rng(37);
+  static constexpr char kAlphabet[] = "aAbB %";
+  auto random_text = [&rng](size_t max_length) {
+    std::string text(rng() % (max_length + 1), ' ');
+    for (char &c : text) c = kAlphabet[rng() % (sizeof(kAlphabet) - 1)];
+    return text;
+  };
+  for (int i = 0; i < 20000; ++i) {
+    std::string input = random_text(16);
+    std::string from = random_text(3);
+    std::string to = random_text(3);
+    if (from.empty()) continue;
+    std::string expected = input;
+    Zeal::String::replace_regex(expected, from, to);
+    std::string actual = replaced(input, from, to);
+    CHECK_MSG(actual == expected, "\"%s\" / \"%s\" -> \"%s\": \"%s\" vs regex \"%s\"", input.c_str(), from.c_str(),
+              to.c_str(), actual.c_str(), expected.c_str());
+  }
+}
+
+// Decodes all of text and returns the code points, checking each call advances to the next one.
+std::vector<uint32_t> decoded(const char *text) {
+  std::vector<uint32_t> codepoints;
+  while (*text) {
+    const char *start = text;
+    codepoints.push_back(Zeal::String::decode_codepoint(text));
+    CHECK_MSG(text > start && text <= start + 4, "advanced %td bytes", text - start);
+  }
+  return codepoints;
+}
+
+using Codepoints = std::vector<uint32_t>;
+
+void test_decode_valid_utf8() {
+  CHECK(decoded("") == Codepoints{});
+  CHECK(decoded("Az~\x7f") == (Codepoints{'A', 'z', '~', 0x7f}));
+  CHECK(decoded("Caf\xC3\xA9") == (Codepoints{'C', 'a', 'f', 0xe9}));
+  // The shortest and longest form of each length.
+  CHECK(decoded("\xC2\x80\xDF\xBF") == (Codepoints{0x80, 0x7ff}));
+  CHECK(decoded("\xE0\xA0\x80\xEF\xBF\xBF") == (Codepoints{0x800, 0xffff}));
+  CHECK(decoded("\xF0\x90\x80\x80\xF4\x8F\xBF\xBF") == (Codepoints{0x10000, 0x10ffff}));
+  // Right next to the surrogates, and the euro sign in UTF-8.
+  CHECK(decoded("\xED\x9F\xBF\xEE\x80\x80\xE2\x82\xAC") == (Codepoints{0xd7ff, 0xe000, 0x20ac}));
+}
+
+// Malformed UTF-8 falls back to one Windows-1252 character per byte.
+void test_decode_malformed_utf8() {
+  // Overlong forms of '/' (and of U+0000 in C0 80).
+  CHECK(decoded("\xC0\xAF") == (Codepoints{0xc0, 0xaf}));
+  CHECK(decoded("\xC1\xBF") == (Codepoints{0xc1, 0xbf}));
+  CHECK(decoded("\xC0\x80") == (Codepoints{0xc0, 0x20ac}));
+  CHECK(decoded("\xE0\x80\xAF") == (Codepoints{0xe0, 0x20ac, 0xaf}));
+  CHECK(decoded("\xE0\x9F\xBF") == (Codepoints{0xe0, 0x178, 0xbf}));  // U+07FF in three bytes.
+  CHECK(decoded("\xF0\x80\x80\xAF") == (Codepoints{0xf0, 0x20ac, 0x20ac, 0xaf}));
+  CHECK(decoded("\xF0\x8F\xBF\xBF") == (Codepoints{0xf0, 0x8f, 0xbf, 0xbf}));  // U+FFFF in four bytes.
+  // UTF-16 surrogates (lead, trail and an encoded pair).
+  CHECK(decoded("\xED\xA0\x80") == (Codepoints{0xed, 0xa0, 0x20ac}));
+  CHECK(decoded("\xED\xBF\xBF") == (Codepoints{0xed, 0xbf, 0xbf}));
+  CHECK(decoded("\xED\xA0\xBD\xED\xB8\x80") == (Codepoints{0xed, 0xa0, 0xbd, 0xed, 0xb8, 0x20ac}));
+  // Past U+10FFFF, including the lead bytes that can only start one.
+  CHECK(decoded("\xF4\x90\x80\x80") == (Codepoints{0xf4, 0x90, 0x20ac, 0x20ac}));
+  CHECK(decoded("\xF5\x80\x80\x80") == (Codepoints{0xf5, 0x20ac, 0x20ac, 0x20ac}));
+  CHECK(decoded("\xFF\xFE") == (Codepoints{0xff, 0xfe}));
+  // Stray continuation bytes and a lead byte followed by a new sequence.
+  CHECK(decoded("\xA9x") == (Codepoints{0xa9, 'x'}));
+  CHECK(decoded("\xC3\xC3\xA9") == (Codepoints{0xc3, 0xe9}));
+  CHECK(decoded("\xE2\x82x") == (Codepoints{0xe2, 0x201a, 'x'}));
+}
+
+// A sequence cut short by the end of the string decodes byte by byte and never reads past the null.
+void test_decode_truncated() {
+  for (const char *text : {"\xC3", "\xE2\x82", "\xF0\x9F\x98"}) {
+    const size_t length = std::strlen(text);
+    std::vector<char> buffer(text, text + length + 1);  // Exactly sized, so sanitizer builds catch overreads.
+    const char *position = buffer.data();
+    CHECK(Zeal::String::decode_codepoint(position) == static_cast<uint8_t>(text[0]));
+    CHECK(position == buffer.data() + 1);
+    CHECK(decoded(buffer.data()).size() == length);
+  }
+  const char *end = "";
+  CHECK(Zeal::String::decode_codepoint(end) == 0 && *end == '\0');  // Stays on the null.
+  CHECK(Zeal::String::decode_codepoint(end) == 0 && *end == '\0');
+  const char *after_sequence = "\xC3\xA9";
+  CHECK(Zeal::String::decode_codepoint(after_sequence) == 0xe9 && *after_sequence == '\0');
+}
+
+// Bytes 0x80 - 0x9f are the Windows-1252 punctuation (five are undefined and map to themselves).
+void test_decode_windows_1252() {
+  static constexpr uint32_t kExpected[32] = {
+      0x20ac, 0x81,   0x201a, 0x192,  0x201e, 0x2026, 0x2020, 0x2021, 0x2c6,  0x2030, 0x160,
+      0x2039, 0x152,  0x8d,   0x17d,  0x8f,   0x90,   0x2018, 0x2019, 0x201c, 0x201d, 0x2022,
+      0x2013, 0x2014, 0x2dc,  0x2122, 0x161,  0x203a, 0x153,  0x9d,   0x17e,  0x178};
+  for (int byte = 0x80; byte <= 0xff; ++byte) {
+    const char text[2] = {static_cast<char>(byte), 0};
+    const char *position = text;
+    const uint32_t codepoint = Zeal::String::decode_codepoint(position);
+    const uint32_t expected = (byte < 0xa0) ? kExpected[byte - 0x80] : byte;  // Latin-1 from 0xa0.
+    CHECK_MSG(codepoint == expected && position == text + 1, "0x%02x: U+%04X", byte, codepoint);
+  }
+  CHECK(decoded("\x93quoted\x94 \x96 \x80" "5") == (Codepoints{0x201c, 'q', 'u', 'o', 't', 'e', 'd', 0x201d, ' ',
+                                                               0x2013, ' ', 0x20ac, '5'}));
+}
+
+
+// Random text over a small alphabet with runs of mixed whitespace and delimiter characters.
+std::string random_split_text(std::mt19937 &rng) {
+  static constexpr char kAlphabet[] = "ab| \t\n\r";
+  std::string text(rng() % 13, ' ');
+  for (char &c : text) c = kAlphabet[rng() % (sizeof(kAlphabet) - 1)];
+  return text;
+}
+
+void test_trim() {
+  CHECK(Zeal::String::trim("") == "");
+  CHECK(Zeal::String::trim(" \t\r\n ") == "");
+  CHECK(Zeal::String::trim("word") == "word");
+  CHECK(Zeal::String::trim("  two words \t") == "two words");
+  CHECK(Zeal::String::trim("\nx\n") == "x");
+  const std::string_view input = "  inner  ";
+  CHECK(Zeal::String::trim(input).data() == input.data() + 2);  // A view into the input.
+}
+
+// The view split with a " " delim must give the tokens of the string split (which reduces whitespace runs).
+void test_split_matches_string_split() {
+  std::mt19937 rng(38);
+  std::vector<std::string_view> tokens;
+  for (int i = 0; i < 20000; ++i) {
+    const std::string input = random_split_text(rng);
+    const std::vector<std::string> expected = Zeal::String::split(input, " ");
+    Zeal::String::split(input, " ", tokens);
+    CHECK_MSG(std::vector<std::string>(tokens.begin(), tokens.end()) == expected, "\"%s\": %zu vs %zu tokens",
+              input.c_str(), tokens.size(), expected.size());
+  }
+  Zeal::String::split("  /cmd   arg1\targ2 ", " ", tokens);
+  CHECK((tokens == std::vector<std::string_view>{"/cmd", "arg1", "arg2"}));
+  Zeal::String::split("a|b||c", "|", tokens);  // Other delimiters keep empty tokens.
+  CHECK((tokens == std::vector<std::string_view>{"a", "b", "", "c"}));
+}
+
+void test_split_text_matches_string_split_text() {
+  std::mt19937 rng(39);
+  std::vector<std::string_view> tokens;
+  for (const char *delimiter : {" | ", "|", " ", "\n"}) {
+    for (int i = 0; i < 5000; ++i) {
+      const std::string input = random_split_text(rng);
+      const std::vector<std::string> expected = Zeal::String::split_text(input, delimiter);
+      Zeal::String::split_text(input, delimiter, tokens);
+      CHECK_MSG(std::vector<std::string>(tokens.begin(), tokens.end()) == expected, "\"%s\" on \"%s\"",
+                input.c_str(), delimiter);
+    }
+  }
+  Zeal::String::split_text("no delimiter", "", tokens);
+  CHECK((tokens == std::vector<std::string_view>{"no delimiter"}));
+}
+
+// tryParse accepts what std::stoi / std::stof accept (leading whitespace, a '+' or '-' sign and the
+// longest valid prefix) and fails where they throw.
+void test_try_parse_matches_stoi() {
+  static constexpr const char *kInputs[] = {"42",    "  42",  "\t-8",       "+7",         " +7",         "+",
+                                             "-",     "+-3",   "-+3",        "abc",        "",            "  ",
+                                             "007",   "-0",    "2147483647", "2147483648", "-2147483648", "12abc",
+                                             "12 34", "3.5x",  "1e3",        ".5",         "-.25e1",      "+ 1",
+                                             "1,5"};
+  for (const char *input : kInputs) {
+    int expected_int = 0;
+    bool int_valid = true;
+    try {
+      expected_int = std::stoi(input);
+    } catch (const std::exception &) {
+      int_valid = false;
+    }
+    int value = -1;
+    const bool parsed_int = Zeal::String::tryParse(input, &value, true);
+    CHECK_MSG(parsed_int == int_valid && (!int_valid || value == expected_int), "int \"%s\": %d %d vs %d %d", input,
+              parsed_int, value, int_valid, expected_int);
+
+    float expected_float = 0;
+    bool float_valid = true;
+    try {
+      expected_float = std::stof(input);
+    } catch (const std::exception &) {
+      float_valid = false;
+    }
+    float float_value = -1;
+    const bool parsed_float = Zeal::String::tryParse(input, &float_value, true);
+    CHECK_MSG(parsed_float == float_valid && (!float_valid || float_value == expected_float),
+              "float \"%s\": %d %g vs %d %g", input, parsed_float, float_value, float_valid, expected_float);
+  }
+
+  // Unlike std::stof, hexadecimal floats are not accepted ("0x10" is the number 0 followed by text).
+  float hex_value = -1;
+  CHECK(Zeal::String::tryParse("0x10", &hex_value, true) && hex_value == 0);
+  int hex_int = -1;
+  CHECK(Zeal::String::tryParse("0x10", &hex_int, true) && hex_int == 0);
+
+  // Failures print the reason unless quiet.
+  Zeal::Game::get_test_chat_lines().clear();
+  int value = 0;
+  CHECK(!Zeal::String::tryParse("nope", &value));
+  CHECK(!Zeal::String::tryParse("99999999999", &value));
+  CHECK(!Zeal::String::tryParse("nope", &value, true));
+  CHECK(Zeal::Game::get_test_chat_lines().size() == 2);
+}
+
+}  // namespace
+
+int main() {
+  test_replace_overlapping();
+  test_replace_empty();
+  test_replace_mixed_case();
+  test_replace_matches_regex();
+  test_decode_valid_utf8();
+  test_decode_malformed_utf8();
+  test_decode_truncated();
+  test_decode_windows_1252();
+  test_trim();
+  test_split_matches_string_split();
+  test_split_text_matches_string_split_text();
+  test_try_parse_matches_stoi();
+  return test_result();
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <atomic>
+#include <cstdio>
+
+// Minimal checks for the portable tests. A failed check prints its location and expression and
+// the test keeps going so one run reports every mismatch. main() returns test_result(). Checks may
+// be made from several threads.
+inline std::atomic<int> &test_failures() {
+  static std::atomic<int> failures = 0;
+  return failures;
+}
+
+#define CHECK(condition)                                                        \
+  do {                                                                          \
+    if (!(condition)) {                                                         \
+      std::printf("%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+      ++test_failures();                                                        \
+    }                                                                           \
+  } while (0)
+
+// Like CHECK but with a printf style description of the failing case.
+#define CHECK_MSG(condition, ...)                                               \
+  do {                                                                          \
+    if (!(condition)) {                                                         \
+      std::printf("%s:%d: CHECK failed: %s: ", __FILE__, __LINE__, #condition); \
+      std::printf(__VA_ARGS__);                                                 \
+      std::printf("\n");                                                        \
+      ++test_failures();                                                        \
+    }                                                                           \
+  } while (0)
+
+inline int test_result() {
+  if (test_failures()) std::printf("%d check(s) failed\n", test_failures().load());
+  return test_failures() ? 1 : 0;
+}
@@ -0,0 +1,41 @@
+#include "trigger_list.h"
+
+#include "string_util.h"
+
+bool TriggerList::add(const std::string &line) {
+  auto fields = Zeal::String::split_text(line, "^");
+  if (fields.size() != 5) return false;
+
+  Action action = Action::Clear;
+  if (fields[0] == "Add")
+    action = Action::Add;
+  else if (fields[0] != "Clear")
+    return false;
+
+  int duration_sec = 0;
+  if (!Zeal::String::tryParse(fields[3], &duration_sec)) return false;
+  if (duration_sec < 0 || duration_sec > 10 * 3600) return false;  // Failed duration sanity check of up to 10 hours.
+
+  uint32_t color = 0;
+  try {
+    color = std::stoul(fields[4], nullptr, 0);  // Hex conversion
+  } catch (const std::exception &e) {
+    return false;
+  }
+
+  Trigger trigger = {.action = action,
+                     .label = fields[1],
+                     .pattern_str = fields[2],
+                     .pattern = std::regex(fields[2]),
+                     .duration_sec = static_cast<uint32_t>(duration_sec),
+                     .color = color};
+  triggers.push_back(trigger);
+  return true;
+}
+
+const TriggerList::Trigger *TriggerList::find(const char *data) const {
+  for (const auto &trigger : triggers) {
+    if (std::regex_match(data, trigger.pattern)) return &trigger;
+  }
+  return nullptr;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+#include <regex>
+#include <string>
+#include <vector>
+
+// The parsed trigger file of the Triggers overlay. Matching only needs the chat text, so the chat
+// replay tests and benchmark (Zeal/tests) use this list directly.
+class TriggerList {
+ public:
+  enum class Action { Clear = 0, Add = 1 };
+
+  struct Trigger {
+    Action action;            // Action to perform when there is a match.
+    std::string label;        // Screen label for a visible trigger.
+    std::string pattern_str;  // Original string used to generate regex pattern.
+    std::regex pattern;       // Pattern to match to activate trigger.
+    uint32_t duration_sec;    // Countdown duration in seconds.
+    uint32_t color;           // ARGB color of text.
+  };
+
+  // Parses a trigger file line ("Add^label^pattern^duration_sec^color") and appends the trigger.
+  // Returns false (adding nothing) if the line is malformed.
+  bool add(const std::string &line);
+
+  // Returns the first trigger whose pattern matches the whole text (or nullptr).
+  const Trigger *find(const char *data) const;
+
+  void clear() { triggers.clear(); }
+  size_t size() const { return triggers.size(); }
+  bool empty() const { return triggers.empty(); }
+  const Trigger &operator[](size_t index) const { return triggers[index]; }
+
+ private:
+  std::vector<Trigger> triggers;
+};
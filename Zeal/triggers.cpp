@@ -71,7 +71,7 @@ bool Triggers::LoadTriggers(const std::string &load_filename, bool verbose) {
   int error_count = 0;
   while (std::getline(input_file, line)) {
     if (line.empty()) continue;  // Ignore blank lines.
-    if (!AddTrigger(line)) {
+    if (!triggers.add(line)) {
       if (verbose) Zeal::Game::print_chat("Zeal Triggers error parsing line: %s", line.c_str());
       return false;  // Bail out.
     }
@@ -80,37 +80,6 @@ bool Triggers::LoadTriggers(const std::string &load_filename, bool verbose) {
   return true;
 }
 
-bool Triggers::AddTrigger(const std::string &line) {
-  auto fields = Zeal::String::split_text(line, "^");
-  if (fields.size() != 5) return false;
-
-  Action action = Action::Clear;
-  if (fields[0] == "Add")
-    action = Action::Add;
-  else if (fields[0] != "Clear")
-    return false;
-
-  int duration_sec = 0;
-  if (!Zeal::String::tryParse(fields[3], &duration_sec)) return false;
-  if (duration_sec < 0 || duration_sec > 10 * 3600) return false;  // Failed duration sanity check of up to 10 hours.
-
-  DWORD color = 0;
-  try {
-    color = std::stoul(fields[4], nullptr, 0);  // Hex conversion
-  } catch (const std::exception &e) {
-    return false;
-  }
-
-  Trigger trigger = {.action = action,
-                     .label = fields[1],
-                     .pattern_str = fields[2],
-                     .pattern = std::regex(fields[2]),
-                     .duration_sec = static_cast<DWORD>(duration_sec),
-                     .color = color};
-  triggers.push_back(trigger);
-  return true;
-}
-
 std::string Triggers::GetTriggerDescription(const Trigger &trigger) const {
   switch (trigger.action) {
     case Action::Clear:
@@ -200,12 +169,8 @@ void Triggers::ParseArgs(const std::vector<std::string> &args) {
 void Triggers::HandlePrintChat(const char *data, int color_index) {
   if (!enabled.get()) return;
 
-  for (const auto &trigger : triggers) {
-    if (std::regex_match(data, trigger.pattern)) {
-      ActivateTrigger(trigger);
-      return;  // Only activates the first trigger.
-    }
-  }
+  const Trigger *trigger = triggers.find(data);
+  if (trigger) ActivateTrigger(*trigger);  // Only activates the first trigger.
 }
 
 void Triggers::ActivateTrigger(const Trigger &trigger) {
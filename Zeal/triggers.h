@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "bitmap_font.h"
+#include "trigger_list.h"
 #include "zeal_settings.h"
 
 class Triggers {
@@ -27,17 +28,15 @@ class Triggers {
   ZealSetting<std::string> bitmap_font_filename = {std::string(kUseDefaultFont), "Triggers", "Font", true,
                                                    [this](std::string val) { bitmap_font.reset(); }};
 
+  // Returns true if the chat text matches a loaded trigger (without activating it).
+  bool IsMatch(const char *data) const { return triggers.find(data) != nullptr; }
+
+  // The loaded triggers (copied by the chat replay benchmark).
+  const TriggerList &GetTriggers() const { return triggers; }
+
  private:
-  enum class Action { Clear = 0, Add = 1 };
-
-  struct Trigger {
-    Action action;            // Action to perform when there is a match.
-    std::string label;        // Screen label for a visible trigger.
-    std::string pattern_str;  // Original string used to generate regex pattern.
-    std::regex pattern;       // Pattern to match to activate trigger.
-    DWORD duration_sec;       // Countdown duration in seconds.
-    D3DCOLOR color;           // Color of text.
-  };
+  using Action = TriggerList::Action;
+  using Trigger = TriggerList::Trigger;
 
   struct TriggerEvent {
     std::string label;       // Copied from Trigger.
@@ -49,7 +48,6 @@ class Triggers {
   void SynchronizeEnable(bool verbose = false);  // Loads triggers from file if enabled.
   bool LoadTriggers(const std::string &triggers_filename, bool verbose);
   void ParseArgs(const std::vector<std::string> &args);
-  bool AddTrigger(const std::string &line);
   void LoadBitmapFont();  // Loads the bitmap font for rendering.
   std::string GetTriggerDescription(const Trigger &trigger) const;
 
@@ -58,6 +56,6 @@ class Triggers {
   void CallbackRender();                                    // Displays visible trigger list.
 
   std::unique_ptr<BitmapFont> bitmap_font = nullptr;
-  std::vector<Trigger> triggers;
+  TriggerList triggers;
   std::vector<TriggerEvent> trigger_events;
 };
@@ -2,6 +2,7 @@
 #define _USE_MATH_DEFINES
 #include <math.h>
 
+#include <cfloat>
 #include <iomanip>
 #include <sstream>
 
@@ -33,6 +33,7 @@
 #include "hook_wrapper.h"
 #include "io_ini.h"
 #include "item_display.h"
+#include "item_search.h"
 #include "labels.h"
 #include "looting.h"
 #include "melody.h"
@@ -141,6 +142,7 @@ ZealService::ZealService() {
   tick = MakeCheckedUnique(Tick);
   buff_timers = MakeCheckedUnique(BuffTimers);
   helm = MakeCheckedUnique(HelmManager);
+  item_search = MakeCheckedUnique(ItemSearch);
 
   // Adds DirectX (and UISkin for resource file paths) dependencies.
   target_ring = MakeCheckedUnique(TargetRing);
@@ -487,6 +489,15 @@ void ZealService::AddCommands() {
                              sizeof(Zeal::GameStructures::GAMECHARINFO));
       return true;
     }
+    if ((args.size() == 3 || args.size() == 4) && args[1] == "chatbench") {
+      int max_lines = 20000;
+      if (args.size() == 4 && (!Zeal::String::tryParse(args[3], &max_lines) || max_lines < 1 || max_lines > 1000000)) {
+        Zeal::Game::print_chat("Usage: /zeal chatbench <log_filename> [max_lines (1 to 1000000)]");
+        return true;
+      }
+      chat_hook->run_chat_benchmark(args[2], max_lines);
+      return true;
+    }
     if (args.size() == 2 && args[1] == "entities") {
       ZealService::get_instance()->entity_manager.get()->Dump();
       return true;
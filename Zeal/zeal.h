@@ -64,6 +64,7 @@ class ZealService {
   std::unique_ptr<class Tick> tick = nullptr;
   std::unique_ptr<class BuffTimers> buff_timers = nullptr;
   std::unique_ptr<class HelmManager> helm = nullptr;
+  std::unique_ptr<class ItemSearch> item_search = nullptr;
 
   std::unique_ptr<class RaidBars> raid_bars = nullptr;
   std::unique_ptr<class Triggers> triggers = nullptr;